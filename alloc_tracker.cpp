@@ -0,0 +1,131 @@
+#include "alloc_tracker.hpp"
+
+#ifdef DINO_TRACK_ALLOCATIONS
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+
+namespace {
+    constexpr int SubsystemCount = static_cast<int>(AllocSubsystem::Count);
+
+    struct Counter {
+        std::atomic<std::uint64_t> allocations{0};
+        std::atomic<std::uint64_t> bytes{0};
+    };
+
+    // The tick in progress, from every thread
+    std::array<Counter, SubsystemCount> g_tick;
+
+    // Closed ticks; only touched by endTick() and the getters on the game thread
+    std::array<AllocCounts, SubsystemCount> g_total;
+    std::array<AllocCounts, SubsystemCount> g_worst;
+    std::uint64_t g_ticks = 0;
+    std::uint64_t g_ticksWithAllocations = 0;
+
+    thread_local AllocSubsystem t_subsystem = AllocSubsystem::Other;
+    thread_local int t_forbidden = 0;
+
+    void count(std::size_t size) {
+        if (t_forbidden > 0) {
+            // No iostreams here: they could allocate again
+            std::fputs("Allocation during a no-allocation tick, in ", stderr);
+            std::fputs(AllocTracker::subsystemName(t_subsystem), stderr);
+            std::fputs("\n", stderr);
+            std::abort();
+        }
+        Counter& counter = g_tick[static_cast<int>(t_subsystem)];
+        counter.allocations.fetch_add(1, std::memory_order_relaxed);
+        counter.bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    void* allocate(std::size_t size) {
+        count(size);
+        if (void* memory = std::malloc(size ? size : 1)) return memory;
+        throw std::bad_alloc();
+    }
+
+    void* allocateAligned(std::size_t size, std::size_t alignment) {
+        count(size);
+        // aligned_alloc wants a multiple of the alignment
+        std::size_t rounded = (size + alignment - 1) / alignment * alignment;
+        if (void* memory = std::aligned_alloc(alignment, rounded ? rounded : alignment)) return memory;
+        throw std::bad_alloc();
+    }
+}
+
+AllocTracker::Scope::Scope(AllocSubsystem subsystem) : m_previous(t_subsystem) { t_subsystem = subsystem; }
+AllocTracker::Scope::~Scope() { t_subsystem = m_previous; }
+
+AllocTracker::Forbid::Forbid(bool active) : m_active(active) {
+    if (m_active) ++t_forbidden;
+}
+AllocTracker::Forbid::~Forbid() {
+    if (m_active) --t_forbidden;
+}
+
+void AllocTracker::endTick() {
+    bool allocated = false;
+    for (int i = 0; i < SubsystemCount; ++i) {
+        AllocCounts tick;
+        tick.allocations = g_tick[i].allocations.exchange(0, std::memory_order_relaxed);
+        tick.bytes = g_tick[i].bytes.exchange(0, std::memory_order_relaxed);
+        g_total[i].allocations += tick.allocations;
+        g_total[i].bytes += tick.bytes;
+        if (tick.allocations > g_worst[i].allocations) g_worst[i] = tick;
+        allocated |= tick.allocations > 0;
+    }
+    ++g_ticks;
+    if (allocated) ++g_ticksWithAllocations;
+}
+
+AllocCounts AllocTracker::getTotal(AllocSubsystem subsystem) { return g_total[static_cast<int>(subsystem)]; }
+AllocCounts AllocTracker::getWorstTick(AllocSubsystem subsystem) { return g_worst[static_cast<int>(subsystem)]; }
+std::uint64_t AllocTracker::getTicks() { return g_ticks; }
+std::uint64_t AllocTracker::getTicksWithAllocations() { return g_ticksWithAllocations; }
+
+void AllocTracker::printReport(std::ostream& out) {
+    out << "Allocations: " << g_ticksWithAllocations << " of " << g_ticks << " ticks allocated\n";
+    out << "  subsystem      allocs        bytes  worst_tick_allocs  worst_tick_bytes\n";
+    for (int i = 0; i < SubsystemCount; ++i) {
+        out << "  " << std::left << std::setw(11) << subsystemName(static_cast<AllocSubsystem>(i)) << std::right
+            << std::setw(10) << g_total[i].allocations
+            << std::setw(13) << g_total[i].bytes
+            << std::setw(19) << g_worst[i].allocations
+            << std::setw(18) << g_worst[i].bytes << "\n";
+    }
+    out.flush();
+}
+
+// --- Global replacements ---
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocateAligned(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocateAligned(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef ALLOC_TRACKER_HPP
+#define ALLOC_TRACKER_HPP
+
+#include <cstdint>
+#include <ostream>
+
+// Who a heap allocation was made for. The game thread tags each part of a
+// tick with an AllocTracker::Scope; threads that never tag count as Other.
+enum class AllocSubsystem : std::uint8_t {
+    Other,
+    Simulation,     // World::step
+    Bots,
+    Audio,
+    Telemetry,
+    Killcam,
+    Spectator,
+    Render,
+    Count
+};
+
+struct AllocCounts {
+    std::uint64_t allocations = 0;
+    std::uint64_t bytes = 0;
+};
+
+// Heap allocation counts per subsystem and per tick, for ruling out
+// allocator stalls as a source of frame stutter. Building with
+// -DDINO_TRACK_ALLOCATIONS and alloc_tracker.cpp replaces the global
+// operator new and delete to do the counting; without the flag every call
+// here compiles to nothing, Enabled is false and the .cpp isn't needed.
+//
+// A Forbid on the game thread turns any allocation it makes into an abort
+// that names the subsystem, for the "no allocations during Gameplay" check
+// (runner --alloc-strict).
+class AllocTracker {
+public:
+#ifdef DINO_TRACK_ALLOCATIONS
+    static constexpr bool Enabled = true;
+
+    // Tags this thread's allocations until destroyed
+    class Scope {
+    public:
+        explicit Scope(AllocSubsystem subsystem);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        AllocSubsystem m_previous;
+    };
+
+    // While active, an allocation on this thread aborts the program
+    class Forbid {
+    public:
+        explicit Forbid(bool active = true);
+        ~Forbid();
+        Forbid(const Forbid&) = delete;
+        Forbid& operator=(const Forbid&) = delete;
+
+    private:
+        bool m_active;
+    };
+
+    // Closes the current tick: its counts go into the totals and the worst
+    // tick per subsystem. Game thread, once per tick.
+    static void endTick();
+
+    static AllocCounts getTotal(AllocSubsystem subsystem);
+    static AllocCounts getWorstTick(AllocSubsystem subsystem);
+    static std::uint64_t getTicks();
+    static std::uint64_t getTicksWithAllocations();
+    static void printReport(std::ostream& out);
+#else
+    static constexpr bool Enabled = false;
+
+    class Scope {
+    public:
+        explicit Scope(AllocSubsystem) {}
+    };
+
+    class Forbid {
+    public:
+        explicit Forbid(bool = true) {}
+    };
+
+    static void endTick() {}
+    static AllocCounts getTotal(AllocSubsystem) { return {}; }
+    static AllocCounts getWorstTick(AllocSubsystem) { return {}; }
+    static std::uint64_t getTicks() { return 0; }
+    static std::uint64_t getTicksWithAllocations() { return 0; }
+    static void printReport(std::ostream&) {}
+#endif
+
+    static const char* subsystemName(AllocSubsystem subsystem) {
+        static const char* names[] = {"other", "simulation", "bots", "audio", "telemetry", "killcam", "spectator",
+                                      "render"};
+        int index = static_cast<int>(subsystem);
+        return index < static_cast<int>(AllocSubsystem::Count) ? names[index] : "?";
+    }
+};
+
+#endif
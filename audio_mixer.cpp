@@ -0,0 +1,310 @@
+#include "audio_mixer.hpp"
+#include <SFML/Audio.hpp>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <random>
+
+namespace {
+
+constexpr float Pi = 3.14159265f;
+
+// Samples a function of time (in seconds) into mono PCM
+template <typename Wave>
+std::vector<std::int16_t> synthesize(float seconds, Wave wave) {
+    std::vector<std::int16_t> samples(static_cast<std::size_t>(seconds * AudioMixer::SampleRate));
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        float value = wave(static_cast<float>(i) / AudioMixer::SampleRate, seconds);
+        samples[i] = static_cast<std::int16_t>(std::clamp(value, -1.f, 1.f) * 32767.f);
+    }
+    return samples;
+}
+
+// White noise through a one-pole low-pass filter whose cutoff follows a
+// function of time; the basis of the whooshes
+struct FilteredNoise {
+    std::minstd_rand rng;
+    float state = 0.f;
+
+    explicit FilteredNoise(unsigned int seed) : rng(seed) {}
+
+    float next(float cutoff) {
+        float noise = std::uniform_real_distribution<float>(-1.f, 1.f)(rng);
+        float k = 1.f - std::exp(-2.f * Pi * cutoff / AudioMixer::SampleRate);
+        state += k * (noise - state);
+        return state;
+    }
+};
+
+// Square wave with a changing frequency; phase is carried between calls
+struct Square {
+    float phase = 0.f;
+
+    float next(float frequency) {
+        phase += frequency / AudioMixer::SampleRate;
+        phase -= std::floor(phase);
+        return phase < 0.5f ? 1.f : -1.f;
+    }
+};
+
+} // namespace
+
+SampleBank::SampleBank() {
+    FilteredNoise throwNoise(1);
+    m_samples[static_cast<int>(SoundId::Throw)] = synthesize(0.22f, [&](float t, float length) {
+        float x = t / length;
+        float cutoff = 800.f + 2600.f * std::sin(Pi * x);
+        float envelope = std::sin(Pi * x);
+        return 1.4f * throwNoise.next(cutoff) * envelope * envelope;
+    });
+
+    FilteredNoise click(2);
+    m_samples[static_cast<int>(SoundId::Bounce)] = synthesize(0.08f, [&](float t, float) {
+        float tone = std::sin(2.f * Pi * 520.f * t) * std::exp(-t * 60.f);
+        float knock = t < 0.002f ? click.next(6000.f) : 0.f;
+        return 0.6f * tone + 0.8f * knock;
+    });
+
+    m_samples[static_cast<int>(SoundId::Catch)] = synthesize(0.14f, [](float t, float length) {
+        float half = length / 2.f;
+        float frequency = t < half ? 880.f : 1320.f;
+        float local = t < half ? t : t - half;
+        return 0.4f * std::sin(2.f * Pi * frequency * t) * std::exp(-local * 25.f);
+    });
+
+    FilteredNoise dashNoise(3);
+    m_samples[static_cast<int>(SoundId::Dash)] = synthesize(0.15f, [&](float t, float length) {
+        float x = t / length;
+        float cutoff = 4000.f * (1.f - x) + 500.f * x;
+        float envelope = (1.f - x) * (1.f - x);
+        return 1.2f * dashNoise.next(cutoff) * envelope;
+    });
+
+    Square deathTone;
+    m_samples[static_cast<int>(SoundId::Death)] = synthesize(0.5f, [&](float t, float length) {
+        float x = t / length;
+        float frequency = 420.f * std::pow(70.f / 420.f, x);
+        return 0.3f * deathTone.next(frequency) * (1.f - x);
+    });
+
+    Square joinTone;
+    m_samples[static_cast<int>(SoundId::Join)] = synthesize(0.27f, [&](float t, float) {
+        static const float notes[3] = {523.25f, 659.25f, 783.99f};
+        int note = std::min(2, static_cast<int>(t / 0.09f));
+        float local = t - note * 0.09f;
+        return 0.25f * joinTone.next(notes[note]) * std::exp(-local * 20.f);
+    });
+}
+
+int SampleBank::loadDirectory(const std::string& directory) {
+    int loaded = 0;
+    for (int i = 0; i < static_cast<int>(SoundId::Count); ++i) {
+        for (const char* extension : {".wav", ".ogg"}) {
+            std::filesystem::path path = std::filesystem::path(directory) / (std::string(name(static_cast<SoundId>(i))) + extension);
+            sf::SoundBuffer buffer;
+            if (!std::filesystem::exists(path) || !buffer.loadFromFile(path)) continue;
+
+            // Down to mono, then to the mixer's rate with linear interpolation
+            unsigned int channels = std::max(1u, buffer.getChannelCount());
+            std::size_t frames = buffer.getSampleCount() / channels;
+            std::vector<float> mono(frames);
+            for (std::size_t f = 0; f < frames; ++f) {
+                float sum = 0.f;
+                for (unsigned int c = 0; c < channels; ++c) sum += buffer.getSamples()[f * channels + c];
+                mono[f] = sum / channels;
+            }
+            double step = static_cast<double>(buffer.getSampleRate()) / AudioMixer::SampleRate;
+            std::vector<std::int16_t>& samples = m_samples[i];
+            samples.assign(frames == 0 ? 0 : static_cast<std::size_t>((frames - 1) / step) + 1, 0);
+            for (std::size_t s = 0; s < samples.size(); ++s) {
+                double source = s * step;
+                std::size_t index = static_cast<std::size_t>(source);
+                float fraction = static_cast<float>(source - index);
+                float next = index + 1 < frames ? mono[index + 1] : mono[index];
+                samples[s] = static_cast<std::int16_t>(mono[index] + (next - mono[index]) * fraction);
+            }
+            ++loaded;
+            break;
+        }
+    }
+    return loaded;
+}
+
+const std::vector<std::int16_t>& SampleBank::get(SoundId id) const { return m_samples[static_cast<int>(id)]; }
+
+const char* SampleBank::name(SoundId id) {
+    switch (id) {
+        case SoundId::Throw: return "throw";
+        case SoundId::Bounce: return "bounce";
+        case SoundId::Catch: return "catch";
+        case SoundId::Dash: return "dash";
+        case SoundId::Death: return "death";
+        case SoundId::Join: return "join";
+        default: return "";
+    }
+}
+
+AudioMixer::AudioMixer(const SampleBank& bank)
+    : m_bank(bank)
+    , m_gameTick(0)
+    , m_pendingCount(0)
+    , m_frame(0)
+    , m_anchored(false)
+    , m_anchorTick(0)
+    , m_anchorFrame(0)
+    , m_voiceCounter(0)
+    , m_volume(1.f)
+    , m_stolen(0)
+    , m_dropped(0)
+    , m_late(0)
+    , m_activeVoices(0)
+{
+}
+
+void AudioMixer::play(SoundId id, float pan, float volume) {
+    if (!m_commands.tryPush({id, std::clamp(pan, -1.f, 1.f), volume, m_gameTick})) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AudioMixer::endTick() { ++m_gameTick; }
+
+void AudioMixer::onEvents(const std::vector<GameEvent>& events, float width) {
+    for (const GameEvent& event : events) {
+        SoundId id;
+        switch (event.type) {
+            case GameEvent::Type::Throw: id = SoundId::Throw; break;
+            case GameEvent::Type::Bounce: id = SoundId::Bounce; break;
+            case GameEvent::Type::Catch: id = SoundId::Catch; break;
+            case GameEvent::Type::Kill: id = SoundId::Death; break;
+            case GameEvent::Type::Dash: id = SoundId::Dash; break;
+            default: continue;
+        }
+        play(id, event.position.x / width * 2.f - 1.f);
+    }
+}
+
+void AudioMixer::setVolume(float volume) { m_volume.store(volume, std::memory_order_relaxed); }
+
+int AudioMixer::priority(SoundId id) {
+    switch (id) {
+        case SoundId::Death: return 4;
+        case SoundId::Join: return 3;
+        case SoundId::Throw:
+        case SoundId::Catch: return 2;
+        case SoundId::Dash: return 1;
+        default: return 0;
+    }
+}
+
+void AudioMixer::start(const Command& command, std::size_t delay) {
+    const std::vector<std::int16_t>& samples = m_bank.get(command.id);
+    if (samples.empty()) return;
+    int newPriority = priority(command.id);
+
+    // A free voice, or else the least important one, oldest first
+    Voice* voice = nullptr;
+    for (Voice& candidate : m_voices) {
+        if (!candidate.samples) {
+            voice = &candidate;
+            break;
+        }
+        if (!voice || candidate.priority < voice->priority ||
+            (candidate.priority == voice->priority && candidate.started < voice->started)) {
+            voice = &candidate;
+        }
+    }
+    if (voice->samples) {
+        if (voice->priority > newPriority) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        m_stolen.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    float angle = (command.pan + 1.f) * Pi / 4.f;     // Constant power panning
+    voice->samples = samples.data();
+    voice->length = samples.size();
+    voice->position = 0;
+    voice->delay = delay;
+    voice->gainLeft = command.volume * std::cos(angle);
+    voice->gainRight = command.volume * std::sin(angle);
+    voice->priority = newPriority;
+    voice->started = m_voiceCounter++;
+}
+
+void AudioMixer::mix(std::int16_t* out, std::size_t frames) {
+    Command command;
+    while (m_pendingCount < m_pending.size() && m_commands.tryPop(command)) {
+        m_pending[m_pendingCount++] = command;
+    }
+
+    const std::int64_t latency = static_cast<std::int64_t>(LatencyTicks) * SamplesPerTick;
+    const std::int64_t maxAhead = static_cast<std::int64_t>(LatencyTicks + MaxAheadTicks) * SamplesPerTick;
+    const float volume = m_volume.load(std::memory_order_relaxed);
+
+    while (frames > 0) {
+        std::size_t count = std::min(frames, m_accumulator.size() / 2);
+        std::int64_t blockStart = static_cast<std::int64_t>(m_frame);
+        std::int64_t blockEnd = blockStart + static_cast<std::int64_t>(count);
+
+        // Start whatever is due in this block at its exact frame
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < m_pendingCount; ++i) {
+            const Command& pending = m_pending[i];
+            if (!m_anchored) {
+                m_anchored = true;
+                m_anchorTick = pending.tick;
+                m_anchorFrame = blockStart + latency;
+            }
+            std::int64_t due = m_anchorFrame +
+                               (static_cast<std::int64_t>(pending.tick) - static_cast<std::int64_t>(m_anchorTick)) *
+                               SamplesPerTick;
+            if (due < blockStart) {
+                // The game is behind the audio clock: play now and move the
+                // anchor so the sounds after this keep their spacing
+                m_late.fetch_add(1, std::memory_order_relaxed);
+                m_anchorFrame += blockStart - due;
+                due = blockStart;
+            } else if (due > blockStart + maxAhead) {
+                m_anchorFrame -= due - (blockStart + latency);
+                due = blockStart + latency;
+            }
+            if (due < blockEnd) {
+                start(pending, static_cast<std::size_t>(due - blockStart));
+            } else {
+                m_pending[kept++] = pending;
+            }
+        }
+        m_pendingCount = kept;
+
+        std::fill(m_accumulator.begin(), m_accumulator.begin() + 2 * count, 0.f);
+        for (Voice& voice : m_voices) {
+            if (!voice.samples) continue;
+            std::size_t frame = std::min(voice.delay, count);
+            voice.delay -= frame;
+            for (; frame < count && voice.position < voice.length; ++frame) {
+                float sample = voice.samples[voice.position++] * (1.f / 32768.f);
+                m_accumulator[2 * frame] += sample * voice.gainLeft;
+                m_accumulator[2 * frame + 1] += sample * voice.gainRight;
+            }
+            if (voice.position == voice.length) voice.samples = nullptr;
+        }
+
+        for (std::size_t i = 0; i < 2 * count; ++i) {
+            out[i] = static_cast<std::int16_t>(std::clamp(m_accumulator[i] * volume, -1.f, 1.f) * 32767.f);
+        }
+        out += 2 * count;
+        frames -= count;
+        m_frame += count;
+    }
+
+    int active = 0;
+    for (const Voice& voice : m_voices) active += voice.samples ? 1 : 0;
+    m_activeVoices.store(active, std::memory_order_relaxed);
+}
+
+std::uint64_t AudioMixer::getStolenCount() const { return m_stolen.load(std::memory_order_relaxed); }
+std::uint64_t AudioMixer::getDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+std::uint64_t AudioMixer::getLateCount() const { return m_late.load(std::memory_order_relaxed); }
+int AudioMixer::getActiveVoices() const { return m_activeVoices.load(std::memory_order_relaxed); }
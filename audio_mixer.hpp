@@ -0,0 +1,132 @@
+#ifndef AUDIO_MIXER_HPP
+#define AUDIO_MIXER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "event_bus.hpp"
+#include "spsc_queue.hpp"
+
+// The one-shot effects the game plays
+enum class SoundId : std::uint8_t {
+    Throw,
+    Bounce,
+    Catch,
+    Dash,
+    Death,
+    Join,
+    Count
+};
+
+// Every effect decoded to mono 16-bit PCM at AudioMixer::SampleRate before
+// the game starts. The built-in set is synthesized, so the game has sound
+// without any audio files; loadDirectory() replaces any of them with
+// <name>.wav or <name>.ogg from a folder.
+class SampleBank {
+public:
+    SampleBank();   // The synthesized set
+
+    // Returns how many effects were replaced
+    int loadDirectory(const std::string& directory);
+
+    const std::vector<std::int16_t>& get(SoundId id) const;
+    static const char* name(SoundId id);
+
+private:
+    std::array<std::vector<std::int16_t>, static_cast<int>(SoundId::Count)> m_samples;
+};
+
+// Mixes one-shot effects into a stereo stream on the audio thread.
+//
+// The game thread calls play() during a tick and endTick() after it; both
+// only push into a lock-free ring. The audio thread calls mix() for each
+// block the output wants. Sounds start a fixed delay after the tick that
+// played them, counted in samples, so effects keep the spacing of the 60 Hz
+// ticks however the game loop bunches them up. If the game falls behind the
+// audio clock, or gets too far ahead of it, the delay is re-anchored.
+//
+// There are MaxVoices voices and nothing is allocated after construction.
+// When all are busy a new sound takes the voice of the lowest priority
+// sound, the oldest first, or is dropped if every voice is more important.
+class AudioMixer {
+public:
+    static constexpr unsigned int SampleRate = 44100;
+    static constexpr int SamplesPerTick = SampleRate / 60;
+    static constexpr int MaxVoices = 16;
+    static constexpr int LatencyTicks = 1;          // Delay from a tick to its sounds
+    static constexpr int MaxAheadTicks = 4;         // Further ahead than this re-anchors
+
+    // The bank must outlive the mixer
+    explicit AudioMixer(const SampleBank& bank);
+
+    AudioMixer(const AudioMixer&) = delete;
+    AudioMixer& operator=(const AudioMixer&) = delete;
+
+    // Game thread. pan runs from -1 (left) to 1 (right).
+    void play(SoundId id, float pan = 0.f, float volume = 1.f);
+    void endTick();
+
+    // Game thread. Plays the effects for the events of one World::step();
+    // pan follows the x position across an arena width wide.
+    void onEvents(const std::vector<GameEvent>& events, float width);
+
+    // Audio thread. Fills frames stereo frames, interleaved left/right.
+    void mix(std::int16_t* out, std::size_t frames);
+
+    void setVolume(float volume);       // Any thread
+
+    std::uint64_t getStolenCount() const;       // Voices taken from a playing sound
+    std::uint64_t getDroppedCount() const;      // Sounds never played
+    std::uint64_t getLateCount() const;         // Arrived after their start time
+    int getActiveVoices() const;
+
+private:
+    struct Command {
+        SoundId id;
+        float pan;
+        float volume;
+        std::uint64_t tick;
+    };
+
+    struct Voice {
+        const std::int16_t* samples = nullptr;  // nullptr when free
+        std::size_t length = 0;
+        std::size_t position = 0;
+        std::size_t delay = 0;                  // Frames of silence before it starts
+        float gainLeft = 0.f;
+        float gainRight = 0.f;
+        int priority = 0;
+        std::uint64_t started = 0;              // For picking the oldest
+    };
+
+    void start(const Command& command, std::size_t delay);
+
+    static int priority(SoundId id);
+
+    const SampleBank& m_bank;
+
+    // Game thread
+    std::uint64_t m_gameTick;
+    SpscQueue<Command, 256> m_commands;
+
+    // Audio thread
+    std::array<Voice, MaxVoices> m_voices;
+    std::array<Command, 64> m_pending;          // Popped but not due yet
+    std::size_t m_pendingCount;
+    std::array<float, 2 * 1024> m_accumulator;
+    std::uint64_t m_frame;                      // Frames mixed so far
+    bool m_anchored;
+    std::uint64_t m_anchorTick;
+    std::int64_t m_anchorFrame;                 // Where m_anchorTick's sounds start
+    std::uint64_t m_voiceCounter;
+
+    std::atomic<float> m_volume;
+    std::atomic<std::uint64_t> m_stolen;
+    std::atomic<std::uint64_t> m_dropped;
+    std::atomic<std::uint64_t> m_late;
+    std::atomic<int> m_activeVoices;
+};
+
+#endif
@@ -0,0 +1,100 @@
+#include "audio_output.hpp"
+#include <SFML/Audio.hpp>
+#include <array>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+// Plays the mixer through SFML. The stream asks for each block on SFML's
+// streaming thread, which is the mixer thread for this output.
+class DeviceOutput : public AudioOutput {
+public:
+    explicit DeviceOutput(AudioMixer& mixer) : m_stream(mixer) {}
+    ~DeviceOutput() override { m_stream.stop(); }
+
+    void start() override { m_stream.play(); }
+    void stop() override { m_stream.stop(); }
+    const char* getName() const override { return "device"; }
+    std::uint64_t getFramesMixed() const override { return m_stream.frames.load(std::memory_order_relaxed); }
+
+private:
+    struct Stream : sf::SoundStream {
+        explicit Stream(AudioMixer& mixer)
+            : mixer(mixer)
+            , frames(0)
+        {
+            initialize(2, AudioMixer::SampleRate, {sf::SoundChannel::FrontLeft, sf::SoundChannel::FrontRight});
+        }
+
+        bool onGetData(Chunk& data) override {
+            mixer.mix(block.data(), BlockFrames);
+            frames.fetch_add(BlockFrames, std::memory_order_relaxed);
+            data.samples = block.data();
+            data.sampleCount = block.size();
+            return true;
+        }
+
+        void onSeek(sf::Time) override {}
+
+        AudioMixer& mixer;
+        std::array<std::int16_t, 2 * BlockFrames> block;
+        std::atomic<std::uint64_t> frames;
+    };
+
+    Stream m_stream;
+};
+
+// Mixes in real time on a thread of its own and discards the output, so
+// everything up to the sound card runs exactly as it would with one
+class NullOutput : public AudioOutput {
+public:
+    explicit NullOutput(AudioMixer& mixer)
+        : m_mixer(mixer)
+        , m_running(false)
+        , m_frames(0)
+    {
+    }
+
+    ~NullOutput() override { stop(); }
+
+    void start() override {
+        if (m_running.exchange(true)) return;
+        m_thread = std::thread(&NullOutput::run, this);
+    }
+
+    void stop() override {
+        m_running = false;
+        if (m_thread.joinable()) m_thread.join();
+    }
+
+    const char* getName() const override { return "null"; }
+    std::uint64_t getFramesMixed() const override { return m_frames.load(std::memory_order_relaxed); }
+
+private:
+    void run() {
+        using Clock = std::chrono::steady_clock;
+        const auto blockTime = std::chrono::duration<double>(static_cast<double>(BlockFrames) / AudioMixer::SampleRate);
+        auto next = Clock::now();
+        while (m_running.load(std::memory_order_relaxed)) {
+            m_mixer.mix(m_block.data(), BlockFrames);
+            m_frames.fetch_add(BlockFrames, std::memory_order_relaxed);
+            next += std::chrono::duration_cast<Clock::duration>(blockTime);
+            std::this_thread::sleep_until(next);
+        }
+    }
+
+    AudioMixer& m_mixer;
+    std::array<std::int16_t, 2 * BlockFrames> m_block;
+    std::atomic<bool> m_running;
+    std::atomic<std::uint64_t> m_frames;
+    std::thread m_thread;
+};
+
+} // namespace
+
+std::unique_ptr<AudioOutput> createAudioOutput(const std::string& name, AudioMixer& mixer) {
+    if (name == "device") return std::make_unique<DeviceOutput>(mixer);
+    if (name == "null") return std::make_unique<NullOutput>(mixer);
+    return nullptr;
+}
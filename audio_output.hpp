@@ -0,0 +1,31 @@
+#ifndef AUDIO_OUTPUT_HPP
+#define AUDIO_OUTPUT_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "audio_mixer.hpp"
+
+// Pulls blocks from an AudioMixer on its own thread and sends them somewhere.
+// The mixer must outlive the output.
+class AudioOutput {
+public:
+    static constexpr std::size_t BlockFrames = 512;     // About 12 ms
+
+    virtual ~AudioOutput() = default;
+
+    virtual void start() = 0;
+    virtual void stop() = 0;
+    virtual const char* getName() const = 0;
+
+    // Frames mixed so far
+    virtual std::uint64_t getFramesMixed() const = 0;
+};
+
+// "device" plays through the sound card with SFML; "null" mixes at the
+// same pace and throws the result away, for machines without audio and for
+// headless runs. Returns nullptr for an unknown name.
+std::unique_ptr<AudioOutput> createAudioOutput(const std::string& name, AudioMixer& mixer);
+
+#endif
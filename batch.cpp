@@ -0,0 +1,325 @@
+// Headless bot-vs-bot match runner for balance sweeps.
+//
+// Plays thousands of matches across every core and writes aggregated win
+// rates, match lengths and kill causes to a summary file. Each match gets its
+// own seed and arena; physics tunables can be overridden globally or per
+// variant so a tweak can be compared against the baseline in a single run:
+//
+//   ./dino_batch --matches 5000 --variant baseline --variant fast:dash-speed=30,throw-speed=35
+//
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "world.hpp"
+#include "bot.hpp"
+#include "level.hpp"
+#include "tuning.hpp"
+#include "tuning_params.hpp"
+#include "thread_pool.hpp"
+#include "telemetry.hpp"
+#include "match_seed.hpp"
+
+namespace {
+
+struct Variant {
+    std::string name;
+    Tuning tuning;
+};
+
+struct MatchSpec {
+    int index;
+    std::uint32_t seed;
+    int levelIndex;
+    int variantIndex;
+};
+
+struct MatchResult {
+    int ticks = 0;
+    int winnerId = -1;          // -1 = nobody survived or time ran out
+    bool timedOut = false;
+    int killsByCause[3] = {0, 0, 0};  // FlyingOut, Hanging, Returning
+};
+
+struct Options {
+    int matches = 1000;
+    unsigned int threads = 0;
+    int players = 4;
+    int maxTicks = 60 * 90;     // 90 seconds of game time
+    std::uint32_t seed = 1;
+    int level = -1;             // -1 = rotate through every built-in arena
+    std::string outPath = "batch_summary.txt";
+    std::string telemetryPath;  // Empty = don't record
+    Tuning tuning;
+    std::vector<std::string> variantArgs;
+};
+
+void printUsage() {
+    std::cout << "Usage: dino_batch [options]\n"
+              << "  --matches N        number of matches to play (default 1000)\n"
+              << "  --threads N        worker threads (default: all cores)\n"
+              << "  --players N        bots per match, 2-16 (default 4)\n"
+              << "  --max-ticks N      ticks before a match is called a draw (default 5400)\n"
+              << "  --seed N           base seed (default 1)\n"
+              << "  --level N          play only built-in arena N (default: rotate)\n"
+              << "  --out FILE         summary file (default batch_summary.txt)\n"
+              << "  --telemetry FILE   append every match to a telemetry file for dino_telemetry\n"
+              << "  --variant NAME[:key=value,...]\n"
+              << "                     add a tuning variant; matches are split evenly\n"
+              << "  --<tunable> VALUE  override a tunable for every variant:\n"
+              << "                    ";
+    for (const auto& param : TUNING_FLOAT_PARAMS) std::cout << " " << param.name;
+    for (const auto& param : TUNING_INT_PARAMS) std::cout << " " << param.name;
+    std::cout << std::endl;
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return false;
+        }
+        if (arg.rfind("--", 0) != 0 || i + 1 >= argc) {
+            std::cerr << "Error: Bad argument " << arg << std::endl;
+            printUsage();
+            return false;
+        }
+        std::string name = arg.substr(2);
+        std::string value = argv[++i];
+
+        try {
+            if (name == "matches") options.matches = std::stoi(value);
+            else if (name == "threads") options.threads = std::stoul(value);
+            else if (name == "players") options.players = std::clamp(std::stoi(value), 2, World::MaxPlayers);
+            else if (name == "max-ticks") options.maxTicks = std::stoi(value);
+            else if (name == "seed") options.seed = std::stoul(value);
+            else if (name == "level") options.level = std::stoi(value);
+            else if (name == "out") options.outPath = value;
+            else if (name == "telemetry") options.telemetryPath = value;
+            else if (name == "variant") options.variantArgs.push_back(value);
+            else if (!setTuningParam(options.tuning, name, value)) {
+                std::cerr << "Error: Unknown option " << arg << std::endl;
+                printUsage();
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Error: Bad value " << value << " for " << arg << std::endl;
+            printUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+// "name:key=value,key=value" on top of the base tuning
+bool parseVariant(const std::string& text, const Tuning& base, Variant& variant) {
+    std::size_t colon = text.find(':');
+    variant.name = text.substr(0, colon);
+    variant.tuning = base;
+    if (colon == std::string::npos) return true;
+
+    std::stringstream overrides(text.substr(colon + 1));
+    std::string item;
+    while (std::getline(overrides, item, ',')) {
+        std::size_t equals = item.find('=');
+        bool valid = equals != std::string::npos;
+        try {
+            valid = valid && setTuningParam(variant.tuning, item.substr(0, equals), item.substr(equals + 1));
+        } catch (const std::exception&) {
+            valid = false;
+        }
+        if (!valid) {
+            std::cerr << "Error: Bad variant override " << item << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+MatchResult runMatch(const MatchSpec& spec, const Variant& variant, int playerCount, int maxTicks,
+                     TelemetryWriter* telemetry) {
+    const Level& level = builtinLevels()[spec.levelIndex];
+    World world(level, variant.tuning);
+    MatchRecording recording;
+    if (telemetry) recording = MatchRecording(telemetry->getChunkPool(), spec.index, spec.seed, level.name, playerCount);
+
+    std::vector<Bot> bots;
+    for (int i = 0; i < playerCount; ++i) {
+        world.addPlayer(-1);
+        bots.emplace_back(mixSeed(spec.seed, i + 1));
+    }
+
+    std::vector<PlayerInput> inputs(playerCount);
+    while (world.getAliveCount() > 1 && world.getTick() < maxTicks) {
+        for (int i = 0; i < playerCount; ++i) {
+            inputs[i] = bots[i].think(world, i);
+        }
+        world.step(inputs);
+        if (telemetry) recording.recordTick(world);
+    }
+
+    MatchResult result;
+    result.ticks = world.getTick();
+    result.timedOut = world.getAliveCount() > 1;
+    if (world.getAliveCount() == 1) {
+        for (const auto& player : world.getPlayers()) {
+            if (player.isAlive()) result.winnerId = player.getId();
+        }
+    }
+    for (const auto& kill : world.getKills()) {
+        int cause = static_cast<int>(kill.cause);
+        if (cause >= 0 && cause < 3) ++result.killsByCause[cause];
+    }
+
+    if (telemetry) {
+        recording.finish(result.winnerId);
+        telemetry->submit(std::move(recording));
+    }
+    return result;
+}
+
+void writeSummary(std::ostream& out, const Options& options, const std::vector<Variant>& variants,
+                  const std::vector<MatchSpec>& specs, const std::vector<MatchResult>& results,
+                  double wallSeconds, unsigned int threadCount) {
+    out << std::fixed << std::setprecision(3);
+    out << "# Dino Fu batch summary\n";
+    out << "matches: " << results.size() << "\n";
+    out << "players: " << options.players << "\n";
+    out << "seed: " << options.seed << "\n";
+    out << "threads: " << threadCount << "\n";
+    out << "wall_seconds: " << wallSeconds << "\n";
+    out << "matches_per_second: " << (wallSeconds > 0 ? results.size() / wallSeconds : 0.0) << "\n";
+
+    const auto& levels = builtinLevels();
+    for (int v = 0; v < static_cast<int>(variants.size()); ++v) {
+        const Tuning& t = variants[v].tuning;
+        std::vector<int> lengths;
+        std::vector<int> wins(options.players, 0);
+        std::vector<double> levelTicks(levels.size(), 0.0);
+        std::vector<int> levelMatches(levels.size(), 0);
+        int draws = 0, timeouts = 0;
+        long long kills[3] = {0, 0, 0};
+
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            if (specs[i].variantIndex != v) continue;
+            const MatchResult& r = results[i];
+            lengths.push_back(r.ticks);
+            levelTicks[specs[i].levelIndex] += r.ticks;
+            ++levelMatches[specs[i].levelIndex];
+            if (r.winnerId >= 0) ++wins[r.winnerId];
+            else ++draws;
+            if (r.timedOut) ++timeouts;
+            for (int c = 0; c < 3; ++c) kills[c] += r.killsByCause[c];
+        }
+        if (lengths.empty()) continue;
+        std::sort(lengths.begin(), lengths.end());
+        double total = 0;
+        for (int ticks : lengths) total += ticks;
+        double count = lengths.size();
+
+        out << "\n[variant " << variants[v].name << "]\n";
+        out << "tuning: move-speed=" << t.moveSpeed << " jump-velocity=" << t.jumpVelocity
+            << " gravity=" << t.gravity << " max-fall-speed=" << t.maxFallSpeed
+            << " dash-speed=" << t.dashSpeed << " dash-duration=" << t.dashDurationTicks
+            << " dash-cooldown=" << t.dashCooldownTicks << " throw-speed=" << t.throwSpeed
+            << " damping=" << t.damping << " bounce-loss=" << t.bounceLoss
+            << " hang-speed=" << t.hangSpeed << " hang-ticks=" << t.hangTicks
+            << " return-speed=" << t.returnSpeed << " catch-distance=" << t.catchDistance
+            << " boomerang-size=" << t.boomerangSize << " physics-substeps=" << t.physicsSubsteps << "\n";
+        out << "matches: " << lengths.size() << "\n";
+        for (int p = 0; p < options.players; ++p) {
+            out << "win_rate_slot_" << p << ": " << wins[p] / count << "\n";
+        }
+        out << "draw_rate: " << draws / count << "\n";
+        out << "timeout_rate: " << timeouts / count << "\n";
+        out << "length_mean_seconds: " << total / count / 60.0 << "\n";
+        out << "length_median_seconds: " << lengths[lengths.size() / 2] / 60.0 << "\n";
+        out << "length_p90_seconds: " << lengths[lengths.size() * 9 / 10] / 60.0 << "\n";
+        long long killTotal = kills[0] + kills[1] + kills[2];
+        out << "kills_per_match: " << killTotal / count << "\n";
+        const char* causeNames[3] = {"flying_out", "hanging", "returning"};
+        for (int c = 0; c < 3; ++c) {
+            out << "kill_cause_" << causeNames[c] << ": " << kills[c]
+                << " (" << (killTotal ? 100.0 * kills[c] / killTotal : 0.0) << "%)\n";
+        }
+        for (std::size_t l = 0; l < levels.size(); ++l) {
+            if (levelMatches[l] == 0) continue;
+            out << "arena_" << levels[l].name << "_length_mean_seconds: "
+                << levelTicks[l] / levelMatches[l] / 60.0 << "\n";
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 1;
+
+    std::vector<Variant> variants;
+    for (const auto& text : options.variantArgs) {
+        Variant variant;
+        if (!parseVariant(text, options.tuning, variant)) return 1;
+        variants.push_back(variant);
+    }
+    if (variants.empty()) variants.push_back({"baseline", options.tuning});
+
+    const auto& levels = builtinLevels();
+    if (options.level >= static_cast<int>(levels.size())) {
+        std::cerr << "Error: There are only " << levels.size() << " arenas" << std::endl;
+        return 1;
+    }
+
+    // Every match is fully described up front, so the summary does not
+    // depend on how the pool happens to schedule them
+    std::vector<MatchSpec> specs;
+    for (int i = 0; i < options.matches; ++i) {
+        MatchSpec spec;
+        spec.index = i;
+        spec.seed = mixSeed(options.seed, i);
+        spec.levelIndex = options.level >= 0 ? options.level : i % levels.size();
+        spec.variantIndex = i % variants.size();
+        specs.push_back(spec);
+    }
+
+    std::vector<MatchResult> results(specs.size());
+
+    std::unique_ptr<TelemetryWriter> telemetry;
+    if (!options.telemetryPath.empty()) {
+        telemetry = std::make_unique<TelemetryWriter>(options.telemetryPath);
+        if (!telemetry->isOpen()) return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    unsigned int threadCount;
+    {
+        ThreadPool pool(options.threads);
+        threadCount = pool.getThreadCount();
+        std::cout << "Running " << specs.size() << " matches on " << threadCount << " threads..." << std::endl;
+        for (const auto& spec : specs) {
+            pool.submit([&, spec] {
+                results[spec.index] = runMatch(spec, variants[spec.variantIndex], options.players, options.maxTicks,
+                                               telemetry.get());
+            });
+        }
+        pool.wait();
+    }
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ofstream out(options.outPath);
+    if (!out) {
+        std::cerr << "Error: Could not write " << options.outPath << std::endl;
+        return 1;
+    }
+    writeSummary(out, options, variants, specs, results, wallSeconds, threadCount);
+    writeSummary(std::cout, options, variants, specs, results, wallSeconds, threadCount);
+    return 0;
+}
@@ -14,192 +14,161 @@ sf::Vector2f normalize(const sf::Vector2f& source) {
     return source;
 }
 
-Boomerang::Boomerang(std::shared_ptr<sf::Texture> texture, sf::Vector2f startPosition, sf::Vector2f initialVelocity, int ownerId) 
-    : m_position(startPosition)
+Boomerang::Boomerang(sf::Vector2f startPosition, sf::Vector2f initialVelocity, int ownerId, const Tuning& tuning) 
+    : m_tuning(tuning)
+    , m_hangTicks(0)
+    , m_position(startPosition)
     , m_velocity(initialVelocity)
     , m_state(State::FlyingOut)
     , m_ownerId(ownerId)
-    , m_texture(texture)
-    , m_sprite(*m_texture)
     , m_rotation(0.0f)
     , m_rotationSpeed(720.0f)
 {
-    // Setup sprite with the provided texture (texture is already loaded by runner.cpp)
-    m_sprite.setTextureRect(sf::IntRect({0, 0}, {(int)m_texture->getSize().x, (int)m_texture->getSize().y}));
-    
-    // Center the origin based on texture size
-    sf::Vector2u texSize = m_texture->getSize();
-    m_sprite.setOrigin({texSize.x / 2.0f, texSize.y / 2.0f});
-
-    // Scale the sprite
-    m_sprite.setScale({2.5f, 2.5f});
-    m_sprite.setPosition(m_position);
-    
     // Set hitbox to match sprite size (circular collision will be used)
-    float spriteSize = std::max(texSize.x, texSize.y) * 2.5f;
+    float spriteSize = m_tuning.boomerangSize;
     m_shape.setSize({spriteSize, spriteSize});
     m_shape.setFillColor(sf::Color::Magenta);
     m_shape.setOrigin({spriteSize / 2.0f, spriteSize / 2.0f});
     m_shape.setPosition(m_position);
+}
 
-    m_hangDuration = sf::seconds(0.05f);
+// Circle-based collision detection against the tiles. Pushes the boomerang
+// out of the first tile it overlaps and reflects its velocity. Returns true
+// if it hit something.
+static bool collideWithTiles(sf::Vector2f& position, sf::Vector2f& velocity, float radius,
+                             const std::vector<sf::RectangleShape>& tiles) {
+    for (const auto& tile : tiles) {
+        sf::FloatRect tileBounds = tile.getGlobalBounds();
+        
+        // Find closest point on the rectangle to the circle center
+        float closestX = std::max(tileBounds.position.x, std::min(position.x, tileBounds.position.x + tileBounds.size.x));
+        float closestY = std::max(tileBounds.position.y, std::min(position.y, tileBounds.position.y + tileBounds.size.y));
+        
+        // Calculate distance from circle center to closest point
+        float distanceX = position.x - closestX;
+        float distanceY = position.y - closestY;
+        float distanceSquared = distanceX * distanceX + distanceY * distanceY;
+        
+        // Check if collision occurred
+        if (distanceSquared < radius * radius) {
+            float distance = std::sqrt(distanceSquared);
+            
+            // Calculate collision normal
+            sf::Vector2f normal;
+            if (distance > 0.001f) {
+                normal = sf::Vector2f(distanceX / distance, distanceY / distance);
+            } else {
+                // Boomerang center is inside tile, use velocity direction
+                normal = normalize(sf::Vector2f(-velocity.x, -velocity.y));
+            }
+            
+            // Reflect velocity along the normal
+            float dotProduct = velocity.x * normal.x + velocity.y * normal.y;
+            velocity.x = velocity.x - 2.0f * dotProduct * normal.x;
+            velocity.y = velocity.y - 2.0f * dotProduct * normal.y;
+            
+            // Push boomerang out of collision
+            float overlap = radius - distance + 0.5f; // Small buffer to prevent re-collision
+            position.x += normal.x * overlap;
+            position.y += normal.y * overlap;
+            
+            return true; // Only handle one collision per frame
+        }
+    }
+    return false;
 }
 
-void Boomerang::update(sf::Vector2f playerPosition, const std::vector<sf::RectangleShape>& tiles) {
-    switch (m_state) {
+bool Boomerang::advance(Motion& motion, sf::Vector2f playerPosition, const std::vector<sf::RectangleShape>& tiles,
+                        float radius, const Tuning& tuning, const PhysicsStep& step) {
+    bool bounced = false;
+
+    switch (motion.state) {
         case State::FlyingOut:
-        {
-            m_velocity *= 0.98f;
-            m_position += m_velocity;
+            motion.velocity *= step.damping;
+            motion.position += motion.velocity * step.fraction;
 
-            // Circle-based collision detection
-            float radius = m_shape.getSize().x / 2.0f * 0.7f; // Use 70% of sprite size for tighter collision
-            
-            for (const auto& tile : tiles) {
-                sf::FloatRect tileBounds = tile.getGlobalBounds();
-                
-                // Find closest point on the rectangle to the circle center
-                float closestX = std::max(tileBounds.position.x, std::min(m_position.x, tileBounds.position.x + tileBounds.size.x));
-                float closestY = std::max(tileBounds.position.y, std::min(m_position.y, tileBounds.position.y + tileBounds.size.y));
-                
-                // Calculate distance from circle center to closest point
-                float distanceX = m_position.x - closestX;
-                float distanceY = m_position.y - closestY;
-                float distanceSquared = distanceX * distanceX + distanceY * distanceY;
-                
-                // Check if collision occurred
-                if (distanceSquared < radius * radius) {
-                    float distance = std::sqrt(distanceSquared);
-                    
-                    // Calculate collision normal
-                    sf::Vector2f normal;
-                    if (distance > 0.001f) {
-                        normal = sf::Vector2f(distanceX / distance, distanceY / distance);
-                    } else {
-                        // Boomerang center is inside tile, use velocity direction
-                        normal = normalize(sf::Vector2f(-m_velocity.x, -m_velocity.y));
-                    }
-                    
-                    // Reflect velocity along the normal with energy loss
-                    float dotProduct = m_velocity.x * normal.x + m_velocity.y * normal.y;
-                    m_velocity.x = m_velocity.x - 2.0f * dotProduct * normal.x;
-                    m_velocity.y = m_velocity.y - 2.0f * dotProduct * normal.y;
-                    m_velocity *= 0.85f; // Energy loss on bounce
-                    
-                    // Push boomerang out of collision
-                    float overlap = radius - distance + 0.5f; // Small buffer to prevent re-collision
-                    m_position.x += normal.x * overlap;
-                    m_position.y += normal.y * overlap;
-                    
-                    break; // Only handle one collision per frame
-                }
+            if (collideWithTiles(motion.position, motion.velocity, radius, tiles)) {
+                motion.velocity *= tuning.bounceLoss; // Energy loss on bounce
+                bounced = true;
             }
             
-            if (length(m_velocity) < 1.f) {
-                m_state = State::Hanging;
-                m_hangTimer.restart();
+            if (length(motion.velocity) < tuning.hangSpeed) {
+                motion.state = State::Hanging;
+                motion.hangTicks = 0;
             }
             break;
-        }
 
         case State::Hanging:
-            if (m_hangTimer.getElapsedTime() >= m_hangDuration) {
-                m_state = State::Returning;
+            if (++motion.hangTicks >= step.hangSubsteps) {
+                motion.state = State::Returning;
             }
             break;
 
         case State::Returning:
             { 
                 // Boomerang returns to player
-                sf::Vector2f returnDirection = playerPosition - m_position;
-                if (length(returnDirection) < 20.f) {
-                    m_state = State::Caught;
+                sf::Vector2f returnDirection = playerPosition - motion.position;
+                if (length(returnDirection) < tuning.catchDistance) {
+                    motion.state = State::Caught;
                     break;
                 }
                 returnDirection = normalize(returnDirection);
-                float returnSpeed = 5.f; 
-                m_velocity = returnDirection * returnSpeed;
-                m_position += m_velocity;
-
-                // Circle-based collision detection for ricochet
-                float radius = m_shape.getSize().x / 2.0f * 0.7f;
-                
-                for (const auto& tile : tiles) {
-                    sf::FloatRect tileBounds = tile.getGlobalBounds();
-                    
-                    // Find closest point on the rectangle to the circle center
-                    float closestX = std::max(tileBounds.position.x, std::min(m_position.x, tileBounds.position.x + tileBounds.size.x));
-                    float closestY = std::max(tileBounds.position.y, std::min(m_position.y, tileBounds.position.y + tileBounds.size.y));
-                    
-                    // Calculate distance from circle center to closest point
-                    float distanceX = m_position.x - closestX;
-                    float distanceY = m_position.y - closestY;
-                    float distanceSquared = distanceX * distanceX + distanceY * distanceY;
-                    
-                    // Check if collision occurred
-                    if (distanceSquared < radius * radius) {
-                        float distance = std::sqrt(distanceSquared);
-                        
-                        // Calculate collision normal
-                        sf::Vector2f normal;
-                        if (distance > 0.001f) {
-                            normal = sf::Vector2f(distanceX / distance, distanceY / distance);
-                        } else {
-                            normal = normalize(sf::Vector2f(-m_velocity.x, -m_velocity.y));
-                        }
-                        
-                        // Reflect velocity along the normal to prevent tunneling
-                        float dotProduct = m_velocity.x * normal.x + m_velocity.y * normal.y;
-                        m_velocity.x = m_velocity.x - 2.0f * dotProduct * normal.x;
-                        m_velocity.y = m_velocity.y - 2.0f * dotProduct * normal.y;
-                        
-                        // Push boomerang out of collision
-                        float overlap = radius - distance + 0.5f;
-                        m_position.x += normal.x * overlap;
-                        m_position.y += normal.y * overlap;
-                        
-                        break; // Only handle one collision per frame
-                    }
-                }
+                motion.velocity = returnDirection * tuning.returnSpeed;
+                motion.position += motion.velocity * step.fraction;
+
+                // Ricochet without energy loss to prevent tunneling. On the way
+                // back this mostly slides along walls, so it isn't reported as a bounce.
+                collideWithTiles(motion.position, motion.velocity, radius, tiles);
             }
             break;
         
         case State::Caught:
             break;
     }
+    return bounced;
+}
+
+int Boomerang::predictPath(sf::Vector2f startPosition, sf::Vector2f initialVelocity, sf::Vector2f playerPosition,
+                           const std::vector<sf::RectangleShape>& tiles, float radius, const Tuning& tuning,
+                           int maxTicks, std::vector<sf::Vector2f>& path) {
+    path.clear();
+    PhysicsStep step(tuning);
+    Motion motion{startPosition, initialVelocity, State::FlyingOut, 0};
+    path.push_back(motion.position);
+
+    int tick = 0;
+    while (tick < maxTicks && motion.state != State::Caught) {
+        for (int i = 0; i < step.substeps; ++i) {
+            advance(motion, playerPosition, tiles, radius, tuning, step);
+        }
+        path.push_back(motion.position);
+        ++tick;
+    }
+    return tick;
+}
+
+float Boomerang::collisionRadius(const Tuning& tuning) {
+    // Use 70% of sprite size for tighter collision
+    return tuning.boomerangSize / 2.0f * 0.7f;
+}
+
+bool Boomerang::update(sf::Vector2f playerPosition, const std::vector<sf::RectangleShape>& tiles,
+                       const PhysicsStep& step) {
+    Motion motion{m_position, m_velocity, m_state, m_hangTicks};
+    bool bounced = advance(motion, playerPosition, tiles, collisionRadius(m_tuning), m_tuning, step);
+    m_position = motion.position;
+    m_velocity = motion.velocity;
+    m_state = motion.state;
+    m_hangTicks = motion.hangTicks;
     
     m_shape.setPosition(m_position);
     
     // Update rotation based on velocity (faster = faster spin)
     float speed = length(m_velocity);
-    m_rotation += m_rotationSpeed * (1.0f / 60.0f); // Assuming 60 FPS
+    m_rotation += m_rotationSpeed * (1.0f / 60.0f) * step.fraction; // Assuming 60 FPS
     if (m_rotation >= 360.0f) m_rotation -= 360.0f;
     
-    // Temporarily disabled rotation to test visibility
-    m_sprite.setRotation(sf::degrees(m_rotation));
-    m_sprite.setPosition(m_position);
-}
-
-void Boomerang::draw(sf::RenderWindow& window) {
-    if (m_state != State::Caught){
-        // Always try to draw the sprite if texture is loaded
-        if (m_texture->getSize().x > 0) {
-            window.draw(m_sprite, sf::RenderStates::Default);
-            
-            // Debug: draw the circular hitbox
-            float radius = m_shape.getSize().x / 2.0f * 0.7f;
-            sf::CircleShape debugCircle(radius);
-            debugCircle.setOrigin({radius, radius});
-            debugCircle.setPosition(m_position);
-            debugCircle.setFillColor(sf::Color::Transparent);
-            debugCircle.setOutlineColor(sf::Color::Cyan);
-            debugCircle.setOutlineThickness(2.0f);
-            window.draw(debugCircle);
-        } else {
-            // Fallback to rectangle if texture not loaded
-            window.draw(m_shape);
-        }
-    }
+    return bounced;
 }
 
 Boomerang::State Boomerang::getState() const {
@@ -210,3 +179,6 @@ sf::FloatRect Boomerang::getBounds() const {
     return m_shape.getGlobalBounds();
 }
 int Boomerang::getOwnerId() const { return m_ownerId; }
+sf::Vector2f Boomerang::getPosition() const { return m_position; }
+sf::Vector2f Boomerang::getVelocity() const { return m_velocity; }
+float Boomerang::getRotation() const { return m_rotation; }
@@ -2,8 +2,8 @@
 #define BOOMERANG_HPP
 
 #include <vector>
-#include <memory>
 #include <SFML/Graphics.hpp>
+#include "tuning.hpp"
 
 class Boomerang {
 public:
@@ -15,17 +15,60 @@ public:
         Caught
     };
 
-    Boomerang(std::shared_ptr<sf::Texture> texture, sf::Vector2f startPosition, sf::Vector2f direction, int ownerId);
+    Boomerang(sf::Vector2f startPosition, sf::Vector2f direction, int ownerId, const Tuning& tuning = Tuning());
 
-    void update(sf::Vector2f playerPosition, const std::vector<sf::RectangleShape>& tiles);
-    void draw(sf::RenderWindow& window);
+    // The part of a boomerang that moves; enough to simulate it without a sprite
+    struct Motion {
+        sf::Vector2f position;
+        sf::Vector2f velocity;
+        State state;
+        int hangTicks;          // Counted in substeps
+    };
+
+    // Moves by one physics substep. Returns true if the boomerang bounced off
+    // a tile (flying out)
+    bool update(sf::Vector2f playerPosition, const std::vector<sf::RectangleShape>& tiles, const PhysicsStep& step);
+
+    // Moves a boomerang by one substep. update() and predictPath() both go
+    // through here, so a predicted path follows exactly the rules of a real
+    // throw. Returns true if it bounced off a tile while flying out.
+    static bool advance(Motion& motion, sf::Vector2f playerPosition, const std::vector<sf::RectangleShape>& tiles,
+                        float radius, const Tuning& tuning, const PhysicsStep& step);
+
+    // Forward-simulates a throw until it is caught or maxTicks pass, assuming the
+    // thrower stays at playerPosition. Fills path with one point per tick and
+    // returns the number of ticks simulated.
+    static int predictPath(sf::Vector2f startPosition, sf::Vector2f initialVelocity, sf::Vector2f playerPosition,
+                           const std::vector<sf::RectangleShape>& tiles, float radius, const Tuning& tuning,
+                           int maxTicks, std::vector<sf::Vector2f>& path);
+
+    // Radius of the circle used against tiles
+    static float collisionRadius(const Tuning& tuning);
 
-    sf::Time m_hangDuration;
-    sf::Clock m_hangTimer;
     sf::FloatRect getBounds() const;
     State getState() const;
     int getOwnerId() const;
+    sf::Vector2f getPosition() const;
+    sf::Vector2f getVelocity() const;
+    float getRotation() const;  // Degrees, for drawing
+
+    // Calls visit(name, value) for every field that carries over from one
+    // substep to the next, in a fixed order; see Player::visitState
+    template <typename Visitor>
+    void visitState(Visitor& visit) const {
+        visit("ownerId", m_ownerId);
+        visit("position", m_position);
+        visit("shapePosition", m_shape.getPosition());
+        visit("velocity", m_velocity);
+        visit("state", m_state);
+        visit("hangTicks", m_hangTicks);
+        visit("rotation", m_rotation);
+        visit("rotationSpeed", m_rotationSpeed);
+    }
+
 private:
+    Tuning m_tuning;
+    int m_hangTicks;
     sf::Vector2f m_position;
     sf::Vector2f m_velocity;
     
@@ -33,11 +76,7 @@ private:
     State m_state;
     int  m_ownerId;
     
-    // Sprite and animation
-    std::shared_ptr<sf::Texture> m_texture;
-    sf::Sprite m_sprite;
-    sf::IntRect m_currentFrame;
-    sf::Vector2i m_spriteSize;
+    // Spin, drawn by the Renderer
     float m_rotation;
     float m_rotationSpeed;
 };
@@ -0,0 +1,151 @@
+#include "bot.hpp"
+#include "world.hpp"
+#include <cmath>
+
+Bot::Bot(std::uint32_t seed)
+    : m_rng(seed)
+    , m_chargeTicks(0)
+    , m_aim(1.f, 0.f)
+    , m_wanderDirection(0)
+    , m_wanderTicks(0)
+    , m_edge(-1)
+    , m_edgeTick(0)
+{
+}
+
+void Bot::reset() {
+    m_chargeTicks = 0;
+    m_aim = {1.f, 0.f};
+    m_wanderDirection = 0;
+    m_wanderTicks = 0;
+    m_edge = -1;
+    m_edgeTick = 0;
+}
+
+bool Bot::chance(float probability) {
+    return std::uniform_real_distribution<float>(0.f, 1.f)(m_rng) < probability;
+}
+
+PlayerInput Bot::edgeInput(const NavGraph::Edge& edge) const {
+    PlayerInput input;
+    input.left = m_edgeTick < edge.holdTicks && edge.direction < 0;
+    input.right = m_edgeTick < edge.holdTicks && edge.direction > 0;
+    input.jump = edge.jump && m_edgeTick == 0;
+    input.dash = m_edgeTick == edge.dashTick;
+    return input;
+}
+
+PlayerInput Bot::think(const World& world, int playerId) {
+    PlayerInput input;
+
+    const Player* self = world.findPlayer(playerId);
+    if (!self || !self->isAlive()) {
+        m_edge = -1;
+        return input;
+    }
+
+    // Finish a move between platforms before doing anything else; it only
+    // lands where the graph says if the inputs are the same
+    const NavGraph& nav = world.getNavGraph();
+    if (m_edge >= 0) {
+        const NavGraph::Edge& edge = nav.getEdge(m_edge);
+        bool landed = m_edgeTick > 0 && self->isGrounded() && self->getState() == Player::State::Normal &&
+                      (edge.type == NavGraph::EdgeType::Jump || edge.type == NavGraph::EdgeType::Dash ||
+                       nav.findSegment(self->getPosition()) != edge.from);
+        if (landed || m_edgeTick > edge.ticks + 30) {
+            m_edge = -1;
+        } else {
+            input = edgeInput(edge);
+            ++m_edgeTick;
+            return input;
+        }
+    }
+
+    // Find the nearest living opponent
+    const Player* target = nullptr;
+    float bestDistance = 0.f;
+    for (const auto& other : world.getPlayers()) {
+        if (other.getId() == playerId || !other.isAlive()) continue;
+        sf::Vector2f delta = other.getPosition() - self->getPosition();
+        float distance = delta.x * delta.x + delta.y * delta.y;
+        if (!target || distance < bestDistance) {
+            target = &other;
+            bestDistance = distance;
+        }
+    }
+    if (!target) return input;
+
+    sf::Vector2f delta = target->getPosition() - self->getPosition();
+
+    // Keep holding the throw until the charge runs out, then let go
+    if (m_chargeTicks > 0) {
+        --m_chargeTicks;
+        input.throwPressed = m_chargeTicks > 0;
+        input.aim = m_aim;
+        return input;
+    }
+
+    // Start a throw with some aim error if our boomerang is back in hand
+    if (!world.hasBoomerang(playerId) && self->getState() == Player::State::Normal && chance(0.03f)) {
+        float angle = std::atan2(delta.y, delta.x) + std::normal_distribution<float>(0.f, 0.15f)(m_rng);
+        m_aim = {std::cos(angle), std::sin(angle)};
+        m_chargeTicks = std::uniform_int_distribution<int>(4, 20)(m_rng);
+        input.throwPressed = true;
+        input.aim = m_aim;
+        return input;
+    }
+
+    // On another platform: head for the start of the next move on the way
+    // there, then make it
+    int here = self->isGrounded() ? nav.findSegment(self->getPosition()) : -1;
+    int there = nav.findSegment(target->getPosition());
+    const std::vector<int>* path = here >= 0 && there >= 0 ? nav.findPath(here, there) : nullptr;
+    if (path && !path->empty()) {
+        int next = path->front();
+        const NavGraph::Edge& edge = nav.getEdge(next);
+        float offset = self->getPosition().x - edge.launchX;
+        bool walkOff = edge.type == NavGraph::EdgeType::Walk || edge.type == NavGraph::EdgeType::Fall;
+        bool inPlace = walkOff ? offset * edge.direction >= -3.f : std::abs(offset) <= 3.f;
+
+        if (!inPlace) {
+            input.left = offset > 0.f;
+            input.right = offset < 0.f;
+        } else if (edge.dashTick < 0 || self->canDash()) {
+            m_edge = next;
+            m_edgeTick = 0;
+            input = edgeInput(edge);
+            ++m_edgeTick;
+        }
+        return input;
+    }
+
+    // Walk towards the target, or wander a bit once close
+    int direction = 0;
+    if (std::abs(delta.x) > 60.f) {
+        direction = delta.x > 0 ? 1 : -1;
+    } else {
+        if (m_wanderTicks <= 0) {
+            m_wanderDirection = std::uniform_int_distribution<int>(-1, 1)(m_rng);
+            m_wanderTicks = std::uniform_int_distribution<int>(10, 40)(m_rng);
+        }
+        --m_wanderTicks;
+        direction = m_wanderDirection;
+    }
+    input.left = direction < 0;
+    input.right = direction > 0;
+
+    // Jump when the target is above us, when a wall stops us, or just because
+    if (self->isGrounded()) {
+        bool blocked = direction != 0 && std::abs(self->getVelocity().x) < 0.1f;
+        if ((delta.y < -40.f && chance(0.1f)) || (blocked && chance(0.3f)) || chance(0.01f)) {
+            input.jump = true;
+        }
+    }
+
+    // Dash when the target is at medium range on roughly the same level
+    if (std::abs(delta.x) > 100.f && std::abs(delta.x) < 300.f && std::abs(delta.y) < 60.f && chance(0.02f)) {
+        input.dash = true;
+    }
+
+    return input;
+}
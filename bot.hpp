@@ -0,0 +1,41 @@
+#ifndef BOT_HPP
+#define BOT_HPP
+
+#include <cstdint>
+#include <random>
+#include "input.hpp"
+#include "nav_graph.hpp"
+
+class World;
+
+// Simple computer opponent. Chases the nearest dino, jumps and dashes at
+// random and throws with some aim error. When the target is on another
+// platform it follows the level's NavGraph there, taking each jump or dash
+// exactly as the graph simulated it. All randomness comes from the seed, so
+// a match between bots replays identically.
+class Bot {
+public:
+    explicit Bot(std::uint32_t seed);
+
+    // Decide the controls for player `playerId` for the next tick
+    PlayerInput think(const World& world, int playerId);
+
+    // Drops the current plan for a new match; the random stream carries on
+    void reset();
+
+private:
+    bool chance(float probability);
+
+    // Controls for the current tick of the edge being taken
+    PlayerInput edgeInput(const NavGraph::Edge& edge) const;
+
+    std::mt19937 m_rng;
+    int m_chargeTicks;      // Ticks left holding the throw button
+    sf::Vector2f m_aim;     // Aim chosen when the charge started
+    int m_wanderDirection;  // -1, 0 or 1 while strolling without a plan
+    int m_wanderTicks;
+    int m_edge;             // NavGraph edge being taken, or -1
+    int m_edgeTick;         // Ticks since it was started
+};
+
+#endif
@@ -0,0 +1,104 @@
+#include "character_controller.hpp"
+#include <algorithm>
+#include <cmath>
+
+// Boxes resting exactly on a cell boundary must not count as overlapping the
+// cell on the other side
+static const float EPSILON = 1e-3f;
+
+static int cellIndex(float coordinate) {
+    return static_cast<int>(std::floor(coordinate / TILE_SIZE));
+}
+
+struct Impact {
+    float time = 2.f;       // 0..1 along the move; above 1 means no hit
+    float face = 0.f;       // Coordinate of the tile face that was hit
+};
+
+// First solid cell touched by a box moving along one axis. lead is the box's
+// leading edge on that axis and move the distance along it; [crossMin,
+// crossMax] is its extent on the other axis, which moves by crossMove over
+// the same time. Visits one cell boundary per tile crossed.
+static Impact sweepAxis(float lead, float move, float crossMin, float crossMax, float crossMove,
+                        const TileGrid& grid, bool horizontal) {
+    Impact impact;
+    if (move == 0.f) return impact;
+    const int step = move > 0.f ? 1 : -1;
+
+    // First boundary at or ahead of the leading edge
+    int boundary = step > 0 ? static_cast<int>(std::ceil((lead - EPSILON) / TILE_SIZE))
+                            : static_cast<int>(std::floor((lead + EPSILON) / TILE_SIZE));
+    while (true) {
+        float face = boundary * TILE_SIZE;
+        float t = std::max(0.f, (face - lead) / move);
+        if (t > 1.f) return impact;
+
+        // The cell being entered, and the cells the box spans across it then
+        int entered = step > 0 ? boundary : boundary - 1;
+        int first = cellIndex(crossMin + crossMove * t + EPSILON);
+        int last = cellIndex(crossMax + crossMove * t - EPSILON);
+        for (int cross = first; cross <= last; ++cross) {
+            if (horizontal ? grid.isSolid(entered, cross) : grid.isSolid(cross, entered)) {
+                impact.time = t;
+                impact.face = face;
+                return impact;
+            }
+        }
+        boundary += step;
+    }
+}
+
+CollisionContacts moveAndCollide(sf::Vector2f& position, sf::Vector2f& velocity, sf::Vector2f displacement,
+                                 sf::Vector2f halfSize, const TileGrid& grid) {
+    CollisionContacts contacts;
+
+    // Each pass either finishes the move or blocks one axis, so two passes
+    // cover everything; the third catches a corner that blocks both
+    for (int pass = 0; pass < 3; ++pass) {
+        if (displacement.x == 0.f && displacement.y == 0.f) break;
+
+        float leadX = position.x + (displacement.x > 0.f ? halfSize.x : -halfSize.x);
+        float leadY = position.y + (displacement.y > 0.f ? halfSize.y : -halfSize.y);
+        Impact impactX = sweepAxis(leadX, displacement.x, position.y - halfSize.y, position.y + halfSize.y,
+                                   displacement.y, grid, true);
+        Impact impactY = sweepAxis(leadY, displacement.y, position.x - halfSize.x, position.x + halfSize.x,
+                                   displacement.x, grid, false);
+
+        if (impactX.time > 1.f && impactY.time > 1.f) {
+            position += displacement;
+            break;
+        }
+
+        // Advance to the earliest impact, sit flush against the face that
+        // was hit and slide along it with whatever is left of the move
+        bool hitY = impactY.time <= impactX.time;
+        bool movingRight = displacement.x > 0.f;
+        bool movingDown = displacement.y > 0.f;
+        float t = hitY ? impactY.time : impactX.time;
+        position += displacement * t;
+        displacement *= 1.f - t;
+
+        if (hitY) {
+            if (movingDown) {
+                position.y = impactY.face - halfSize.y;
+                contacts.ground = true;
+            } else {
+                position.y = impactY.face + halfSize.y;
+                contacts.ceiling = true;
+            }
+            displacement.y = 0.f;
+            velocity.y = 0.f;
+        } else {
+            if (movingRight) {
+                position.x = impactX.face - halfSize.x;
+                contacts.wallRight = true;
+            } else {
+                position.x = impactX.face + halfSize.x;
+                contacts.wallLeft = true;
+            }
+            displacement.x = 0.f;
+            velocity.x = 0.f;
+        }
+    }
+    return contacts;
+}
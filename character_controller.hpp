@@ -0,0 +1,26 @@
+#ifndef CHARACTER_CONTROLLER_HPP
+#define CHARACTER_CONTROLLER_HPP
+
+#include <SFML/System.hpp>
+#include "level.hpp"
+
+// Which faces of the hitbox were stopped by a tile during a move
+struct CollisionContacts {
+    bool ground = false;
+    bool ceiling = false;
+    bool wallLeft = false;
+    bool wallRight = false;
+
+    bool wall() const { return wallLeft || wallRight; }
+};
+
+// Moves an axis-aligned box by displacement through the tile grid. The box
+// is swept along its path and stops at the first solid cell it would touch
+// (by time of impact); the blocked component of velocity is zeroed and the
+// rest of the move continues sliding along the face. Only the cells the
+// box passes over are looked at, so the cost grows with the distance moved
+// and never with the number of tiles in the level.
+CollisionContacts moveAndCollide(sf::Vector2f& position, sf::Vector2f& velocity, sf::Vector2f displacement,
+                                 sf::Vector2f halfSize, const TileGrid& grid);
+
+#endif
@@ -0,0 +1,176 @@
+#include "collision_mask.hpp"
+#include "boomerang.hpp"
+#include "player.hpp"
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+
+// Both sprites are 24x24 frames; pixels at least half opaque count as solid
+static constexpr int FrameSize = 24;
+static constexpr std::uint8_t SolidAlpha = 128;
+
+// How the Renderer draws them
+static constexpr float PlayerSpriteScale = 3.f;
+static constexpr float BoomerangSpriteScale = 2.5f;
+
+// Rounds to the nearest whole pixel; cheaper than std::lround for the
+// small offsets between two overlapping boxes
+static int roundOffset(float value) {
+    return static_cast<int>(value + 1024.5f) - 1024;
+}
+
+CollisionMask CollisionMask::solid(int width, int height) {
+    CollisionMask mask;
+    mask.width = width;
+    mask.height = height;
+    mask.rows.assign(height, width >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << width) - 1);
+    mask.updateBounds();
+    return mask;
+}
+
+void CollisionMask::updateBounds() {
+    top = height;
+    bottom = 0;
+    columns = 0;
+    for (int y = 0; y < height; ++y) {
+        if (!rows[y]) continue;
+        top = std::min(top, y);
+        bottom = y + 1;
+        columns |= rows[y];
+    }
+}
+
+bool masksOverlap(const CollisionMask& a, sf::Vector2i aPosition, const CollisionMask& b, sf::Vector2i bPosition) {
+    int dx = bPosition.x - aPosition.x;
+    int dy = bPosition.y - aPosition.y;
+    if (dx >= 64 || dx <= -64) return false;
+    auto shift = [dx](std::uint64_t row) { return dx >= 0 ? row << dx : row >> -dx; };
+
+    // No column in common means no pixel either
+    if (!(a.columns & shift(b.columns))) return false;
+
+    // Shift each of b's rows into a's columns and AND a whole row at once,
+    // over the rows where both have pixels
+    int first = std::max(a.top, b.top + dy);
+    int last = std::min(a.bottom, b.bottom + dy);
+    for (int y = first; y < last; ++y) {
+        if (a.rows[y] & shift(b.rows[y - dy])) return true;
+    }
+    return false;
+}
+
+HitMasks::HitMasks(const Tuning& tuning)
+    : m_pixelAccurate(true)
+{
+    // Boomerang boxes wider than a row are trimmed to the middle 64 pixels
+    const int playerBox = PlayerBoxSize;
+    const int boomerangBox = std::min(static_cast<int>(std::lround(tuning.boomerangSize)), 64);
+
+    // Dino frames, sampled where the hitbox sits over the sprite
+    sf::Image sheet;
+    if (sheet.loadFromFile("assets/DinoSprites - doux.png") && sheet.getSize().x >= PlayerFrames * FrameSize &&
+        sheet.getSize().y >= FrameSize) {
+        const float inset = (FrameSize * PlayerSpriteScale - playerBox) / 2.f;
+        for (int frame = 0; frame < PlayerFrames; ++frame) {
+            for (int facing = 0; facing < 2; ++facing) {
+                CollisionMask& mask = m_playerMasks[frame + facing * PlayerFrames];
+                mask = CollisionMask::solid(playerBox, playerBox);
+                for (int y = 0; y < playerBox; ++y) {
+                    std::uint64_t row = 0;
+                    for (int x = 0; x < playerBox; ++x) {
+                        int sx = static_cast<int>((x + inset) / PlayerSpriteScale);
+                        int sy = static_cast<int>((y + inset) / PlayerSpriteScale);
+                        if (facing == 1) sx = FrameSize - 1 - sx;
+                        sf::Vector2u pixel(frame * FrameSize + sx, sy);
+                        if (sheet.getPixel(pixel).a >= SolidAlpha) row |= std::uint64_t(1) << x;
+                    }
+                    mask.rows[y] = row;
+                }
+                mask.updateBounds();
+            }
+        }
+    } else {
+        m_pixelAccurate = false;
+        m_playerMasks.fill(CollisionMask::solid(playerBox, playerBox));
+    }
+
+    // Boomerang, turned to the middle of each rotation step. A pixel is
+    // solid if the sprite pixel drawn over its centre is.
+    sf::Image boomerang;
+    if (boomerang.loadFromFile("vite_boomerang.png") && boomerang.getSize().x >= FrameSize &&
+        boomerang.getSize().y >= FrameSize) {
+        const float half = boomerangBox / 2.f;
+        for (int step = 0; step < RotationSteps; ++step) {
+            float angle = step * 2.f * 3.14159265f / RotationSteps;
+            float c = std::cos(angle);
+            float s = std::sin(angle);
+            CollisionMask& mask = m_boomerangMasks[step];
+            mask = CollisionMask::solid(boomerangBox, boomerangBox);
+            for (int y = 0; y < boomerangBox; ++y) {
+                std::uint64_t row = 0;
+                for (int x = 0; x < boomerangBox; ++x) {
+                    // Undo the rotation to find the sprite pixel
+                    float ox = x + 0.5f - half;
+                    float oy = y + 0.5f - half;
+                    float lx = (ox * c + oy * s) / BoomerangSpriteScale + FrameSize / 2.f;
+                    float ly = (-ox * s + oy * c) / BoomerangSpriteScale + FrameSize / 2.f;
+                    if (lx < 0.f || ly < 0.f || lx >= FrameSize || ly >= FrameSize) continue;
+                    sf::Vector2u pixel(static_cast<unsigned int>(lx), static_cast<unsigned int>(ly));
+                    if (boomerang.getPixel(pixel).a >= SolidAlpha) row |= std::uint64_t(1) << x;
+                }
+                mask.rows[y] = row;
+            }
+            mask.updateBounds();
+        }
+    } else {
+        m_pixelAccurate = false;
+        m_boomerangMasks.fill(CollisionMask::solid(boomerangBox, boomerangBox));
+    }
+}
+
+std::shared_ptr<const HitMasks> HitMasks::forTuning(const Tuning& tuning) {
+    struct Entry {
+        float boomerangSize;
+        std::shared_ptr<const HitMasks> masks;
+    };
+    static std::mutex mutex;
+    static std::vector<Entry> masks;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& entry : masks) {
+        if (entry.boomerangSize == tuning.boomerangSize) return entry.masks;
+    }
+    masks.push_back({tuning.boomerangSize, std::make_shared<const HitMasks>(tuning)});
+    if (!masks.back().masks->isPixelAccurate()) {
+        std::cerr << "Warning: Could not load the dino or boomerang sprite; hits use whole boxes" << std::endl;
+    }
+    return masks.back().masks;
+}
+
+const CollisionMask& HitMasks::getPlayerMask(int frame, bool facingRight) const {
+    frame = std::clamp(frame, 0, PlayerFrames - 1);
+    return m_playerMasks[frame + (facingRight ? 0 : PlayerFrames)];
+}
+
+const CollisionMask& HitMasks::getBoomerangMask(float rotationDegrees) const {
+    // Rotations run from 0 up to 360 degrees
+    int step = static_cast<int>(rotationDegrees * (RotationSteps / 360.f) + 0.5f) % RotationSteps;
+    if (step < 0) step += RotationSteps;
+    return m_boomerangMasks[step];
+}
+
+bool HitMasks::isPixelAccurate() const { return m_pixelAccurate; }
+
+bool HitMasks::hits(const Player& player, const Boomerang& boomerang) const {
+    const CollisionMask& playerMask = getPlayerMask(player.getAnimationFrame(), player.isFacingRight());
+    const CollisionMask& boomerangMask = getBoomerangMask(boomerang.getRotation());
+
+    // Both boxes are centred on their entity
+    sf::Vector2f playerCorner = player.getPosition() - sf::Vector2f(PlayerBoxSize, PlayerBoxSize) / 2.f;
+    sf::Vector2f boomerangCorner =
+        boomerang.getPosition() - sf::Vector2f(boomerangMask.width, boomerangMask.height) / 2.f;
+    sf::Vector2f offset = boomerangCorner - playerCorner;
+    return masksOverlap(playerMask, {0, 0}, boomerangMask, {roundOffset(offset.x), roundOffset(offset.y)});
+}
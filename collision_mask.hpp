@@ -0,0 +1,73 @@
+#ifndef COLLISION_MASK_HPP
+#define COLLISION_MASK_HPP
+
+#include <SFML/System.hpp>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "tuning.hpp"
+
+class Player;
+class Boomerang;
+
+// Which pixels of a hitbox a sprite actually covers, one bit per world
+// pixel: bit x of rows[y] is the pixel x across and y down from the box's
+// top left corner. Boxes are at most 64 pixels wide, so a row is one word
+// and two masks are tested against each other a whole row at a time.
+struct CollisionMask {
+    int width = 0;
+    int height = 0;
+    std::vector<std::uint64_t> rows;
+
+    // Summary for quick misses: the rows from top up to bottom hold every
+    // set pixel, and columns has a bit set for each column with any
+    int top = 0;
+    int bottom = 0;
+    std::uint64_t columns = 0;
+
+    // Every pixel of a width x height box set
+    static CollisionMask solid(int width, int height);
+
+    // Recomputes the summary after rows has been written
+    void updateBounds();
+};
+
+// Whether a at aPosition and b at bPosition share a set pixel. Positions
+// are the boxes' top left corners in whole pixels.
+bool masksOverlap(const CollisionMask& a, sf::Vector2i aPosition, const CollisionMask& b, sf::Vector2i bPosition);
+
+// The shapes boomerangs and dinos are hit-tested with, precomputed from the
+// sprites' alpha: one mask per animation frame of the dino sheet in each
+// facing, and one per rotation step of the boomerang. Each is clipped to
+// the entity's hitbox, so the box test stays the broad phase and the masks
+// only ever turn a box overlap into a miss.
+//
+// Built once per boomerang size and shared between every World, like
+// NavGraph. Without the sprite files the masks are solid boxes, which
+// gives the old box-against-box rule.
+class HitMasks {
+public:
+    static constexpr int PlayerFrames = 24;         // Frames in the dino sheet
+    static constexpr int PlayerBoxSize = 48;        // The 24 px sprite is drawn at 3x; the hitbox is its middle
+    static constexpr int RotationSteps = 64;        // About 5.6 degrees each
+
+    explicit HitMasks(const Tuning& tuning);
+
+    // The masks for tuning's boomerang size. Thread safe.
+    static std::shared_ptr<const HitMasks> forTuning(const Tuning& tuning);
+
+    const CollisionMask& getPlayerMask(int frame, bool facingRight) const;
+    const CollisionMask& getBoomerangMask(float rotationDegrees) const;
+    bool isPixelAccurate() const;   // False if the sprites couldn't be loaded
+
+    // Call once the boxes are known to overlap
+    bool hits(const Player& player, const Boomerang& boomerang) const;
+
+private:
+    std::array<CollisionMask, PlayerFrames * 2> m_playerMasks;     // Facing right, then left
+    std::array<CollisionMask, RotationSteps> m_boomerangMasks;
+    bool m_pixelAccurate;
+};
+
+#endif
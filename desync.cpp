@@ -0,0 +1,314 @@
+// Determinism checker.
+//
+// Plays each seeded bot match twice at once, two worlds on two threads, and
+// compares World::getStateHash() after every tick. At the first tick the
+// hashes differ it stops and prints what the two runs disagree on, field by
+// field, so nondeterminism (an uninitialised member, a wall-clock timer,
+// thread scheduling leaking into results) is caught the tick it appears:
+//
+//   ./dino_desync --matches 200 --jobs-b 4
+//
+// A bot match is fully determined by its seed, arena and tuning, the same
+// ones dino_batch uses for the same --seed and match number, so it stands
+// in for a recorded match. --jobs-a/--jobs-b give either run a job pool,
+// as the runner's --sim-threads does, to check the pooled step against the
+// serial one.
+//
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "world.hpp"
+#include "bot.hpp"
+#include "level.hpp"
+#include "tuning.hpp"
+#include "thread_pool.hpp"
+#include "match_seed.hpp"
+
+namespace {
+
+struct Options {
+    int matches = 1;
+    std::uint32_t seed = 1;
+    int level = -1;             // -1 = rotate through every built-in arena
+    int players = 4;
+    int maxTicks = 60 * 90;
+    int substeps = 1;
+    int jobsA = 0;
+    int jobsB = 2;
+    int fields = 20;            // Differing fields to print at most
+};
+
+// One of the two copies of a match
+struct Run {
+    Run(const Level& level, const Tuning& tuning, int players, std::uint32_t seed, int jobs)
+        : world(level, tuning)
+        , inputs(players)
+    {
+        if (jobs > 0) {
+            pool = std::make_unique<ThreadPool>(jobs);
+            world.setJobPool(pool.get());
+        }
+        for (int i = 0; i < players; ++i) {
+            world.addPlayer(-1);
+            bots.emplace_back(mixSeed(seed, i + 1));
+        }
+    }
+
+    void tick() {
+        for (int i = 0; i < static_cast<int>(bots.size()); ++i) {
+            inputs[i] = bots[i].think(world, i);
+        }
+        world.step(inputs);
+    }
+
+    std::unique_ptr<ThreadPool> pool;   // Declared first so it outlives the world using it
+    World world;
+    std::vector<Bot> bots;
+    std::vector<PlayerInput> inputs;
+};
+
+// Steps a Run on a thread of its own, one tick per startTick()
+class Partner {
+public:
+    explicit Partner(Run& run) : m_run(run), m_requested(0), m_done(0), m_stop(false), m_thread([this] { loop(); }) {}
+
+    ~Partner() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+    }
+
+    void startTick() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_requested;
+        }
+        m_wake.notify_one();
+    }
+
+    void waitTick() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_finished.wait(lock, [this] { return m_done == m_requested; });
+    }
+
+private:
+    void loop() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_wake.wait(lock, [this] { return m_stop || m_done < m_requested; });
+            if (m_stop) return;
+            lock.unlock();
+            m_run.tick();
+            lock.lock();
+            ++m_done;
+            m_finished.notify_one();
+        }
+    }
+
+    Run& m_run;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_finished;
+    long long m_requested;
+    long long m_done;
+    bool m_stop;
+    std::thread m_thread;
+};
+
+// Collects visitState() fields as printable name/value pairs
+struct FieldList {
+    struct Field {
+        std::string name;
+        std::string value;
+    };
+    std::vector<Field> fields;
+
+    void operator()(const char* name, std::int32_t value) { fields.push_back({name, std::to_string(value)}); }
+    void operator()(const char* name, std::uint32_t value) { fields.push_back({name, std::to_string(value)}); }
+    void operator()(const char* name, bool value) { fields.push_back({name, value ? "true" : "false"}); }
+    void operator()(const char* name, float value) {
+        // The bits too, since runs that differ by one ulp print alike
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof bits);
+        std::ostringstream text;
+        text << std::setprecision(9) << value << " (0x" << std::hex << std::setw(8) << std::setfill('0') << bits << ")";
+        fields.push_back({name, text.str()});
+    }
+    void operator()(const char* name, sf::Vector2f value) {
+        (*this)((std::string(name) + ".x").c_str(), value.x);
+        (*this)((std::string(name) + ".y").c_str(), value.y);
+    }
+    template <typename Enum, typename = std::enable_if_t<std::is_enum_v<Enum>>>
+    void operator()(const char* name, Enum value) {
+        (*this)(name, static_cast<std::int32_t>(value));
+    }
+};
+
+template <typename Visit>
+FieldList listFields(Visit visit) {
+    FieldList list;
+    visit(list);
+    return list;
+}
+
+// Prints the fields a and b disagree on, under label, and counts them
+void compareFields(const std::string& label, const FieldList& a, const FieldList& b, int& printed, int limit) {
+    for (std::size_t i = 0; i < std::max(a.fields.size(), b.fields.size()); ++i) {
+        const FieldList::Field* fieldA = i < a.fields.size() ? &a.fields[i] : nullptr;
+        const FieldList::Field* fieldB = i < b.fields.size() ? &b.fields[i] : nullptr;
+        if (fieldA && fieldB && fieldA->value == fieldB->value) continue;
+        if (printed++ >= limit) continue;
+        std::cout << "  " << label << " " << (fieldA ? fieldA->name : fieldB->name)
+                  << ": a=" << (fieldA ? fieldA->value : "(none)")
+                  << " b=" << (fieldB ? fieldB->value : "(none)") << "\n";
+    }
+}
+
+// Everything the two worlds' hashes were built from, side by side
+void reportDesync(const Run& a, const Run& b, int limit) {
+    int printed = 0;
+    compareFields("world", listFields([&](FieldList& list) { a.world.visitState(list); }),
+                  listFields([&](FieldList& list) { b.world.visitState(list); }), printed, limit);
+
+    for (std::size_t i = 0; i < a.inputs.size(); ++i) {
+        compareFields("input " + std::to_string(i), listFields([&](FieldList& list) { visitInput(a.inputs[i], list); }),
+                      listFields([&](FieldList& list) { visitInput(b.inputs[i], list); }), printed, limit);
+    }
+
+    const auto& playersA = a.world.getPlayers();
+    const auto& playersB = b.world.getPlayers();
+    for (std::size_t i = 0; i < std::min(playersA.size(), playersB.size()); ++i) {
+        compareFields("player " + std::to_string(playersA[i].getId()),
+                      listFields([&](FieldList& list) { playersA[i].visitState(list); }),
+                      listFields([&](FieldList& list) { playersB[i].visitState(list); }), printed, limit);
+    }
+
+    const auto& boomerangsA = a.world.getBoomerangs();
+    const auto& boomerangsB = b.world.getBoomerangs();
+    for (std::size_t i = 0; i < std::min(boomerangsA.size(), boomerangsB.size()); ++i) {
+        compareFields("boomerang " + std::to_string(i),
+                      listFields([&](FieldList& list) { boomerangsA[i].visitState(list); }),
+                      listFields([&](FieldList& list) { boomerangsB[i].visitState(list); }), printed, limit);
+    }
+
+    const auto& eventsA = a.world.getStepEvents();
+    const auto& eventsB = b.world.getStepEvents();
+    for (std::size_t i = 0; i < std::min(eventsA.size(), eventsB.size()); ++i) {
+        compareFields("event " + std::to_string(i), listFields([&](FieldList& list) { visitEvent(eventsA[i], list); }),
+                      listFields([&](FieldList& list) { visitEvent(eventsB[i], list); }), printed, limit);
+    }
+
+    if (printed == 0) {
+        // The hashes are chained, so this only happens if they were already
+        // apart before this tick's fields were added
+        std::cout << "  no field differs this tick\n";
+    } else if (printed > limit) {
+        std::cout << "  ... and " << printed - limit << " more\n";
+    }
+}
+
+// Plays match index in lockstep; false on a desync
+bool checkMatch(const Options& options, const Tuning& tuning, int index, long long& ticks) {
+    const auto& levels = builtinLevels();
+    int levelIndex = options.level >= 0 ? options.level : index % levels.size();
+    std::uint32_t seed = mixSeed(options.seed, index);
+
+    Run a(levels[levelIndex], tuning, options.players, seed, options.jobsA);
+    Run b(levels[levelIndex], tuning, options.players, seed, options.jobsB);
+    Partner partner(b);
+
+    while (a.world.getAliveCount() > 1 && a.world.getTick() < options.maxTicks) {
+        partner.startTick();
+        a.tick();
+        partner.waitTick();
+        ++ticks;
+
+        if (a.world.getStateHash() != b.world.getStateHash()) {
+            std::cout << std::hex << std::setfill('0')
+                      << "Match " << std::dec << index << " (seed 0x" << std::hex << std::setw(8) << seed
+                      << std::dec << ", arena " << levels[levelIndex].name << "): desync at tick "
+                      << a.world.getTick() - 1 << "\n"
+                      << std::hex << "  hash a=" << std::setw(16) << a.world.getStateHash()
+                      << " b=" << std::setw(16) << b.world.getStateHash() << std::dec << std::setfill(' ') << "\n";
+            reportDesync(a, b, options.fields);
+            return false;
+        }
+    }
+    return true;
+}
+
+void printUsage() {
+    std::cout << "Usage: dino_desync [options]\n"
+              << "  --matches N      matches to check (default 1)\n"
+              << "  --seed N         base seed, as for dino_batch (default 1)\n"
+              << "  --level N        play only built-in arena N (default: rotate)\n"
+              << "  --players N      bots per match (default 4)\n"
+              << "  --max-ticks N    ticks before a match is called a draw (default 5400)\n"
+              << "  --substeps N     physics substeps per tick (default 1)\n"
+              << "  --jobs-a N       job pool workers for the first run (default 0 = none)\n"
+              << "  --jobs-b N       job pool workers for the second run (default 2)\n"
+              << "  --fields N       differing fields to print at most (default 20)" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+            printUsage();
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+        std::string value = argv[++i];
+        try {
+            if (arg == "--matches") options.matches = std::stoi(value);
+            else if (arg == "--seed") options.seed = std::stoul(value);
+            else if (arg == "--level") options.level = std::stoi(value);
+            else if (arg == "--players") options.players = std::clamp(std::stoi(value), 2, World::MaxPlayers);
+            else if (arg == "--max-ticks") options.maxTicks = std::stoi(value);
+            else if (arg == "--substeps") options.substeps = std::stoi(value);
+            else if (arg == "--jobs-a") options.jobsA = std::max(0, std::stoi(value));
+            else if (arg == "--jobs-b") options.jobsB = std::max(0, std::stoi(value));
+            else if (arg == "--fields") options.fields = std::stoi(value);
+            else {
+                std::cerr << "Error: Unknown option " << arg << std::endl;
+                printUsage();
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Error: Bad value " << value << " for " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+    if (options.level >= static_cast<int>(builtinLevels().size())) {
+        std::cerr << "Error: There are only " << builtinLevels().size() << " arenas" << std::endl;
+        return 1;
+    }
+
+    Tuning tuning;
+    tuning.physicsSubsteps = options.substeps;
+
+    long long ticks = 0;
+    int desyncs = 0;
+    for (int index = 0; index < options.matches; ++index) {
+        if (!checkMatch(options, tuning, index, ticks)) ++desyncs;
+    }
+    std::cout << options.matches << " matches, " << ticks << " ticks: "
+              << (desyncs ? std::to_string(desyncs) + " desynced" : std::string("no desyncs")) << std::endl;
+    return desyncs ? 1 : 0;
+}
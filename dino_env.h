@@ -0,0 +1,98 @@
+#ifndef DINO_ENV_H
+#define DINO_ENV_H
+
+/* C interface to TrainingEnv (training_env.hpp), for trainers in other
+ * languages: build training_env.cpp and the simulation sources into a
+ * shared library and load it with ctypes, cffi or similar.
+ *
+ *   DinoEnvConfig config;
+ *   dino_env_default_config(&config);
+ *   config.envs = 256;
+ *   DinoEnv* env = dino_env_create(&config, &buffers);
+ *   dino_env_reset(env, seeds);
+ *   for (;;) dino_env_step(env, actions);   // buffers are filled in place
+ *   dino_env_destroy(env);
+ *
+ * Array sizes, all env-major and all from the config passed to create:
+ *   buffers.entities  envs * players * DINO_ENV_PLAYER_FLOATS floats
+ *   buffers.tiles     envs * DINO_ENV_TILE_BYTES bytes
+ *   buffers.rewards   envs * players floats
+ *   buffers.dones     envs bytes: 0 running, 1 decided, 2 timed out
+ *   actions           envs * players DinoEnvAction
+ * The buffers must stay valid until dino_env_destroy().
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DINO_ENV_MAX_PLAYERS 16
+#define DINO_ENV_MAX_SUBSTEPS 8
+
+/* Observation floats per player slot: its dino, then its boomerang */
+#define DINO_ENV_PLAYER_FEATURES 12
+#define DINO_ENV_BOOMERANG_FEATURES 8
+#define DINO_ENV_PLAYER_FLOATS (DINO_ENV_PLAYER_FEATURES + DINO_ENV_BOOMERANG_FEATURES)
+
+/* Arena cells, row by row */
+#define DINO_ENV_TILE_BYTES (14 * 20)
+
+typedef struct DinoEnv DinoEnv;
+
+/* Out-of-range values are never adjusted; dino_env_create() refuses them */
+typedef struct {
+    int envs;               /* At least 1 */
+    int players;            /* 2 to DINO_ENV_MAX_PLAYERS */
+    int bots;               /* The last this many slots are played by built-in bots, 0 to players */
+    int level;              /* Built-in arena below dino_env_level_count(), or -1 to pick one per episode */
+    int max_ticks;          /* At least 1 */
+    unsigned int threads;   /* 0 = one per hardware thread */
+    int physics_substeps;   /* 1 to DINO_ENV_MAX_SUBSTEPS */
+    float kill_reward;
+    float death_reward;
+} DinoEnvConfig;
+
+/* One player's controls for one tick, as a controller would give them */
+typedef struct {
+    uint8_t left;
+    uint8_t right;
+    uint8_t jump;
+    uint8_t dash;
+    uint8_t throw_pressed;
+    float aim_x;            /* Normalized; 0,0 keeps the last aim */
+    float aim_y;
+} DinoEnvAction;
+
+typedef struct {
+    float* entities;
+    uint8_t* tiles;
+    float* rewards;
+    uint8_t* dones;
+} DinoEnvBuffers;
+
+void dino_env_default_config(DinoEnvConfig* config);
+
+/* Returns NULL, without writing to the buffers, when the config is out of
+ * range or creation fails. Otherwise every env has already been reset, env k
+ * from seed k. */
+DinoEnv* dino_env_create(const DinoEnvConfig* config, const DinoEnvBuffers* buffers);
+void dino_env_destroy(DinoEnv* env);
+
+int dino_env_count(const DinoEnv* env);
+int dino_env_players(const DinoEnv* env);
+size_t dino_env_entity_floats(const DinoEnv* env);
+size_t dino_env_tile_bytes(void);
+int dino_env_level_count(void);
+
+/* seeds: one per env */
+void dino_env_reset(DinoEnv* env, const uint32_t* seeds);
+void dino_env_step(DinoEnv* env, const DinoEnvAction* actions);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
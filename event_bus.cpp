@@ -0,0 +1,67 @@
+#include "event_bus.hpp"
+#include <chrono>
+#include <iostream>
+
+EventBus::EventBus()
+    : m_subscriberCount(0)
+    , m_dropped(0)
+{
+}
+
+EventBus::Queue* EventBus::subscribe() {
+    int index = m_subscriberCount.load(std::memory_order_relaxed);
+    if (index >= MaxSubscribers) return nullptr;
+    m_queues[index] = std::make_unique<Queue>();
+    // Publish the queue before the publisher can see the new count
+    m_subscriberCount.store(index + 1, std::memory_order_release);
+    return m_queues[index].get();
+}
+
+void EventBus::publish(const GameEvent& event) {
+    int count = m_subscriberCount.load(std::memory_order_acquire);
+    for (int i = 0; i < count; ++i) {
+        if (!m_queues[i]->tryPush(event)) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+std::uint64_t EventBus::getDroppedCount() const {
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+EventListener::EventListener(EventBus& bus, std::function<void(const GameEvent&)> handler)
+    : m_queue(bus.subscribe())
+    , m_handler(std::move(handler))
+    , m_running(true)
+{
+    if (!m_queue) {
+        std::cerr << "Error: Too many event listeners!" << std::endl;
+        m_running = false;
+        return;
+    }
+    m_thread = std::thread(&EventListener::run, this);
+}
+
+EventListener::~EventListener() {
+    m_running = false;
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void EventListener::run() {
+    GameEvent event;
+    while (true) {
+        // Stop only once the queue is empty so nothing published before
+        // shutdown is lost
+        bool running = m_running.load(std::memory_order_acquire);
+        bool drained = true;
+        while (m_queue->tryPop(event)) {
+            m_handler(event);
+            drained = false;
+        }
+        if (!running) break;
+        // A tick is ~16 ms, so polling every millisecond keeps consumers
+        // well ahead of the game without a wakeup from the producer
+        if (drained) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
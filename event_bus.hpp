@@ -0,0 +1,93 @@
+#ifndef EVENT_BUS_HPP
+#define EVENT_BUS_HPP
+
+#include <SFML/System.hpp>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include "spsc_queue.hpp"
+
+// Something that happened in the simulation. Plain data so it can be copied
+// into a ring buffer without allocating.
+struct GameEvent {
+    enum class Type : std::uint8_t {
+        Throw,      // actor threw a boomerang; vector = launch velocity
+        Bounce,     // actor's boomerang hit a tile; vector = velocity after the bounce
+        Catch,      // actor caught their own boomerang
+        Kill,       // actor's boomerang killed target; cause = boomerang state
+        Dash        // actor started a dash; vector = dash direction
+    };
+
+    Type type;
+    std::uint8_t cause;         // Boomerang::State for kills, 0 otherwise
+    int tick;
+    int actorId;
+    int targetId;               // -1 when there is no second player involved
+    sf::Vector2f position;
+    sf::Vector2f vector;
+};
+
+// Calls visit(name, value) for each field of event, in a fixed order; see
+// Player::visitState
+template <typename Visitor>
+void visitEvent(const GameEvent& event, Visitor& visit) {
+    visit("type", event.type);
+    visit("cause", static_cast<std::int32_t>(event.cause));
+    visit("tick", event.tick);
+    visit("actorId", event.actorId);
+    visit("targetId", event.targetId);
+    visit("position", event.position);
+    visit("vector", event.vector);
+}
+
+// Fans simulation events out to consumers running on their own threads.
+// The simulation thread is the single producer: publish() copies the event
+// into one bounded lock-free ring per subscriber and never blocks or
+// allocates. A consumer that falls behind loses events (counted in
+// getDroppedCount) instead of stalling the game.
+class EventBus {
+public:
+    static constexpr std::size_t QueueCapacity = 1024;
+    static constexpr int MaxSubscribers = 8;
+    using Queue = SpscQueue<GameEvent, QueueCapacity>;
+
+    EventBus();
+
+    // Creates a queue for a new consumer. Call from the thread that owns the
+    // bus (not from consumers); returns nullptr when all slots are taken.
+    Queue* subscribe();
+
+    // Simulation thread only
+    void publish(const GameEvent& event);
+
+    std::uint64_t getDroppedCount() const;
+
+private:
+    std::array<std::unique_ptr<Queue>, MaxSubscribers> m_queues;
+    std::atomic<int> m_subscriberCount;
+    std::atomic<std::uint64_t> m_dropped;
+};
+
+// Drains one subscription on a background thread and hands each event to a
+// callback, e.g. stats, audio or a kill feed
+class EventListener {
+public:
+    EventListener(EventBus& bus, std::function<void(const GameEvent&)> handler);
+    ~EventListener();
+
+    EventListener(const EventListener&) = delete;
+    EventListener& operator=(const EventListener&) = delete;
+
+private:
+    void run();
+
+    EventBus::Queue* m_queue;
+    std::function<void(const GameEvent&)> m_handler;
+    std::atomic<bool> m_running;
+    std::thread m_thread;
+};
+
+#endif
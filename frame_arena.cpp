@@ -0,0 +1,53 @@
+#include "frame_arena.hpp"
+#include <algorithm>
+#include <cstdint>
+
+FrameArena::FrameArena(std::size_t capacity)
+    : m_current(0)
+    , m_offset(0)
+    , m_used(0)
+    , m_highWater(0)
+{
+    m_blocks.reserve(8);
+    m_blocks.push_back({std::make_unique<unsigned char[]>(capacity), capacity});
+}
+
+void* FrameArena::allocate(std::size_t bytes, std::size_t alignment) {
+    Block* block = &m_blocks[m_current];
+    auto base = reinterpret_cast<std::uintptr_t>(block->memory.get());
+    std::size_t start = (base + m_offset + alignment - 1) / alignment * alignment - base;
+
+    while (start + bytes > block->size) {
+        // Move on to the next block kept from an earlier tick, or chain one
+        // big enough for this and then some
+        if (m_current + 1 == m_blocks.size()) {
+            std::size_t size = std::max(block->size * 2, bytes + alignment);
+            m_blocks.push_back({std::make_unique<unsigned char[]>(size), size});
+        }
+        block = &m_blocks[++m_current];
+        base = reinterpret_cast<std::uintptr_t>(block->memory.get());
+        m_offset = 0;
+        start = (base + alignment - 1) / alignment * alignment - base;
+    }
+
+    m_used += start + bytes - m_offset;
+    m_offset = start + bytes;
+    m_highWater = std::max(m_highWater, m_used);
+    return block->memory.get() + start;
+}
+
+void FrameArena::reset() {
+    m_current = 0;
+    m_offset = 0;
+    m_used = 0;
+}
+
+std::size_t FrameArena::getUsed() const { return m_used; }
+
+std::size_t FrameArena::getCapacity() const {
+    std::size_t capacity = 0;
+    for (const auto& block : m_blocks) capacity += block.size;
+    return capacity;
+}
+
+std::size_t FrameArena::getHighWater() const { return m_highWater; }
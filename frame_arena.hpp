@@ -0,0 +1,59 @@
+#ifndef FRAME_ARENA_HPP
+#define FRAME_ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// Bump allocator for data that only lives until the end of a tick. Memory
+// is handed out by moving a pointer along a block and given back all at once
+// by reset(), so nothing is freed one piece at a time and nothing calls the
+// heap once the arena has grown to the largest tick it has seen.
+//
+// Running out of room chains on another block. Blocks are kept across
+// reset(), which only rewinds to the first one and never touches the heap,
+// so a tick that overflowed costs an allocation once and later ticks reuse
+// the chain. Size the arena for the busiest tick up front to avoid even
+// that. Only trivially destructible types can live here, since nothing is
+// destroyed. Not thread safe: one arena per thread that uses it.
+class FrameArena {
+public:
+    explicit FrameArena(std::size_t capacity = 16 * 1024);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+
+    // count default-initialised Ts, valid until the next reset()
+    template <typename T>
+    T* allocateArray(std::size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena memory is never destroyed");
+        T* items = static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+        for (std::size_t i = 0; i < count; ++i) new (items + i) T();
+        return items;
+    }
+
+    // Frees everything allocated since the last reset. Allocation-free.
+    void reset();
+
+    std::size_t getUsed() const;        // Bytes handed out since the last reset
+    std::size_t getCapacity() const;
+    std::size_t getHighWater() const;   // Most bytes in use at once
+
+private:
+    struct Block {
+        std::unique_ptr<unsigned char[]> memory;
+        std::size_t size;
+    };
+
+    std::vector<Block> m_blocks;
+    std::size_t m_current;          // The block being filled
+    std::size_t m_offset;           // Into the current block
+    std::size_t m_used;
+    std::size_t m_highWater;
+};
+
+#endif
@@ -0,0 +1,154 @@
+#include "frame_pacer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+using namespace std::chrono;
+
+FramePacer::FramePacer(Mode mode, float framesPerSecond)
+    : m_mode(mode)
+    , m_period(duration_cast<Clock::duration>(duration<double>(1.0 / std::max(framesPerSecond, 1.f))))
+    , m_started(false)
+    , m_sleepMargin(microseconds(1500))
+    , m_sum(0.0)
+    , m_sumSquares(0.0)
+{
+}
+
+void FramePacer::apply(sf::Window& window) const {
+    window.setVerticalSyncEnabled(m_mode == Mode::VSync);
+    window.setFramerateLimit(0);
+}
+
+void FramePacer::waitUntil(Clock::time_point deadline) {
+    // Sleep for the bulk of the wait, then spin. Oversleeping eats into the
+    // margin; grow it quickly when that happens and shrink it slowly
+    Clock::time_point wakeTarget = deadline - m_sleepMargin;
+    Clock::time_point now = Clock::now();
+    if (wakeTarget > now) {
+        std::this_thread::sleep_until(wakeTarget);
+        Clock::duration overshoot = Clock::now() - wakeTarget;
+        Clock::duration wanted = overshoot + microseconds(250);
+        if (wanted > m_sleepMargin) m_sleepMargin = wanted;
+        else m_sleepMargin -= (m_sleepMargin - wanted) / 64;
+        m_sleepMargin = std::clamp<Clock::duration>(m_sleepMargin, microseconds(250), milliseconds(4));
+    }
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+void FramePacer::endFrame() {
+    Clock::time_point now = Clock::now();
+    if (!m_started) {
+        m_started = true;
+        m_lastFrame = now;
+        m_deadline = now + m_period;
+        return;
+    }
+
+    if (m_mode == Mode::Hybrid) {
+        if (now > m_deadline + m_period / 2) {
+            // Too late to catch up: count what was missed and start over
+            m_stats.droppedFrames += 1 + (now - m_deadline - m_period / 2) / m_period;
+            m_deadline = now + m_period;
+        } else {
+            waitUntil(m_deadline);
+            m_deadline += m_period;
+        }
+        now = Clock::now();
+    } else if (m_mode == Mode::VSync) {
+        if (now - m_lastFrame > m_period * 3 / 2) {
+            m_stats.droppedFrames += (now - m_lastFrame - m_period / 2) / m_period;
+        }
+    }
+
+    record(duration<double, std::milli>(now - m_lastFrame).count());
+    m_lastFrame = now;
+}
+
+void FramePacer::record(double frameMs) {
+    if (m_stats.frames == 0) {
+        m_stats.minMs = frameMs;
+        m_stats.maxMs = frameMs;
+    }
+    ++m_stats.frames;
+    m_stats.minMs = std::min(m_stats.minMs, frameMs);
+    m_stats.maxMs = std::max(m_stats.maxMs, frameMs);
+    m_sum += frameMs;
+    m_sumSquares += frameMs * frameMs;
+    m_stats.meanMs = m_sum / m_stats.frames;
+    m_stats.jitterMs = std::sqrt(std::max(0.0, m_sumSquares / m_stats.frames - m_stats.meanMs * m_stats.meanMs));
+
+    int bucket = std::min(static_cast<int>(frameMs / BucketMilliseconds), HistogramBuckets - 1);
+    ++m_stats.histogram[bucket];
+
+    // Percentiles from the histogram, to bucket resolution
+    auto percentile = [this](double fraction) {
+        std::uint64_t wanted = static_cast<std::uint64_t>(std::ceil(m_stats.frames * fraction));
+        std::uint64_t seen = 0;
+        for (int i = 0; i < HistogramBuckets; ++i) {
+            seen += m_stats.histogram[i];
+            if (seen >= wanted) return (i + 1) * double(BucketMilliseconds);
+        }
+        return HistogramBuckets * double(BucketMilliseconds);
+    };
+    m_stats.p50Ms = percentile(0.5);
+    m_stats.p99Ms = percentile(0.99);
+}
+
+FramePacer::Mode FramePacer::getMode() const { return m_mode; }
+const FramePacer::Stats& FramePacer::getStats() const { return m_stats; }
+
+void FramePacer::resetStats() {
+    m_stats = Stats();
+    m_sum = 0.0;
+    m_sumSquares = 0.0;
+}
+
+void FramePacer::draw(sf::RenderTarget& target, sf::Vector2f position) const {
+    const float height = 40.f;
+    const int shownBuckets = 160;   // Up to 40 ms
+
+    sf::RectangleShape background({shownBuckets + 8.f, height + 8.f});
+    background.setPosition(position - sf::Vector2f(4.f, 4.f));
+    background.setFillColor(sf::Color(0, 0, 0, 160));
+    target.draw(background);
+
+    std::uint32_t peak = 1;
+    for (int i = 0; i < shownBuckets; ++i) peak = std::max(peak, m_stats.histogram[i]);
+
+    sf::RectangleShape bar;
+    bar.setFillColor(sf::Color::Cyan);
+    for (int i = 0; i < shownBuckets; ++i) {
+        if (m_stats.histogram[i] == 0) continue;
+        // Square root scale so rare slow frames still show up
+        float barHeight = std::max(1.f, height * std::sqrt(float(m_stats.histogram[i]) / peak));
+        bar.setSize({1.f, barHeight});
+        bar.setPosition(position + sf::Vector2f(float(i), height - barHeight));
+        target.draw(bar);
+    }
+
+    float targetMs = duration<float, std::milli>(m_period).count();
+    sf::RectangleShape mark({1.f, height});
+    mark.setPosition(position + sf::Vector2f(targetMs / BucketMilliseconds, 0.f));
+    mark.setFillColor(sf::Color(255, 255, 255, 180));
+    target.draw(mark);
+}
+
+bool FramePacer::parseMode(const std::string& text, Mode& mode) {
+    if (text == "vsync") mode = Mode::VSync;
+    else if (text == "hybrid") mode = Mode::Hybrid;
+    else if (text == "uncapped") mode = Mode::Uncapped;
+    else return false;
+    return true;
+}
+
+const char* FramePacer::modeName(Mode mode) {
+    switch (mode) {
+        case Mode::VSync: return "vsync";
+        case Mode::Hybrid: return "hybrid";
+        case Mode::Uncapped: return "uncapped";
+    }
+    return "";
+}
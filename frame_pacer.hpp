@@ -0,0 +1,77 @@
+#ifndef FRAME_PACER_HPP
+#define FRAME_PACER_HPP
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Decides when the next frame starts and keeps statistics on how evenly
+// frames actually arrive. Call endFrame() right after window.display().
+//
+//   VSync     the driver blocks in display(); the pacer only measures
+//   Hybrid    sleeps until shortly before the deadline, then spins on the
+//             clock for the rest. The sleep margin adapts to how much the
+//             OS oversleeps, so it stays tight without missing deadlines.
+//   Uncapped  no waiting at all
+class FramePacer {
+public:
+    enum class Mode {
+        VSync,
+        Hybrid,
+        Uncapped
+    };
+
+    static constexpr int HistogramBuckets = 200;            // Last bucket holds everything slower
+    static constexpr float BucketMilliseconds = 0.25f;
+
+    struct Stats {
+        std::uint64_t frames = 0;
+        std::uint64_t droppedFrames = 0;    // Deadlines missed by more than half a frame
+        double meanMs = 0.0;
+        double jitterMs = 0.0;              // Standard deviation of the frame time
+        double minMs = 0.0;
+        double maxMs = 0.0;
+        double p50Ms = 0.0;
+        double p99Ms = 0.0;
+        std::array<std::uint32_t, HistogramBuckets> histogram{};
+    };
+
+    FramePacer(Mode mode, float framesPerSecond);
+
+    // Turns the window's vsync on or off to match the mode. Call from the
+    // thread that owns the window's context.
+    void apply(sf::Window& window) const;
+
+    void endFrame();
+
+    Mode getMode() const;
+    const Stats& getStats() const;
+    void resetStats();
+
+    // The histogram as bars, with a line at the target frame time
+    void draw(sf::RenderTarget& target, sf::Vector2f position) const;
+
+    static bool parseMode(const std::string& text, Mode& mode);
+    static const char* modeName(Mode mode);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void waitUntil(Clock::time_point deadline);
+    void record(double frameMs);
+
+    Mode m_mode;
+    Clock::duration m_period;
+    Clock::time_point m_deadline;
+    Clock::time_point m_lastFrame;
+    bool m_started;
+    Clock::duration m_sleepMargin;      // How early to stop sleeping and start spinning
+
+    Stats m_stats;
+    double m_sum;
+    double m_sumSquares;
+};
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef GAME_STATE_HPP
+#define GAME_STATE_HPP
+
+enum class GameState {
+    MainMenu,
+    Gameplay,
+    GameOver,
+    Replay      // Killcam of the final kill, shown before GameOver
+};
+
+#endif
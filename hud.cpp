@@ -0,0 +1,167 @@
+#include "hud.hpp"
+#include "player_slots.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+bool Hud::Shown::operator==(const Shown& other) const {
+    return visible == other.visible && scoreCount == other.scoreCount && kills == other.kills &&
+           wins == other.wins && seconds == other.seconds && frameTimes == other.frameTimes &&
+           fps == other.fps && frameTenthsMs == other.frameTenthsMs;
+}
+
+Hud::Hud(sf::Vector2u canvasSize)
+    : m_canvasSize(canvasSize)
+    , m_loaded(false)
+    , m_atlas(nullptr)
+    , m_vertexCount(0)
+    , m_showFrameTimes(false)
+    , m_sampleSeconds(0.f)
+    , m_sampleFrames(0)
+    , m_fps(0)
+    , m_frameTenthsMs(0)
+    , m_rebuilds(0)
+{
+    if (!m_font.openFromFile("DejaVuSans.ttf")) {
+        std::cerr << "Error: Could not load DejaVuSans.ttf; the HUD is off" << std::endl;
+        return;
+    }
+
+    // Rasterize the whole printable range up front so the atlas never has
+    // to grow (and its texture never changes) while the game is running
+    for (char c = FirstCharacter; c <= LastCharacter; ++c) {
+        const sf::Glyph& glyph = m_font.getGlyph(static_cast<char32_t>(c), CharacterSize, false);
+        GlyphQuad& quad = m_glyphs[c - FirstCharacter];
+        quad.advance = glyph.advance;
+        quad.bounds = glyph.bounds;
+        quad.textureRect = glyph.textureRect;
+    }
+    m_atlas = &m_font.getTexture(CharacterSize);
+    m_loaded = true;
+}
+
+void Hud::setShowFrameTimes(bool show) { m_showFrameTimes = show; }
+bool Hud::isShowingFrameTimes() const { return m_showFrameTimes; }
+int Hud::getRebuildCount() const { return m_rebuilds; }
+
+void Hud::update(const RenderSnapshot& snapshot, float frameSeconds) {
+    if (!m_loaded) return;
+
+    // The readout changes four times a second so it can be read at all
+    m_sampleSeconds += frameSeconds;
+    ++m_sampleFrames;
+    if (m_sampleSeconds >= 0.25f) {
+        m_fps = static_cast<int>(std::lround(m_sampleFrames / m_sampleSeconds));
+        m_frameTenthsMs = static_cast<int>(std::lround(m_sampleSeconds / m_sampleFrames * 10000.f));
+        m_sampleSeconds = 0.f;
+        m_sampleFrames = 0;
+    }
+
+    Shown shown;
+    shown.visible = snapshot.gameState != GameState::MainMenu;
+    shown.scoreCount = std::min(snapshot.scoreCount, RenderSnapshot::MaxPlayers);
+    shown.kills = snapshot.kills;
+    shown.wins = snapshot.wins;
+    shown.seconds = snapshot.matchTicks / 60;
+    shown.frameTimes = m_showFrameTimes;
+    if (m_showFrameTimes) {
+        shown.fps = m_fps;
+        shown.frameTenthsMs = m_frameTenthsMs;
+    }
+
+    if (shown == m_shown && m_rebuilds > 0) return;
+    m_shown = shown;
+    rebuild();
+}
+
+void Hud::rebuild() {
+    ++m_rebuilds;
+    m_vertexCount = 0;
+    if (!m_shown.visible) return;
+
+    const float margin = 10.f;
+    float top = margin + CharacterSize;     // Baseline of the score line
+    char text[32];
+
+    // Scores from the left, one block per player, wrapping onto more lines
+    // in big matches
+    float x = margin;
+    for (int id = 0; id < m_shown.scoreCount; ++id) {
+        std::snprintf(text, sizeof(text), "P%d  K %d  W %d", id + 1, m_shown.kills[id], m_shown.wins[id]);
+        float width = textWidth(text);
+        if (x > margin && x + width > m_canvasSize.x - margin) {
+            x = margin;
+            top += CharacterSize + margin / 2.f;
+        }
+        addText(text, {x, top}, playerColor(id));
+        x += width + 2.f * margin;
+    }
+
+    // Match clock in the middle, under the scores
+    std::snprintf(text, sizeof(text), "%d:%02d", m_shown.seconds / 60, m_shown.seconds % 60);
+    addText(text, {std::round((m_canvasSize.x - textWidth(text)) / 2.f), top + CharacterSize + margin / 2.f},
+            sf::Color::White);
+
+    if (m_shown.frameTimes) {
+        std::snprintf(text, sizeof(text), "%d FPS  %d.%d ms", m_shown.fps, m_shown.frameTenthsMs / 10,
+                      m_shown.frameTenthsMs % 10);
+        addText(text, {m_canvasSize.x - margin - textWidth(text), m_canvasSize.y - margin}, sf::Color::Yellow);
+    }
+}
+
+float Hud::textWidth(const char* text) const {
+    float width = 0.f;
+    for (; *text; ++text) {
+        if (*text < FirstCharacter || *text > LastCharacter) continue;
+        width += m_glyphs[*text - FirstCharacter].advance;
+    }
+    return width;
+}
+
+void Hud::addText(const char* text, sf::Vector2f position, sf::Color color) {
+    // A dark copy one pixel down and right first, so it sits under the text
+    for (int pass = 0; pass < 2; ++pass) {
+        bool shadow = pass == 0;
+        sf::Vector2f pen = shadow ? position + sf::Vector2f(1.f, 1.f) : position;
+        for (const char* c = text; *c; ++c) {
+            if (*c < FirstCharacter || *c > LastCharacter) continue;
+            const GlyphQuad& glyph = m_glyphs[*c - FirstCharacter];
+            addQuad(glyph, pen, shadow ? sf::Color(0, 0, 0, 160) : color);
+            pen.x += glyph.advance;
+        }
+    }
+}
+
+void Hud::addQuad(const GlyphQuad& glyph, sf::Vector2f pen, sf::Color color) {
+    if (glyph.textureRect.size.x == 0 || m_vertexCount + 6 > MaxVertices) return;
+
+    // Same quad as sf::Text: one pixel of padding round the glyph so
+    // smoothing doesn't cut off its edges
+    const float padding = 1.f;
+    float left = pen.x + glyph.bounds.position.x - padding;
+    float top = pen.y + glyph.bounds.position.y - padding;
+    float right = pen.x + glyph.bounds.position.x + glyph.bounds.size.x + padding;
+    float bottom = pen.y + glyph.bounds.position.y + glyph.bounds.size.y + padding;
+
+    float u1 = glyph.textureRect.position.x - padding;
+    float v1 = glyph.textureRect.position.y - padding;
+    float u2 = glyph.textureRect.position.x + glyph.textureRect.size.x + padding;
+    float v2 = glyph.textureRect.position.y + glyph.textureRect.size.y + padding;
+
+    sf::Vertex* v = &m_vertices[m_vertexCount];
+    v[0] = {{left, top}, color, {u1, v1}};
+    v[1] = {{right, top}, color, {u2, v1}};
+    v[2] = {{left, bottom}, color, {u1, v2}};
+    v[3] = {{left, bottom}, color, {u1, v2}};
+    v[4] = {{right, top}, color, {u2, v1}};
+    v[5] = {{right, bottom}, color, {u2, v2}};
+    m_vertexCount += 6;
+}
+
+void Hud::draw(sf::RenderTarget& target) const {
+    if (m_vertexCount == 0) return;
+    sf::RenderStates states;
+    states.texture = m_atlas;
+    target.draw(m_vertices.data(), m_vertexCount, sf::PrimitiveType::Triangles, states);
+}
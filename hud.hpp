@@ -0,0 +1,81 @@
+#ifndef HUD_HPP
+#define HUD_HPP
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include "render_snapshot.hpp"
+
+// Kill and win counts, the match clock and an optional frame rate readout,
+// drawn over the arena.
+//
+// Every character the HUD can show is rasterized once, when it is created,
+// into the font's glyph atlas at a single size. The text is a plain triangle
+// list into that atlas, shadows included, rebuilt only when a number on
+// screen changes, so the HUD costs one draw call a frame and never
+// allocates after construction.
+class Hud {
+public:
+    static constexpr unsigned int CharacterSize = 18;
+
+    // Loads DejaVuSans.ttf; without it the HUD draws nothing
+    explicit Hud(sf::Vector2u canvasSize);
+
+    void setShowFrameTimes(bool show);
+    bool isShowingFrameTimes() const;
+
+    // Call once per rendered frame
+    void update(const RenderSnapshot& snapshot, float frameSeconds);
+    void draw(sf::RenderTarget& target) const;
+
+    int getRebuildCount() const;    // Times the text was laid out again
+
+private:
+    // What is on screen; the text is rebuilt when this changes
+    struct Shown {
+        bool visible = false;
+        int scoreCount = 0;
+        std::array<std::uint8_t, RenderSnapshot::MaxPlayers> kills{};
+        std::array<std::uint8_t, RenderSnapshot::MaxPlayers> wins{};
+        int seconds = 0;
+        bool frameTimes = false;
+        int fps = 0;
+        int frameTenthsMs = 0;      // Frame time in tenths of a millisecond
+
+        bool operator==(const Shown& other) const;
+    };
+
+    struct GlyphQuad {
+        float advance = 0.f;
+        sf::FloatRect bounds;       // Relative to the pen on the baseline
+        sf::IntRect textureRect;
+    };
+
+    void rebuild();
+    float textWidth(const char* text) const;
+    void addText(const char* text, sf::Vector2f position, sf::Color color);
+    void addQuad(const GlyphQuad& glyph, sf::Vector2f pen, sf::Color color);
+
+    static constexpr char FirstCharacter = ' ';
+    static constexpr char LastCharacter = '~';
+    static constexpr std::size_t MaxVertices = 6 * 2 * 320;    // 320 characters with shadows
+
+    sf::Vector2u m_canvasSize;
+    sf::Font m_font;
+    bool m_loaded;
+    const sf::Texture* m_atlas;
+    std::array<GlyphQuad, LastCharacter - FirstCharacter + 1> m_glyphs;
+
+    std::array<sf::Vertex, MaxVertices> m_vertices;
+    std::size_t m_vertexCount;
+
+    Shown m_shown;
+    bool m_showFrameTimes;
+    float m_sampleSeconds;          // Frame times are averaged over a quarter second
+    int m_sampleFrames;
+    int m_fps;
+    int m_frameTenthsMs;
+    int m_rebuilds;
+};
+
+#endif
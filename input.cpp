@@ -0,0 +1,56 @@
+#include "input.hpp"
+#include <cmath>
+
+static sf::Vector2f bnormalize(const sf::Vector2f& source) {
+    float length = std::sqrt(source.x * source.x + source.y * source.y);
+    if (length != 0) return {source.x / length, source.y / length};
+    return source;
+}
+
+PlayerInput readPlayerInput(int controllerId) {
+    PlayerInput input;
+
+    if (controllerId != -1) { // -1 will be our code for "keyboard"
+        if (!sf::Joystick::isConnected(controllerId)) return input;
+
+        // --- Joystick Input ---
+        float xAxis = sf::Joystick::getAxisPosition(controllerId, sf::Joystick::Axis::X);
+        if (xAxis < -50) input.left = true;
+        if (xAxis > 50) input.right = true;
+        // PS4/PS5 Cross button is typically button 0 on Mac/Linux
+        if (sf::Joystick::isButtonPressed(controllerId, 1)) input.jump = true;
+        // PS4/PS5 Square button is typically button 3
+        if (sf::Joystick::isButtonPressed(controllerId, 0)) input.dash = true;
+
+        // Get aim direction from right stick (using Z and R axes)
+        float rightX = sf::Joystick::getAxisPosition(controllerId, sf::Joystick::Axis::Z);
+        float rightY = sf::Joystick::getAxisPosition(controllerId, sf::Joystick::Axis::R);
+
+        // Apply deadzone but still pass the direction if outside deadzone
+        const float deadZone = 25.0f;
+        if (std::abs(rightX) > deadZone || std::abs(rightY) > deadZone) {
+            input.aim = bnormalize({rightX, rightY});
+        }
+        // If inside deadzone, aim stays {0,0} and player keeps last direction
+
+        // Check throw button state (R1)
+        input.throwPressed = sf::Joystick::isButtonPressed(controllerId, 5);
+    } else {
+        // --- Keyboard Input (Player 1 Fallback) ---
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A)) input.left = true;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D)) input.right = true;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W)) input.jump = true;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Space)) input.dash = true;
+    }
+
+    return input;
+}
+
+bool inputChanged(const PlayerInput& before, const PlayerInput& after) {
+    if (before.left != after.left || before.right != after.right || before.jump != after.jump ||
+        before.dash != after.dash || before.throwPressed != after.throwPressed) {
+        return true;
+    }
+    sf::Vector2f aimDelta = after.aim - before.aim;
+    return aimDelta.x * aimDelta.x + aimDelta.y * aimDelta.y > 0.25f * 0.25f;
+}
@@ -0,0 +1,36 @@
+#ifndef INPUT_HPP
+#define INPUT_HPP
+
+#include <SFML/Graphics.hpp>
+
+// One tick worth of controls for a single player. Filled from a controller
+// (or the keyboard fallback) by readPlayerInput, or directly by a bot.
+struct PlayerInput {
+    bool left = false;
+    bool right = false;
+    bool jump = false;
+    bool dash = false;
+    bool throwPressed = false;
+    sf::Vector2f aim = {0.f, 0.f};  // Normalized, {0,0} keeps the last aim direction
+};
+
+// Calls visit(name, value) for each control, in a fixed order; see
+// Player::visitState
+template <typename Visitor>
+void visitInput(const PlayerInput& input, Visitor& visit) {
+    visit("left", input.left);
+    visit("right", input.right);
+    visit("jump", input.jump);
+    visit("dash", input.dash);
+    visit("throwPressed", input.throwPressed);
+    visit("aim", input.aim);
+}
+
+// Samples the current hardware state for a controller id (-1 = keyboard)
+PlayerInput readPlayerInput(int controllerId);
+
+// True when a button differs or the aim has swung noticeably. Stick noise
+// alone doesn't count.
+bool inputChanged(const PlayerInput& before, const PlayerInput& after);
+
+#endif
@@ -0,0 +1,146 @@
+#include "killcam.hpp"
+#include "world.hpp"
+#include <algorithm>
+#include <cmath>
+
+static std::int16_t packPosition(float value) {
+    return static_cast<std::int16_t>(std::clamp(std::lround(value * 4.f), -32768L, 32767L));
+}
+
+ReplayBuffer::ReplayBuffer()
+    : m_frames()
+    , m_newest(Capacity - 1)
+    , m_count(0)
+{
+}
+
+void ReplayBuffer::clear() {
+    m_newest = Capacity - 1;
+    m_count = 0;
+}
+
+void ReplayBuffer::record(const World& world) {
+    m_newest = (m_newest + 1) % Capacity;
+    m_count = std::min(m_count + 1, Capacity);
+    ReplayFrame& frame = m_frames[m_newest];
+    frame.tick = world.getTick();
+
+    frame.playerCount = 0;
+    for (const auto& player : world.getPlayers()) {
+        if (frame.playerCount == RenderSnapshot::MaxPlayers) break;
+        ReplayFrame::Player& packed = frame.players[frame.playerCount++];
+        packed.x = packPosition(player.getPosition().x);
+        packed.y = packPosition(player.getPosition().y);
+        packed.id = static_cast<std::uint8_t>(player.getId());
+        packed.frame = static_cast<std::uint8_t>(player.getAnimationFrame());
+        packed.state = static_cast<std::uint8_t>(player.getState());
+        packed.flags = (player.isFacingRight() ? ReplayFrame::FacingRight : 0) |
+                       (player.isAlive() ? ReplayFrame::Alive : 0);
+    }
+
+    frame.boomerangCount = 0;
+    for (const auto& boomerang : world.getBoomerangs()) {
+        if (boomerang.getState() == Boomerang::State::Caught) continue;
+        if (frame.boomerangCount == RenderSnapshot::MaxBoomerangs) break;
+        ReplayFrame::Boomerang& packed = frame.boomerangs[frame.boomerangCount++];
+        packed.x = packPosition(boomerang.getPosition().x);
+        packed.y = packPosition(boomerang.getPosition().y);
+        packed.rotation = static_cast<std::uint16_t>(std::lround(boomerang.getRotation() * 100.f) % 36000);
+        packed.ownerId = static_cast<std::uint8_t>(boomerang.getOwnerId());
+        packed.state = static_cast<std::uint8_t>(boomerang.getState());
+    }
+}
+
+std::uint64_t ReplayBuffer::getOldestTick() const { return m_frames[(m_newest - m_count + 1 + Capacity) % Capacity].tick; }
+std::uint64_t ReplayBuffer::getNewestTick() const { return m_frames[m_newest].tick; }
+bool ReplayBuffer::isEmpty() const { return m_count == 0; }
+
+bool ReplayBuffer::expand(std::uint64_t tick, RenderSnapshot& snapshot) const {
+    if (m_count == 0 || tick > getNewestTick()) return false;
+    std::uint64_t age = getNewestTick() - tick;
+    if (age >= static_cast<std::uint64_t>(m_count)) return false;
+    const ReplayFrame& frame = m_frames[(m_newest - static_cast<int>(age) + Capacity) % Capacity];
+
+    snapshot.tick = frame.tick;
+    snapshot.playerCount = frame.playerCount;
+    for (int i = 0; i < frame.playerCount; ++i) {
+        const ReplayFrame::Player& packed = frame.players[i];
+        RenderSnapshot::PlayerView& view = snapshot.players[i];
+        view = RenderSnapshot::PlayerView();
+        view.position = {packed.x / 4.f, packed.y / 4.f};
+        view.id = packed.id;
+        view.frame = packed.frame;
+        view.state = packed.state;
+        view.facingRight = packed.flags & ReplayFrame::FacingRight;
+        view.alive = packed.flags & ReplayFrame::Alive;
+        view.chargingThrow = false;     // No aim lines in replays
+    }
+
+    snapshot.boomerangCount = frame.boomerangCount;
+    for (int i = 0; i < frame.boomerangCount; ++i) {
+        const ReplayFrame::Boomerang& packed = frame.boomerangs[i];
+        RenderSnapshot::BoomerangView& view = snapshot.boomerangs[i];
+        view.position = {packed.x / 4.f, packed.y / 4.f};
+        view.rotation = packed.rotation / 100.f;
+        view.ownerId = packed.ownerId;
+        view.state = packed.state;
+    }
+    return true;
+}
+
+KillcamPresenter::KillcamPresenter()
+    : m_buffer(nullptr)
+    , m_focusTick(0)
+    , m_lastTick(0)
+    , m_position(0.0)
+    , m_playing(false)
+{
+}
+
+void KillcamPresenter::setSettings(const Settings& settings) { m_settings = settings; }
+
+bool KillcamPresenter::start(const ReplayBuffer& buffer, std::uint64_t killTick) {
+    m_playing = false;
+    if (buffer.isEmpty() || killTick < buffer.getOldestTick() || killTick > buffer.getNewestTick()) return false;
+
+    std::uint64_t before = static_cast<std::uint64_t>(m_settings.secondsBefore * 60.f);
+    std::uint64_t after = static_cast<std::uint64_t>(m_settings.secondsAfter * 60.f);
+    std::uint64_t first = killTick - std::min(before, killTick - buffer.getOldestTick());
+
+    m_buffer = &buffer;
+    m_focusTick = killTick;
+    m_lastTick = std::min(killTick + after, buffer.getNewestTick());
+    m_position = static_cast<double>(first);
+    m_playing = true;
+    return true;
+}
+
+bool KillcamPresenter::step(RenderSnapshot& snapshot) {
+    if (!m_playing) return false;
+    if (m_position > static_cast<double>(m_lastTick)) {
+        m_playing = false;
+        return false;
+    }
+
+    // Blend the two recorded ticks either side of the playback position
+    std::uint64_t tick = static_cast<std::uint64_t>(m_position);
+    float alpha = static_cast<float>(m_position - static_cast<double>(tick));
+    const RenderSnapshot* frame = &m_from;
+    m_buffer->expand(tick, m_from);
+    if (alpha > 0.f && m_buffer->expand(tick + 1, m_to)) {
+        interpolateSnapshots(m_from, m_to, alpha, m_blended);
+        frame = &m_blended;
+    }
+    snapshot.tick = frame->tick;
+    snapshot.playerCount = frame->playerCount;
+    snapshot.players = frame->players;
+    snapshot.boomerangCount = frame->boomerangCount;
+    snapshot.boomerangs = frame->boomerangs;
+
+    double distance = std::abs(m_position - static_cast<double>(m_focusTick));
+    bool slow = distance < m_settings.slowSeconds * 60.0;
+    m_position += slow ? std::max(m_settings.slowMotion, 0.05f) : 1.0;
+    return true;
+}
+
+bool KillcamPresenter::isPlaying() const { return m_playing; }
@@ -0,0 +1,110 @@
+#ifndef KILLCAM_HPP
+#define KILLCAM_HPP
+
+#include <array>
+#include <cstdint>
+#include "render_snapshot.hpp"
+
+class World;
+
+// One tick of a match, packed for the instant replay: positions in quarter
+// pixels and rotation in hundredths of a degree, about 270 bytes a tick
+struct ReplayFrame {
+    struct Player {
+        std::int16_t x, y;
+        std::uint8_t id;
+        std::uint8_t frame;         // Index in the 24x24 sprite sheet
+        std::uint8_t state;         // Player::State
+        std::uint8_t flags;         // FacingRight | Alive
+    };
+
+    struct Boomerang {
+        std::int16_t x, y;
+        std::uint16_t rotation;
+        std::uint8_t ownerId;
+        std::uint8_t state;         // Boomerang::State
+    };
+
+    static constexpr std::uint8_t FacingRight = 1;
+    static constexpr std::uint8_t Alive = 2;
+
+    std::uint64_t tick;
+    std::uint8_t playerCount;
+    std::uint8_t boomerangCount;
+    std::array<Player, RenderSnapshot::MaxPlayers> players;
+    std::array<Boomerang, RenderSnapshot::MaxBoomerangs> boomerangs;
+};
+
+// The last few seconds of the match in a fixed ring, overwritten as the
+// match goes on. Recording a tick is a copy of a few dozen numbers into
+// storage allocated with the buffer, so it can run on every tick of every
+// match.
+class ReplayBuffer {
+public:
+    static constexpr int Capacity = 8 * 60;     // Eight seconds
+
+    ReplayBuffer();
+
+    void clear();
+
+    // Call after every World::step(); ticks must follow each other
+    void record(const World& world);
+
+    std::uint64_t getOldestTick() const;
+    std::uint64_t getNewestTick() const;
+    bool isEmpty() const;
+
+    // Writes the recorded players and boomerangs of tick into snapshot.
+    // Returns false if that tick is no longer (or not yet) in the ring.
+    bool expand(std::uint64_t tick, RenderSnapshot& snapshot) const;
+
+private:
+    std::array<ReplayFrame, Capacity> m_frames;
+    int m_newest;       // Index of the newest frame
+    int m_count;
+};
+
+// Plays the moments around a kill back out of a ReplayBuffer before the
+// game over screen: a few seconds at normal speed, slowing down (if
+// enabled) just before the hit and for a moment after it. Works in 60 Hz
+// ticks like the simulation, filling one snapshot per tick; frames between
+// two recorded ticks are blended, so slow motion stays smooth.
+class KillcamPresenter {
+public:
+    struct Settings {
+        float secondsBefore = 3.f;      // Shown before the kill
+        float secondsAfter = 1.f;       // Shown after it
+        float slowMotion = 0.5f;        // Playback speed near the kill; 1 = none
+        float slowSeconds = 0.5f;       // How far either side of the kill is slowed
+    };
+
+    KillcamPresenter();
+
+    void setSettings(const Settings& settings);
+
+    // Starts a replay of the kill at killTick. The buffer must not be
+    // recorded into until the replay is over. Returns false if the buffer
+    // holds nothing around that tick.
+    bool start(const ReplayBuffer& buffer, std::uint64_t killTick);
+
+    // Fills the players, boomerangs and tick of snapshot with the next
+    // frame. Returns false, leaving snapshot alone, once the replay is over.
+    bool step(RenderSnapshot& snapshot);
+
+    bool isPlaying() const;
+
+private:
+    Settings m_settings;
+    const ReplayBuffer* m_buffer;
+    std::uint64_t m_focusTick;
+    std::uint64_t m_lastTick;
+    double m_position;          // Playback position in recorded ticks
+    bool m_playing;
+
+    // Scratch space for blending two recorded ticks
+    RenderSnapshot m_from;
+    RenderSnapshot m_to;
+    RenderSnapshot m_blended;
+};
+
+#endif
@@ -0,0 +1,82 @@
+#include "latency_monitor.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+LatencyMonitor::LatencyMonitor(const std::string& logPath)
+    : m_samples{}
+    , m_count(0)
+    , m_next(0)
+    , m_log(logPath, std::ios::app)
+    , m_total(0)
+{
+    if (!m_log) {
+        std::cerr << "Warning: Could not open latency log " << logPath << std::endl;
+    }
+}
+
+void LatencyMonitor::record(sf::Time latency, sf::Time now) {
+    m_samples[m_next] = latency.asMicroseconds();
+    m_next = (m_next + 1) % WindowSize;
+    m_count = std::min(m_count + 1, WindowSize);
+    ++m_total;
+
+    if (m_log && now - m_lastLog >= sf::seconds(1.f)) {
+        m_lastLog = now;
+        Stats stats = getStats();
+        m_log << std::fixed << std::setprecision(2)
+              << "t=" << now.asSeconds() << "s samples=" << m_total
+              << " min=" << stats.min.asMicroseconds() / 1000.0 << "ms"
+              << " avg=" << stats.average.asMicroseconds() / 1000.0 << "ms"
+              << " p99=" << stats.p99.asMicroseconds() / 1000.0 << "ms\n";
+    }
+}
+
+LatencyMonitor::Stats LatencyMonitor::getStats() const {
+    Stats stats;
+    stats.samples = m_count;
+    if (m_count == 0) return stats;
+
+    std::array<std::int64_t, WindowSize> sorted;
+    std::copy(m_samples.begin(), m_samples.begin() + m_count, sorted.begin());
+    std::sort(sorted.begin(), sorted.begin() + m_count);
+
+    std::int64_t sum = 0;
+    for (int i = 0; i < m_count; ++i) sum += sorted[i];
+    stats.min = sf::microseconds(sorted[0]);
+    stats.average = sf::microseconds(sum / m_count);
+    stats.p99 = sf::microseconds(sorted[std::min(m_count - 1, (m_count * 99) / 100)]);
+    return stats;
+}
+
+void LatencyMonitor::draw(sf::RenderTarget& target) const {
+    const float pixelsPerMs = 4.f;
+    const float barHeight = 6.f;
+    const sf::Vector2f origin(10.f, 10.f);
+    const float frameMs = 1000.f / 60.f;
+
+    Stats stats = getStats();
+
+    sf::RectangleShape background({frameMs * 4 * pixelsPerMs + 8.f, 3 * (barHeight + 2.f) + 6.f});
+    background.setPosition(origin - sf::Vector2f(4.f, 4.f));
+    background.setFillColor(sf::Color(0, 0, 0, 160));
+    target.draw(background);
+
+    const sf::Time values[3] = {stats.min, stats.average, stats.p99};
+    const sf::Color colors[3] = {sf::Color::Green, sf::Color::Yellow, sf::Color::Red};
+    for (int i = 0; i < 3; ++i) {
+        float width = std::min(values[i].asMicroseconds() / 1000.f, frameMs * 4) * pixelsPerMs;
+        sf::RectangleShape bar({width, barHeight});
+        bar.setPosition(origin + sf::Vector2f(0.f, i * (barHeight + 2.f)));
+        bar.setFillColor(colors[i]);
+        target.draw(bar);
+    }
+
+    // A tick mark for every 60 Hz frame of delay
+    for (int frame = 1; frame <= 4; ++frame) {
+        sf::RectangleShape mark({1.f, 3 * (barHeight + 2.f)});
+        mark.setPosition(origin + sf::Vector2f(frame * frameMs * pixelsPerMs, -1.f));
+        mark.setFillColor(sf::Color(255, 255, 255, 180));
+        target.draw(mark);
+    }
+}
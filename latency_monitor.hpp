@@ -0,0 +1,43 @@
+#ifndef LATENCY_MONITOR_HPP
+#define LATENCY_MONITOR_HPP
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+// Input-to-photon latency: the time from a controller state change being
+// sampled to window.display() returning for the first frame that shows the
+// tick which consumed it. Samples are kept in a rolling window; the stats
+// are drawn as bars and appended to a log once a second. Render thread only.
+class LatencyMonitor {
+public:
+    static constexpr int WindowSize = 240;      // Samples kept for the stats
+
+    struct Stats {
+        sf::Time min;
+        sf::Time average;
+        sf::Time p99;
+        int samples = 0;
+    };
+
+    explicit LatencyMonitor(const std::string& logPath);
+
+    // now is on the same clock as the input timestamps
+    void record(sf::Time latency, sf::Time now);
+    Stats getStats() const;
+
+    // Min, average and p99 as horizontal bars, with marks every 60 Hz frame
+    void draw(sf::RenderTarget& target) const;
+
+private:
+    std::array<std::int64_t, WindowSize> m_samples;     // Microseconds
+    int m_count;
+    int m_next;
+    std::ofstream m_log;
+    sf::Time m_lastLog;
+    std::uint64_t m_total;
+};
+
+#endif
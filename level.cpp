@@ -0,0 +1,160 @@
+#include "level.hpp"
+#include <algorithm>
+#include <limits>
+
+const std::vector<Level>& builtinLevels() {
+    static const std::vector<Level> levels = {
+        {"grasslands", {
+            "....................",
+            "..S.................",
+            "..G..............S..",
+            "..#..........GG..G..",
+            "..#.................",
+            ".....GGG.......#.....",
+            ".......#G...........",
+            "..G.........#.......",
+            "....................",
+            ".....GGGG......G....",
+            "....................",
+            "GG..S..........S..GG",
+            "##GGGGGGGGGG..GGGG##",
+            "############..######"
+        }},
+        {"towers", {
+            "....................",
+            "...S............S...",
+            "...G............G...",
+            "...#............#...",
+            "...#....GGGG....#...",
+            "...#............#...",
+            "GG.#............#.GG",
+            "...#...G....G...#...",
+            "...#............#...",
+            ".......GGGGGG.......",
+            "....................",
+            "GGG..S........S..GGG",
+            "###GGGGG....GGGGG###",
+            "########....########"
+        }},
+        {"pit", {
+            "....................",
+            ".....S........S.....",
+            "....GGG......GGG....",
+            "....................",
+            "G..................G",
+            "#.......GGGG.......#",
+            "#..................#",
+            "#...GG........GG...#",
+            "#..................#",
+            "#.........G........#",
+            "#..GGG.........GGG.#",
+            "#.....S......S.....#",
+            "#GGGGGGG....GGGGGGG#",
+            "########....########"
+        }}
+    };
+    return levels;
+}
+
+std::vector<sf::RectangleShape> buildTiles(const Level& level, const sf::Texture* grassTexture) {
+    std::vector<sf::RectangleShape> tiles;
+
+    for (std::size_t y = 0; y < level.rows.size(); ++y) {
+        for (std::size_t x = 0; x < level.rows[y].size(); ++x) {
+            char cell = level.rows[y][x];
+            if (cell == '#' || cell == 'G') {
+                sf::RectangleShape tile;
+                tile.setSize({TILE_SIZE, TILE_SIZE});
+                
+                if (cell == 'G' && grassTexture) {
+                    // Grass tile
+                    tile.setTexture(grassTexture);
+                    int tileSize = static_cast<int>(TILE_SIZE);
+                    tile.setTextureRect(sf::IntRect(
+                        sf::Vector2i(0, 0),  // position
+                        sf::Vector2i(tileSize, tileSize)  // size
+                    ));
+                } else {
+                    // Regular solid tile
+                    tile.setFillColor(sf::Color(100, 100, 100)); // Dark grey
+                }
+                
+                tile.setPosition({x * TILE_SIZE, y * TILE_SIZE});
+                tiles.push_back(tile);
+            }
+        }
+    }
+    return tiles;
+}
+
+TileGrid buildTileGrid(const Level& level) {
+    TileGrid grid;
+    grid.solid.assign(ARENA_COLUMNS * ARENA_ROWS, false);
+    for (int y = 0; y < static_cast<int>(level.rows.size()) && y < ARENA_ROWS; ++y) {
+        for (int x = 0; x < static_cast<int>(level.rows[y].size()) && x < ARENA_COLUMNS; ++x) {
+            char cell = level.rows[y][x];
+            grid.solid[y * ARENA_COLUMNS + x] = (cell == '#' || cell == 'G');
+        }
+    }
+    return grid;
+}
+
+std::vector<sf::Vector2f> buildSpawnPoints(const Level& level, int count) {
+    // Standing on the bottom of a cell, with the 48x48 hitbox centred on it
+    auto standingAt = [](int column, int row) {
+        return sf::Vector2f(column * TILE_SIZE + TILE_SIZE / 2.f, (row + 1) * TILE_SIZE - 24.f);
+    };
+
+    // Somewhere a dino fits: the cell and the one above it are empty (the
+    // arena's edges count as solid), so are the cells either side (the
+    // hitbox is a little wider than a tile), and there is ground inside the
+    // arena right below
+    TileGrid grid = buildTileGrid(level);
+    auto fits = [&grid](int column, int row) {
+        if (row < 1 || row + 1 >= ARENA_ROWS) return false;
+        if (grid.isSolid(column, row) || grid.isSolid(column, row - 1)) return false;
+        if (grid.isSolid(column - 1, row) || grid.isSolid(column + 1, row)) return false;
+        return grid.isSolid(column, row + 1);
+    };
+
+    // The level's own 'S' cells come first; one a dino wouldn't fit in is
+    // left out
+    std::vector<sf::Vector2f> spawns;
+    for (int y = 0; y < static_cast<int>(level.rows.size()) && y < ARENA_ROWS; ++y) {
+        for (int x = 0; x < static_cast<int>(level.rows[y].size()) && x < ARENA_COLUMNS; ++x) {
+            if (level.rows[y][x] != 'S' || static_cast<int>(spawns.size()) >= count || !fits(x, y)) continue;
+            spawns.push_back(standingAt(x, y));
+        }
+    }
+
+    std::vector<sf::Vector2f> candidates;
+    for (int y = 1; y + 1 < ARENA_ROWS; ++y) {
+        for (int x = 0; x < ARENA_COLUMNS; ++x) {
+            if (fits(x, y)) candidates.push_back(standingAt(x, y));
+        }
+    }
+
+    // Farthest point first; ties go to the earlier cell in reading order
+    std::vector<float> nearest(candidates.size(), std::numeric_limits<float>::max());
+    auto claim = [&](sf::Vector2f point) {
+        for (std::size_t i = 0; i < candidates.size(); ++i) {
+            sf::Vector2f delta = candidates[i] - point;
+            nearest[i] = std::min(nearest[i], delta.x * delta.x + delta.y * delta.y);
+        }
+    };
+    for (const auto& spawn : spawns) {
+        claim(spawn);
+    }
+    while (static_cast<int>(spawns.size()) < count) {
+        int best = -1;
+        for (int i = 0; i < static_cast<int>(candidates.size()); ++i) {
+            if (nearest[i] > 0.f && (best < 0 || nearest[i] > nearest[best])) best = i;
+        }
+        if (best < 0) break;
+        spawns.push_back(candidates[best]);
+        claim(candidates[best]);
+    }
+
+    if (spawns.empty()) spawns.push_back({ARENA_COLUMNS * TILE_SIZE / 2.f, TILE_SIZE});
+    return spawns;
+}
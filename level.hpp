@@ -0,0 +1,54 @@
+#ifndef LEVEL_HPP
+#define LEVEL_HPP
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+
+// --- Tilemap Data ---
+// Levels are defined using strings.
+// '#' = a solid tile. 'G' = a grass tile (also solid). '.' = empty space.
+// 'S' = a spawn point (empty space), taken in reading order. It needs free
+// cells above and to either side and ground right below, or it is ignored.
+struct Level {
+    std::string name;
+    std::vector<std::string> rows;
+};
+
+// Each tile is 40x40 pixels
+constexpr float TILE_SIZE = 40.f;
+
+// The playable area is 20 tiles wide and 14 tall (800 x 560 pixels)
+constexpr int ARENA_COLUMNS = 20;
+constexpr int ARENA_ROWS = 14;
+
+// Which cells of the arena are solid, for lookups by position. Everything
+// outside the arena counts as solid, so its edges act as walls, floor and
+// ceiling.
+struct TileGrid {
+    std::vector<bool> solid;    // ARENA_COLUMNS * ARENA_ROWS, row by row
+
+    bool isSolid(int column, int row) const {
+        if (column < 0 || row < 0 || column >= ARENA_COLUMNS || row >= ARENA_ROWS) return true;
+        return !solid.empty() && solid[row * ARENA_COLUMNS + column];
+    }
+};
+
+// The arenas that ship with the game. Index 0 is the original arena.
+const std::vector<Level>& builtinLevels();
+
+// Create the collision/visual tiles from the map data. grassTexture may be
+// nullptr when running headless.
+std::vector<sf::RectangleShape> buildTiles(const Level& level, const sf::Texture* grassTexture);
+
+// The solid cells of the map, for the character controller
+TileGrid buildTileGrid(const Level& level);
+
+// Where players 0..count-1 start: the level's 'S' cells a dino fits in first, then as many
+// more as needed picked among the cells a dino can stand in, each as far as
+// possible from those already chosen. A dino starts with its feet on the
+// bottom of its cell. Returns at least one point; it may return fewer than count on
+// a crowded map, in which case the points are meant to be reused in turn.
+std::vector<sf::Vector2f> buildSpawnPoints(const Level& level, int count);
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef MATCH_SEED_HPP
+#define MATCH_SEED_HPP
+
+#include <cstdint>
+
+// Spreads a base seed and an index over the whole seed space. dino_batch
+// seeds match N with mixSeed(base, N) and that match's bot i with
+// mixSeed(matchSeed, i + 1); every tool that replays a batch match
+// (dino_desync, dino_export, the training environment) derives its seeds
+// the same way, so match N is the same match everywhere.
+inline std::uint32_t mixSeed(std::uint32_t base, std::uint32_t index) {
+    std::uint32_t x = base + index * 0x9E3779B9u;
+    x ^= x >> 16; x *= 0x85EBCA6Bu;
+    x ^= x >> 13; x *= 0xC2B2AE35u;
+    x ^= x >> 16;
+    return x;
+}
+
+#endif
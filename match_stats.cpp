@@ -0,0 +1,43 @@
+#include "match_stats.hpp"
+
+MatchStats::PlayerStats& MatchStats::statsFor(int playerId) {
+    if (playerId >= static_cast<int>(m_players.size())) m_players.resize(playerId + 1);
+    return m_players[playerId];
+}
+
+void MatchStats::onEvent(const GameEvent& event) {
+    if (event.actorId < 0) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    PlayerStats& actor = statsFor(event.actorId);
+    switch (event.type) {
+        case GameEvent::Type::Throw:  ++actor.throws; break;
+        case GameEvent::Type::Bounce: ++actor.bounces; break;
+        case GameEvent::Type::Catch:  ++actor.catches; break;
+        case GameEvent::Type::Dash:   ++actor.dashes; break;
+        case GameEvent::Type::Kill:
+            ++actor.kills;
+            if (event.targetId >= 0) ++statsFor(event.targetId).deaths;
+            break;
+    }
+}
+
+void MatchStats::reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_players.clear();
+}
+
+void MatchStats::print(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (std::size_t i = 0; i < m_players.size(); ++i) {
+        const PlayerStats& stats = m_players[i];
+        out << "P" << (i + 1)
+            << ": kills " << stats.kills
+            << ", deaths " << stats.deaths
+            << ", throws " << stats.throws
+            << ", bounces " << stats.bounces
+            << ", catches " << stats.catches
+            << ", dashes " << stats.dashes << "\n";
+    }
+    out.flush();
+}
@@ -0,0 +1,34 @@
+#ifndef MATCH_STATS_HPP
+#define MATCH_STATS_HPP
+
+#include <mutex>
+#include <ostream>
+#include <vector>
+#include "event_bus.hpp"
+
+// Per-player tallies for the current match, built from the event stream.
+// onEvent runs on an EventListener thread; the other calls may come from any
+// thread.
+class MatchStats {
+public:
+    void onEvent(const GameEvent& event);
+    void reset();
+    void print(std::ostream& out) const;
+
+private:
+    struct PlayerStats {
+        int throws = 0;
+        int bounces = 0;
+        int catches = 0;
+        int dashes = 0;
+        int kills = 0;
+        int deaths = 0;
+    };
+
+    PlayerStats& statsFor(int playerId);
+
+    mutable std::mutex m_mutex;
+    std::vector<PlayerStats> m_players;
+};
+
+#endif
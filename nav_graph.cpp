@@ -0,0 +1,278 @@
+#include "nav_graph.hpp"
+#include "player.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <queue>
+
+// Longest a simulated move may take before it counts as going nowhere
+static constexpr int MaxEdgeTicks = 240;
+
+// The player hitbox is 48x48, centred on its position
+static constexpr float PlayerHalfSize = 24.f;
+
+NavGraph::NavGraph(const Level& level, const Tuning& tuning)
+    : m_grid(buildTileGrid(level))
+    , m_tuning(tuning)
+    , m_segmentAt(ARENA_COLUMNS * ARENA_ROWS, -1)
+    , m_maxSpeed(std::max(tuning.dashSpeed, std::hypot(tuning.moveSpeed, tuning.maxFallSpeed)))
+{
+    buildSegments();
+    buildEdges();
+    buildPaths();
+}
+
+std::shared_ptr<const NavGraph> NavGraph::forLevel(const Level& level, const Tuning& tuning) {
+    struct Entry {
+        Level level;
+        Tuning tuning;
+        std::shared_ptr<const NavGraph> graph;
+    };
+    static std::mutex mutex;
+    static std::vector<Entry> graphs;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& entry : graphs) {
+        if (entry.level.rows == level.rows && std::memcmp(&entry.tuning, &tuning, sizeof(Tuning)) == 0) {
+            return entry.graph;
+        }
+    }
+    graphs.push_back({level, tuning, std::make_shared<const NavGraph>(level, tuning)});
+    return graphs.back().graph;
+}
+
+void NavGraph::buildSegments() {
+    for (int row = 0; row < ARENA_ROWS; ++row) {
+        int column = 0;
+        while (column < ARENA_COLUMNS) {
+            auto standable = [&](int c) { return !m_grid.isSolid(c, row) && m_grid.isSolid(c, row + 1); };
+            if (!standable(column)) {
+                ++column;
+                continue;
+            }
+
+            Segment segment;
+            segment.row = row;
+            segment.firstColumn = column;
+            while (column < ARENA_COLUMNS && standable(column)) ++column;
+            segment.lastColumn = column - 1;
+            segment.standY = (row + 1) * TILE_SIZE - PlayerHalfSize;
+            segment.centerX = (segment.firstColumn + segment.lastColumn + 1) * TILE_SIZE / 2.f;
+
+            int index = static_cast<int>(m_segments.size());
+            for (int c = segment.firstColumn; c <= segment.lastColumn; ++c) {
+                m_segmentAt[row * ARENA_COLUMNS + c] = index;
+            }
+            m_segments.push_back(segment);
+        }
+    }
+}
+
+namespace {
+
+struct Recipe {
+    int direction;
+    int holdTicks;
+    bool jump;
+    int dashTick;
+};
+
+} // namespace
+
+void NavGraph::buildEdges() {
+    const PhysicsStep step(m_tuning);
+    const int dashTicks = m_tuning.dashDurationTicks + 1;
+
+    // What to try from each launch point. Walking off either end is only
+    // tried from the launch point nearest that end.
+    std::vector<Recipe> recipes;
+    for (int direction : {-1, 0, 1}) {
+        recipes.push_back({direction, MaxEdgeTicks, true, -1});
+        if (direction == 0) continue;
+        recipes.push_back({direction, 10, true, -1});           // Short hop sideways
+        recipes.push_back({direction, 20, true, -1});
+        recipes.push_back({direction, dashTicks, false, 0});    // Dash along the ground
+        recipes.push_back({direction, 6 + dashTicks, true, 6}); // Dash while rising
+        recipes.push_back({direction, 16 + dashTicks, true, 16}); // Dash near the top
+    }
+
+    std::vector<Edge> edges;
+    for (int from = 0; from < static_cast<int>(m_segments.size()); ++from) {
+        const Segment& segment = m_segments[from];
+
+        // Launch from the middle of every cell, moved in far enough that the
+        // dino doesn't overlap a wall
+        std::vector<float> launches;
+        float low = segment.firstColumn * TILE_SIZE;
+        float high = (segment.lastColumn + 1) * TILE_SIZE;
+        if (m_grid.isSolid(segment.firstColumn - 1, segment.row)) low += PlayerHalfSize;
+        if (m_grid.isSolid(segment.lastColumn + 1, segment.row)) high -= PlayerHalfSize;
+        for (int c = segment.firstColumn; c <= segment.lastColumn; ++c) {
+            float x = std::clamp((c + 0.5f) * TILE_SIZE, low, high);
+            if (launches.empty() || x != launches.back()) launches.push_back(x);
+        }
+
+        for (float launchX : launches) {
+            // Stand the dino there and wait out its first dash cooldown
+            Player standing(launchX, segment.standY, 0, 0, m_tuning);
+            for (int tick = 0; tick < m_tuning.dashCooldownTicks; ++tick) {
+                standing.handleInput(PlayerInput());
+                standing.beginTick();
+                for (int s = 0; s < step.substeps; ++s) standing.substep(m_grid, step);
+                standing.endTick();
+            }
+            if (!standing.isGrounded() || findSegment(standing.getPosition()) != from ||
+                std::abs(standing.getPosition().x - launchX) > 0.5f) {
+                continue;   // No room to stand here
+            }
+
+            std::vector<Recipe> tries = recipes;
+            if (launchX == launches.front()) tries.push_back({-1, MaxEdgeTicks, false, -1});
+            if (launchX == launches.back()) tries.push_back({1, MaxEdgeTicks, false, -1});
+
+            for (const Recipe& recipe : tries) {
+                Player player = standing;
+                bool leftGround = false;
+                for (int tick = 0; tick < MaxEdgeTicks; ++tick) {
+                    PlayerInput input;
+                    input.left = tick < recipe.holdTicks && recipe.direction < 0;
+                    input.right = tick < recipe.holdTicks && recipe.direction > 0;
+                    input.jump = recipe.jump && tick == 0;
+                    input.dash = tick == recipe.dashTick;
+                    float xBefore = player.getPosition().x;
+                    player.handleInput(input);
+                    player.beginTick();
+                    for (int s = 0; s < step.substeps; ++s) player.substep(m_grid, step);
+                    player.endTick();
+
+                    if (!player.isGrounded() || player.getState() != Player::State::Normal) {
+                        leftGround = true;
+                        continue;
+                    }
+                    int to = findSegment(player.getPosition());
+                    if (to < 0) break;
+                    if (to != from) {
+                        EdgeType type = recipe.dashTick >= 0 ? EdgeType::Dash
+                                      : recipe.jump         ? EdgeType::Jump
+                                      : leftGround          ? EdgeType::Fall
+                                                            : EdgeType::Walk;
+                        float walk = std::abs(launchX - segment.centerX) / m_tuning.moveSpeed;
+                        edges.push_back({from, to, type, launchX, recipe.direction, recipe.holdTicks,
+                                         recipe.jump, recipe.dashTick, tick + 1, tick + 1 + walk});
+                        break;
+                    }
+                    // Back where it started, or walked into a wall
+                    if (leftGround || player.getPosition().x == xBefore) break;
+                }
+            }
+        }
+    }
+
+    // Keep the cheapest way of each type between two segments
+    std::stable_sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
+        if (a.from != b.from) return a.from < b.from;
+        if (a.to != b.to) return a.to < b.to;
+        if (a.type != b.type) return a.type < b.type;
+        return a.cost < b.cost;
+    });
+    for (const Edge& edge : edges) {
+        if (!m_edges.empty() && m_edges.back().from == edge.from && m_edges.back().to == edge.to &&
+            m_edges.back().type == edge.type) {
+            continue;
+        }
+        m_edges.push_back(edge);
+    }
+
+    m_firstEdge.assign(m_segments.size() + 1, 0);
+    for (const Edge& edge : m_edges) ++m_firstEdge[edge.from + 1];
+    for (std::size_t i = 1; i < m_firstEdge.size(); ++i) m_firstEdge[i] += m_firstEdge[i - 1];
+}
+
+int NavGraph::getSegmentCount() const { return static_cast<int>(m_segments.size()); }
+const NavGraph::Segment& NavGraph::getSegment(int index) const { return m_segments[index]; }
+const NavGraph::Edge& NavGraph::getEdge(int index) const { return m_edges[index]; }
+int NavGraph::getEdgeCount() const { return static_cast<int>(m_edges.size()); }
+
+int NavGraph::findSegment(sf::Vector2f position) const {
+    // The cell the feet are in, then the cells either side for a dino
+    // standing over the end of a platform
+    int columns[3] = {
+        static_cast<int>(std::floor(position.x / TILE_SIZE)),
+        static_cast<int>(std::floor((position.x - PlayerHalfSize + 1.f) / TILE_SIZE)),
+        static_cast<int>(std::floor((position.x + PlayerHalfSize - 1.f) / TILE_SIZE))
+    };
+    int row = std::max(0, static_cast<int>(std::floor((position.y + PlayerHalfSize - 1.f) / TILE_SIZE)));
+    for (; row < ARENA_ROWS; ++row) {
+        for (int column : columns) {
+            if (column < 0 || column >= ARENA_COLUMNS) continue;
+            int segment = m_segmentAt[row * ARENA_COLUMNS + column];
+            if (segment >= 0) return segment;
+        }
+    }
+    return -1;
+}
+
+void NavGraph::buildPaths() {
+    // Every pair up front: bots ask mid-match, when searching (and growing
+    // the paths) would put allocations in the middle of a tick
+    std::size_t count = m_segments.size();
+    m_paths.resize(count * count);
+    m_reachable.assign(count * count, 0);
+    for (std::size_t from = 0; from < count; ++from) {
+        for (std::size_t to = 0; to < count; ++to) {
+            std::size_t slot = from * count + to;
+            m_reachable[slot] = search(static_cast<int>(from), static_cast<int>(to), m_paths[slot]);
+        }
+    }
+}
+
+const std::vector<int>* NavGraph::findPath(int from, int to) const {
+    if (from < 0 || to < 0 || from >= getSegmentCount() || to >= getSegmentCount()) return nullptr;
+    std::size_t slot = static_cast<std::size_t>(from) * m_segments.size() + to;
+    return m_reachable[slot] ? &m_paths[slot] : nullptr;
+}
+
+bool NavGraph::search(int from, int to, std::vector<int>& path) const {
+    // A* over segments. The heuristic is the time to cover the distance
+    // between segment centres at the fastest speed a dino can move.
+    const Segment& goal = m_segments[to];
+    auto heuristic = [&](int segment) {
+        float dx = m_segments[segment].centerX - goal.centerX;
+        float dy = m_segments[segment].standY - goal.standY;
+        return std::sqrt(dx * dx + dy * dy) / m_maxSpeed;
+    };
+
+    std::vector<float> cost(m_segments.size(), INFINITY);
+    std::vector<int> via(m_segments.size(), -1);     // Edge that reached each segment
+    std::vector<bool> done(m_segments.size(), false);
+    using Open = std::pair<float, int>;
+    std::priority_queue<Open, std::vector<Open>, std::greater<Open>> open;
+    cost[from] = 0.f;
+    open.push({heuristic(from), from});
+
+    while (!open.empty()) {
+        int segment = open.top().second;
+        open.pop();
+        if (segment == to) break;
+        if (done[segment]) continue;    // Reached again more cheaply since it was queued
+        done[segment] = true;
+
+        for (int e = m_firstEdge[segment]; e < m_firstEdge[segment + 1]; ++e) {
+            const Edge& edge = m_edges[e];
+            float next = cost[segment] + edge.cost;
+            if (next < cost[edge.to]) {
+                cost[edge.to] = next;
+                via[edge.to] = e;
+                open.push({next + heuristic(edge.to), edge.to});
+            }
+        }
+    }
+
+    path.clear();
+    if (from != to && via[to] < 0) return false;
+    for (int segment = to; segment != from; segment = m_edges[via[segment]].from) {
+        path.push_back(via[segment]);
+    }
+    std::reverse(path.begin(), path.end());
+    return true;
+}
@@ -0,0 +1,95 @@
+#ifndef NAV_GRAPH_HPP
+#define NAV_GRAPH_HPP
+
+#include <SFML/System.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "level.hpp"
+#include "tuning.hpp"
+
+// Where a dino can get to in an arena, for bots.
+//
+// The nodes are platform segments: runs of empty cells with a solid cell
+// underneath and room to stand. Edges join them by walking, falling off an
+// edge, jumping or dashing. Every edge is found by running the real Player
+// physics from a launch point with a fixed input recipe and seeing where
+// the dino lands, so a bot that repeats the recipe lands there too.
+//
+// Graphs are immutable once built and shared between every World on the
+// same level and tuning. A* runs for every pair of segments while the graph
+// is built, so findPath() is a lookup that never allocates, safe from any
+// number of threads.
+class NavGraph {
+public:
+    enum class EdgeType : std::uint8_t {
+        Walk,       // Along the ground onto a neighbouring segment
+        Fall,       // Walk off the end and drop
+        Jump,
+        Dash        // From the ground, or at the top of a jump
+    };
+
+    struct Segment {
+        int row;            // Row of the empty cells; the floor is row + 1
+        int firstColumn;
+        int lastColumn;
+        float standY;       // Player centre y when standing on it
+        float centerX;
+    };
+
+    // How to take an edge: stand at launchX, then for each tick from 0
+    // hold direction while the tick is below holdTicks, press jump on tick 0
+    // if jump is set, and press dash on dashTick (-1 = never). Ends when the
+    // dino is on the ground again.
+    struct Edge {
+        int from;
+        int to;
+        EdgeType type;
+        float launchX;
+        int direction;      // -1, 0 or 1
+        int holdTicks;
+        bool jump;
+        int dashTick;
+        int ticks;          // Until landing, as simulated
+        float cost;         // ticks plus the walk to the launch point
+    };
+
+    NavGraph(const Level& level, const Tuning& tuning);
+
+    // The graph for a level, built the first time it is asked for. Thread safe.
+    static std::shared_ptr<const NavGraph> forLevel(const Level& level, const Tuning& tuning);
+
+    int getSegmentCount() const;
+    const Segment& getSegment(int index) const;
+    const Edge& getEdge(int index) const;
+    int getEdgeCount() const;
+
+    // The segment position stands on, or the first one below it; -1 if
+    // there is none
+    int findSegment(sf::Vector2f position) const;
+
+    // The cheapest way from one segment to another as edge indices, first
+    // edge first. Empty when from == to; nullptr if to can't be reached.
+    const std::vector<int>* findPath(int from, int to) const;
+
+private:
+    void buildSegments();
+    void buildEdges();
+    void buildPaths();
+    bool search(int from, int to, std::vector<int>& path) const;
+
+    TileGrid m_grid;
+    Tuning m_tuning;
+    std::vector<Segment> m_segments;
+    std::vector<int> m_segmentAt;           // Per cell, the segment standing in it or -1
+    std::vector<Edge> m_edges;              // Sorted by from
+    std::vector<int> m_firstEdge;           // Per segment, index of its first edge; one extra at the end
+    float m_maxSpeed;                       // For the A* heuristic
+
+    // One slot per (from, to) pair
+    std::vector<std::vector<int>> m_paths;
+    std::vector<std::uint8_t> m_reachable;
+};
+
+#endif
@@ -0,0 +1,170 @@
+#include "particle_system.hpp"
+#include <cmath>
+
+// Simulation vectors are per 60 Hz tick; particles move per second
+static const float TICKS_PER_SECOND = 60.f;
+
+ParticleSystem::ParticleSystem()
+    : m_vertices(Capacity * 6)
+    , m_rng(12345)
+{
+    for (Pool& pool : m_pools) {
+        pool.x.resize(Capacity);
+        pool.y.resize(Capacity);
+        pool.vx.resize(Capacity);
+        pool.vy.resize(Capacity);
+        pool.gravity.resize(Capacity);
+        pool.age.resize(Capacity);
+        pool.lifetime.resize(Capacity);
+        pool.size.resize(Capacity);
+        pool.color.resize(Capacity);
+    }
+}
+
+float ParticleSystem::random(float min, float max) {
+    return std::uniform_real_distribution<float>(min, max)(m_rng);
+}
+
+void ParticleSystem::spawn(Blend blend, sf::Vector2f position, sf::Vector2f velocity, float gravity,
+                           float lifetime, float size, sf::Color color) {
+    Pool& pool = m_pools[static_cast<int>(blend)];
+    if (pool.count == Capacity) return;
+
+    std::size_t i = pool.count++;
+    pool.x[i] = position.x;
+    pool.y[i] = position.y;
+    pool.vx[i] = velocity.x;
+    pool.vy[i] = velocity.y;
+    pool.gravity[i] = gravity;
+    pool.age[i] = 0.f;
+    pool.lifetime[i] = lifetime;
+    pool.size[i] = size;
+    pool.color[i] = color;
+}
+
+void ParticleSystem::emitBounceSparks(sf::Vector2f position, sf::Vector2f velocity) {
+    // Sparks fly off along the rebound direction, fanned out a little
+    float speed = std::sqrt(velocity.x * velocity.x + velocity.y * velocity.y) * TICKS_PER_SECOND;
+    float heading = std::atan2(velocity.y, velocity.x);
+    for (int i = 0; i < 24; i++) {
+        float angle = heading + random(-0.9f, 0.9f);
+        float sparkSpeed = random(0.3f, 0.8f) * speed + random(60.f, 120.f);
+        sf::Vector2f sparkVelocity(std::cos(angle) * sparkSpeed, std::sin(angle) * sparkSpeed);
+        sf::Color color(255, static_cast<std::uint8_t>(random(160.f, 240.f)), 80);
+        spawn(Blend::Additive, position, sparkVelocity, 900.f, random(0.15f, 0.4f), random(2.f, 4.f), color);
+    }
+}
+
+void ParticleSystem::emitDashTrail(sf::Vector2f position, sf::Color color) {
+    for (int i = 0; i < 4; i++) {
+        sf::Vector2f offset(random(-14.f, 14.f), random(-18.f, 18.f));
+        sf::Vector2f drift(random(-20.f, 20.f), random(-30.f, 0.f));
+        color.a = 160;
+        spawn(Blend::Alpha, position + offset, drift, 0.f, random(0.2f, 0.35f), random(4.f, 8.f), color);
+    }
+}
+
+void ParticleSystem::emitDashBurst(sf::Vector2f position, sf::Vector2f direction, sf::Color color) {
+    // Puff of dust blown out behind the dino
+    float heading = std::atan2(-direction.y, -direction.x);
+    color.a = 200;
+    for (int i = 0; i < 16; i++) {
+        float angle = heading + random(-0.7f, 0.7f);
+        float speed = random(80.f, 220.f);
+        sf::Vector2f velocity(std::cos(angle) * speed, std::sin(angle) * speed);
+        spawn(Blend::Alpha, position, velocity, 200.f, random(0.2f, 0.45f), random(3.f, 6.f), color);
+    }
+}
+
+void ParticleSystem::emitDeathBurst(sf::Vector2f position, sf::Color color) {
+    // Debris in the dino's color plus a flash of hot sparks
+    color.a = 255;
+    for (int i = 0; i < 64; i++) {
+        float angle = random(0.f, 6.2832f);
+        float speed = random(100.f, 420.f);
+        sf::Vector2f velocity(std::cos(angle) * speed, std::sin(angle) * speed - 150.f);
+        spawn(Blend::Alpha, position, velocity, 700.f, random(0.5f, 1.1f), random(4.f, 7.f), color);
+    }
+    for (int i = 0; i < 48; i++) {
+        float angle = random(0.f, 6.2832f);
+        float speed = random(50.f, 300.f);
+        sf::Vector2f velocity(std::cos(angle) * speed, std::sin(angle) * speed);
+        spawn(Blend::Additive, position, velocity, 300.f, random(0.2f, 0.5f), random(2.f, 5.f),
+              sf::Color(255, 230, 140));
+    }
+}
+
+void ParticleSystem::updatePool(Pool& pool, float seconds) {
+    std::size_t i = 0;
+    while (i < pool.count) {
+        pool.age[i] += seconds;
+        if (pool.age[i] >= pool.lifetime[i]) {
+            // Move the last live particle into this slot and look at it next
+            std::size_t last = --pool.count;
+            pool.x[i] = pool.x[last];
+            pool.y[i] = pool.y[last];
+            pool.vx[i] = pool.vx[last];
+            pool.vy[i] = pool.vy[last];
+            pool.gravity[i] = pool.gravity[last];
+            pool.age[i] = pool.age[last];
+            pool.lifetime[i] = pool.lifetime[last];
+            pool.size[i] = pool.size[last];
+            pool.color[i] = pool.color[last];
+            continue;
+        }
+        ++i;
+    }
+
+    // Integrate separately so this loop stays branch-free
+    for (std::size_t j = 0; j < pool.count; j++) {
+        pool.vy[j] += pool.gravity[j] * seconds;
+        pool.x[j] += pool.vx[j] * seconds;
+        pool.y[j] += pool.vy[j] * seconds;
+    }
+}
+
+void ParticleSystem::update(float seconds) {
+    for (Pool& pool : m_pools) updatePool(pool, seconds);
+}
+
+void ParticleSystem::clear() {
+    for (Pool& pool : m_pools) pool.count = 0;
+}
+
+void ParticleSystem::drawPool(sf::RenderTarget& target, const Pool& pool, const sf::BlendMode& blendMode) {
+    if (pool.count == 0) return;
+
+    // Each particle is a quad that shrinks and fades as it ages
+    for (std::size_t i = 0; i < pool.count; i++) {
+        float remaining = 1.f - pool.age[i] / pool.lifetime[i];
+        float half = pool.size[i] * (0.5f + 0.5f * remaining) * 0.5f;
+        sf::Color color = pool.color[i];
+        color.a = static_cast<std::uint8_t>(color.a * remaining);
+
+        sf::Vector2f topLeft(pool.x[i] - half, pool.y[i] - half);
+        sf::Vector2f topRight(pool.x[i] + half, pool.y[i] - half);
+        sf::Vector2f bottomLeft(pool.x[i] - half, pool.y[i] + half);
+        sf::Vector2f bottomRight(pool.x[i] + half, pool.y[i] + half);
+
+        sf::Vertex* quad = &m_vertices[i * 6];
+        quad[0] = {topLeft, color};
+        quad[1] = {topRight, color};
+        quad[2] = {bottomLeft, color};
+        quad[3] = {bottomLeft, color};
+        quad[4] = {topRight, color};
+        quad[5] = {bottomRight, color};
+    }
+
+    sf::RenderStates states;
+    states.blendMode = blendMode;
+    target.draw(m_vertices.data(), pool.count * 6, sf::PrimitiveType::Triangles, states);
+}
+
+void ParticleSystem::draw(sf::RenderTarget& target) {
+    drawPool(target, m_pools[static_cast<int>(Blend::Alpha)], sf::BlendAlpha);
+    drawPool(target, m_pools[static_cast<int>(Blend::Additive)], sf::BlendAdd);
+}
+
+std::size_t ParticleSystem::getLiveCount() const {
+    return m_pools[0].count + m_pools[1].count;
+}
@@ -0,0 +1,61 @@
+#ifndef PARTICLE_SYSTEM_HPP
+#define PARTICLE_SYSTEM_HPP
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+// Short-lived sparks, trails and bursts. Particles are stored as a structure
+// of arrays in fixed pools allocated up front, one pool per blend mode, so
+// updating and drawing never allocate. Live particles are kept packed at
+// the front of each pool: an expired particle is overwritten by the last
+// live one, so nothing is ever shifted. When a pool is full new particles
+// are dropped.
+class ParticleSystem {
+public:
+    enum class Blend {
+        Alpha,      // Smoke and debris
+        Additive    // Glowing sparks
+    };
+
+    static constexpr std::size_t Capacity = 16384;  // Per blend mode
+
+    ParticleSystem();
+
+    // Emitters. Positions in pixels; velocities are the simulation's
+    // per-tick vectors (as carried by GameEvent).
+    void emitBounceSparks(sf::Vector2f position, sf::Vector2f velocity);
+    void emitDashTrail(sf::Vector2f position, sf::Color color);
+    void emitDashBurst(sf::Vector2f position, sf::Vector2f direction, sf::Color color);
+    void emitDeathBurst(sf::Vector2f position, sf::Color color);
+
+    void update(float seconds);
+    void clear();
+    void draw(sf::RenderTarget& target);
+
+    std::size_t getLiveCount() const;
+
+private:
+    struct Pool {
+        std::vector<float> x, y;
+        std::vector<float> vx, vy;          // Pixels per second
+        std::vector<float> gravity;         // Pixels per second squared
+        std::vector<float> age, lifetime;   // Seconds
+        std::vector<float> size;            // Side of the quad at birth
+        std::vector<sf::Color> color;
+        std::size_t count = 0;
+    };
+
+    void spawn(Blend blend, sf::Vector2f position, sf::Vector2f velocity, float gravity, float lifetime,
+               float size, sf::Color color);
+    void updatePool(Pool& pool, float seconds);
+    void drawPool(sf::RenderTarget& target, const Pool& pool, const sf::BlendMode& blendMode);
+    float random(float min, float max);
+
+    Pool m_pools[2];
+    std::vector<sf::Vertex> m_vertices;     // Scratch, sized for a full pool
+    std::minstd_rand m_rng;
+};
+
+#endif
@@ -0,0 +1,110 @@
+// Physics substepping benchmark.
+//
+// Plays bot matches on one thread at every supported substep count (60, 120,
+// 240 and 480 Hz physics) and reports how long World::step takes per 60 Hz
+// tick and per substep, so the cost of the quality setting can be read off
+// before picking one for a machine:
+//
+//   ./dino_physics_bench --ticks 100000
+//
+// --jobs N runs each substep's stages on a pool of N workers, as the runner
+// does with --sim-threads, to compare against the single-threaded step.
+//
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "world.hpp"
+#include "bot.hpp"
+#include "level.hpp"
+#include "tuning.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+struct Result {
+    int substeps = 0;
+    long long ticks = 0;
+    int matches = 0;
+    double stepSeconds = 0.0;   // Time spent inside World::step only
+};
+
+// Plays matches back to back until at least tickBudget ticks have run
+Result measure(int substeps, long long tickBudget, std::uint32_t seed, int players, ThreadPool* jobs) {
+    Tuning tuning;
+    tuning.physicsSubsteps = substeps;
+
+    Result result;
+    result.substeps = substeps;
+    const auto& levels = builtinLevels();
+    const int maxTicks = 60 * 90;
+
+    while (result.ticks < tickBudget) {
+        int index = result.matches++;
+        World world(levels[index % levels.size()], tuning);
+        world.setJobPool(jobs);
+        std::vector<Bot> bots;
+        for (int i = 0; i < players; ++i) {
+            world.addPlayer(-1);
+            bots.emplace_back(seed + index * 16 + i);
+        }
+
+        std::vector<PlayerInput> inputs(players);
+        while (world.getAliveCount() > 1 && world.getTick() < maxTicks) {
+            for (int i = 0; i < players; ++i) {
+                inputs[i] = bots[i].think(world, i);
+            }
+            auto start = std::chrono::steady_clock::now();
+            world.step(inputs);
+            result.stepSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        result.ticks += world.getTick();
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    long long tickBudget = 60 * 60 * 10;    // Ten minutes of game time per setting
+    std::uint32_t seed = 1;
+    int players = World::MaxPlayers;
+    int jobs = 0;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--ticks") tickBudget = std::stoll(argv[i + 1]);
+        else if (arg == "--seed") seed = std::stoul(argv[i + 1]);
+        else if (arg == "--players") players = std::stoi(argv[i + 1]);
+        else if (arg == "--jobs") jobs = std::stoi(argv[i + 1]);
+        else {
+            std::cerr << "Usage: dino_physics_bench [--ticks N] [--seed N] [--players N] [--jobs N]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::unique_ptr<ThreadPool> pool;
+    if (jobs > 0) pool = std::make_unique<ThreadPool>(jobs);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "substeps  physics_hz  matches     ticks  us_per_tick  us_per_substep  cpu_at_60hz\n";
+
+    double baseline = 0.0;
+    for (int substeps : {1, 2, 4, 8}) {
+        Result r = measure(substeps, tickBudget, seed, players, pool.get());
+        double perTick = r.ticks ? r.stepSeconds * 1e6 / r.ticks : 0.0;
+        if (substeps == 1) baseline = perTick;
+        std::cout << std::setw(8) << r.substeps
+                  << std::setw(12) << 60 * r.substeps
+                  << std::setw(9) << r.matches
+                  << std::setw(10) << r.ticks
+                  << std::setw(13) << perTick
+                  << std::setw(16) << perTick / r.substeps
+                  << std::setw(12) << perTick * 60.0 / 1e4 << "%\n";
+    }
+    std::cout << "(cpu_at_60hz: share of one core spent on physics at 60 ticks per second; "
+              << "1 substep costs " << baseline << " us per tick)" << std::endl;
+    return 0;
+}
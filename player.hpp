@@ -5,8 +5,9 @@
 
 #include <SFML/Graphics.hpp>
 #include <vector>
-#include <optional>
-#include <memory>  // For shared_ptr
+#include "character_controller.hpp"
+#include "input.hpp"
+#include "tuning.hpp"
 
 
 
@@ -31,9 +32,15 @@ class Player {
                 // Add more states as needed (Jumping, Dashing, etc.)
             };
 
-            Player(float x, float y, int id, int controllerId, std::shared_ptr<sf::Texture> texture); // Constructor takes starting position and texture
+            // Constructor takes starting position. Drawing is done by the Renderer
+            // from snapshots, so a player needs no textures.
+            Player(float x, float y, int id, int controllerId, const Tuning& tuning = Tuning());
         
-            void handleInput();
+            void handleInput(const PlayerInput& input);
+
+            // Back to how a new player starts, at position, keeping the id,
+            // controller and tuning. For rematches; allocates nothing.
+            void respawn(sf::Vector2f position);
             
             
             // We'll need functions to get the player's bounding box for collision later
@@ -51,12 +58,26 @@ class Player {
 
 
             void handleThrowInput(bool throwPressed, sf::Vector2f aimDirection); 
-            void update(const std::vector<sf::RectangleShape>& tiles);
-            void draw(sf::RenderWindow& window);
-            void drawAimIndicator(sf::RenderWindow& window);
+
+            // One 60 Hz tick of physics is beginTick(), then substep() once per
+            // physics substep, then endTick(). Timers and the dash run per tick,
+            // motion and collision per substep, animation once at the end.
+            void beginTick();
+            void substep(const TileGrid& grid, const PhysicsStep& step);
+            void endTick();
 
             sf::FloatRect getBounds() const;
             sf::Vector2f getPosition() const;
+            sf::Vector2f getVelocity() const;
+            bool isGrounded() const;
+            const CollisionContacts& getContacts() const;   // Faces that hit a tile during the last tick
+            State getState() const;
+            bool canDash() const;                           // Whether a dash pressed now would start
+            sf::Vector2f getAimDirection() const;
+
+            // Animation, for building render snapshots
+            int getAnimationFrame() const;  // Frame index in the 24x24 sprite sheet
+            bool isFacingRight() const;
                 
             int getId() const;
             bool isAlive() const;
@@ -66,8 +87,44 @@ class Player {
             // This is now a "getter" to signal the main loop
             bool getReadyToThrow() const; 
             sf::Vector2f releaseThrow(); 
+            sf::Vector2f getThrowVelocity() const; // Velocity releaseThrow() would return now
             bool isDeathAnimationComplete() const;
 
+            // Calls visit(name, value) for every field that carries over from
+            // one tick to the next, in a fixed order. World hashes players
+            // through this every tick, and dino_desync names the field two
+            // runs disagree on with it, so a new field belongs here too.
+            template <typename Visitor>
+            void visitState(Visitor& visit) const {
+                visit("id", m_id);
+                visit("controllerId", m_controllerId);
+                visit("position", m_position);
+                visit("shapePosition", m_shape.getPosition());
+                visit("velocity", m_velocity);
+                visit("grounded", m_isGrounded);
+                visit("contacts.ground", m_contacts.ground);
+                visit("contacts.ceiling", m_contacts.ceiling);
+                visit("contacts.wallLeft", m_contacts.wallLeft);
+                visit("contacts.wallRight", m_contacts.wallRight);
+                visit("state", m_state);
+                visit("dashDirection", m_dashDirection);
+                visit("dashSpeed", m_dashSpeed);
+                visit("dashTicks", m_dashTicks);
+                visit("dashCooldownTicks", m_dashCooldownTicks);
+                visit("gravityActive", m_gravityActive);
+                visit("chargingThrow", m_isChargingThrow);
+                visit("readyToThrow", m_readyToThrow);
+                visit("aimDirection", m_aimDirection);
+                visit("alive", m_isAlive);
+                visit("deathAnimationComplete", m_deathAnimationComplete);
+                visit("frame.x", m_currentFrame.position.x);
+                visit("frame.y", m_currentFrame.position.y);
+                visit("facingRight", m_facingRight);
+                visit("animationTime", m_animationTime);
+                visit("animationSpeed", m_animationSpeed);
+                visit("animation", m_currentAnimation);
+            }
+
            
 
         private:
@@ -75,35 +132,29 @@ class Player {
             sf::Vector2f m_position;
             sf::Vector2f m_velocity;
             bool m_isGrounded;
+            CollisionContacts m_contacts;
+
+            Tuning m_tuning;
 
             State m_state;
             sf::Vector2f m_dashDirection;
             float m_dashSpeed;
-            sf::Time m_dashDuration;
-            sf::Clock m_dashTimer;
-            sf::Time m_dashCooldown;
-            sf::Clock m_dashCooldownTimer;
+            int m_dashTicks;              // Ticks spent in the current dash
+            int m_dashCooldownTicks;      // Ticks until the next dash is allowed
+            bool m_gravityActive;         // Whether this tick's substeps apply gravity
 
             // New variables for charging the boomerang throw
             bool m_isChargingThrow;
-            sf::Clock m_throwChargeTimer;
 
             bool m_readyToThrow; 
             sf::Vector2f m_aimDirection;
 
-            // Aim indicator
-            std::shared_ptr<sf::Texture> m_aimArrowTexture;
-            std::optional<sf::Sprite> m_aimArrowSprite;
-            float m_aimIndicatorDistance;
-
             int m_id;
             bool m_isAlive;
             bool m_deathAnimationComplete;
             int m_controllerId;
 
             // Animation members
-            std::shared_ptr<sf::Texture> m_texture;
-            sf::Sprite m_sprite;
             sf::IntRect m_currentFrame;
             sf::Vector2i m_spriteSize;
             bool m_facingRight;
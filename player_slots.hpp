@@ -0,0 +1,25 @@
+#ifndef PLAYER_SLOTS_HPP
+#define PLAYER_SLOTS_HPP
+
+#include <SFML/Graphics.hpp>
+
+// A local match seats up to 16 dinos, humans and bots in any mix. Slots are
+// numbered by player id and only differ in colour: every dino is drawn from
+// the same sprite sheet, tinted with its slot's colour.
+constexpr int MAX_PLAYERS = 16;
+
+// Controller id of a slot played by a bot (-1 is the keyboard)
+constexpr int BOT_CONTROLLER = -2;
+
+// The first four are the original green, blue, magenta and red
+inline sf::Color playerColor(int id) {
+    static const sf::Color colors[MAX_PLAYERS] = {
+        sf::Color(60, 220, 60),    sf::Color(70, 110, 255),   sf::Color(230, 60, 230),   sf::Color(235, 50, 50),
+        sf::Color(255, 200, 40),   sf::Color(40, 220, 220),   sf::Color(255, 140, 30),   sf::Color(150, 90, 255),
+        sf::Color(160, 240, 90),   sf::Color(255, 120, 170),  sf::Color(40, 150, 120),   sf::Color(200, 200, 200),
+        sf::Color(140, 100, 60),   sf::Color(100, 180, 255),  sf::Color(200, 40, 110),   sf::Color(110, 110, 110)
+    };
+    return id >= 0 && id < MAX_PLAYERS ? colors[id] : sf::Color::White;
+}
+
+#endif
@@ -0,0 +1,66 @@
+#include "presenter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+Presenter::Presenter(Scaling scaling)
+    : m_scaling(scaling)
+    , m_placedFor(0, 0)
+{
+    if (!m_canvas.resize({CanvasWidth, CanvasHeight})) {
+        std::cerr << "Error: Could not create the " << CanvasWidth << "x" << CanvasHeight << " canvas" << std::endl;
+    }
+    // Whole-number scales copy pixels as they are; anything else is blended
+    // so uneven pixel sizes don't shimmer as things move
+    m_canvas.setSmooth(m_scaling == Scaling::Fit);
+}
+
+bool Presenter::parseScaling(const std::string& name, Scaling& scaling) {
+    if (name == "fit") scaling = Scaling::Fit;
+    else if (name == "integer") scaling = Scaling::Integer;
+    else return false;
+    return true;
+}
+
+const char* Presenter::scalingName(Scaling scaling) {
+    return scaling == Scaling::Integer ? "integer" : "fit";
+}
+
+sf::Vector2u Presenter::getCanvasSize() const { return {CanvasWidth, CanvasHeight}; }
+
+sf::RenderTarget& Presenter::beginFrame() {
+    m_canvas.clear();
+    return m_canvas;
+}
+
+sf::FloatRect Presenter::getPlacement(sf::Vector2u targetSize) const {
+    float scale = std::min(static_cast<float>(targetSize.x) / CanvasWidth,
+                           static_cast<float>(targetSize.y) / CanvasHeight);
+    if (m_scaling == Scaling::Integer && scale >= 1.f) scale = std::floor(scale);
+
+    // Centred, on whole pixels so the bars are crisp
+    sf::Vector2f size(CanvasWidth * scale, CanvasHeight * scale);
+    sf::Vector2f offset(std::floor((targetSize.x - size.x) / 2.f), std::floor((targetSize.y - size.y) / 2.f));
+    return {offset, size};
+}
+
+void Presenter::present(sf::RenderTarget& target, sf::Vector2u targetSize) {
+    m_canvas.display();
+
+    if (targetSize != m_placedFor) {
+        m_placedFor = targetSize;
+        sf::FloatRect placement = getPlacement(targetSize);
+        sf::Vector2f topLeft = placement.position;
+        sf::Vector2f bottomRight = placement.position + placement.size;
+        sf::Vector2f canvas(CanvasWidth, CanvasHeight);
+        m_quad[0] = {topLeft, sf::Color::White, {0.f, 0.f}};
+        m_quad[1] = {{bottomRight.x, topLeft.y}, sf::Color::White, {canvas.x, 0.f}};
+        m_quad[2] = {{topLeft.x, bottomRight.y}, sf::Color::White, {0.f, canvas.y}};
+        m_quad[3] = {bottomRight, sf::Color::White, canvas};
+    }
+
+    // One pixel per unit, however the window has been resized
+    target.setView(sf::View(sf::FloatRect({0.f, 0.f}, sf::Vector2f(targetSize))));
+    target.clear(sf::Color::Black);
+    target.draw(m_quad.data(), m_quad.size(), sf::PrimitiveType::TriangleStrip, sf::RenderStates(&m_canvas.getTexture()));
+}
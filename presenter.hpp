@@ -0,0 +1,53 @@
+#ifndef PRESENTER_HPP
+#define PRESENTER_HPP
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <string>
+#include "level.hpp"
+
+// The game is drawn into a fixed-size canvas, exactly the arena's size, and
+// the canvas is copied to the window in one textured quad. Drawing costs the
+// same on an 800x560 window as on a 4K cabinet display, and the whole arena
+// is always on screen whatever the window's shape; what's left over is
+// filled with black bars.
+//
+//   Fit       as large as fits, at any scale; smoothed when it isn't whole
+//   Integer   the largest whole-number scale that fits, pixel for pixel
+//             (falls back to Fit on windows smaller than the canvas)
+class Presenter {
+public:
+    enum class Scaling {
+        Fit,
+        Integer
+    };
+
+    static constexpr unsigned int CanvasWidth = static_cast<unsigned int>(ARENA_COLUMNS * TILE_SIZE);
+    static constexpr unsigned int CanvasHeight = static_cast<unsigned int>(ARENA_ROWS * TILE_SIZE);
+
+    // Creates the canvas; call on the thread that draws
+    explicit Presenter(Scaling scaling = Scaling::Fit);
+
+    static bool parseScaling(const std::string& name, Scaling& scaling);
+    static const char* scalingName(Scaling scaling);
+
+    sf::Vector2u getCanvasSize() const;
+
+    // Clears the canvas for a new frame and returns it to draw into
+    sf::RenderTarget& beginFrame();
+
+    // Copies the canvas onto target, a window of targetSize pixels. Call
+    // display() on the window afterwards.
+    void present(sf::RenderTarget& target, sf::Vector2u targetSize);
+
+    // Where the canvas lands in a targetSize window
+    sf::FloatRect getPlacement(sf::Vector2u targetSize) const;
+
+private:
+    Scaling m_scaling;
+    sf::RenderTexture m_canvas;
+    std::array<sf::Vertex, 4> m_quad;
+    sf::Vector2u m_placedFor;   // Window size m_quad was laid out for
+};
+
+#endif
@@ -0,0 +1,97 @@
+#include "render_snapshot.hpp"
+#include "world.hpp"
+#include <cmath>
+
+static_assert(RenderSnapshot::MaxPlayers >= World::MaxPlayers, "Snapshot must hold every player");
+
+void captureWorld(const World& world, RenderSnapshot& snapshot) {
+    snapshot.tick = world.getTick();
+
+    snapshot.playerCount = 0;
+    for (const auto& player : world.getPlayers()) {
+        if (snapshot.playerCount == RenderSnapshot::MaxPlayers) break;
+        RenderSnapshot::PlayerView& view = snapshot.players[snapshot.playerCount++];
+        view.position = player.getPosition();
+        view.throwVelocity = player.getThrowVelocity();
+        view.aimDirection = player.getAimDirection();
+        view.id = static_cast<std::uint8_t>(player.getId());
+        view.frame = static_cast<std::uint8_t>(player.getAnimationFrame());
+        view.state = static_cast<std::uint8_t>(player.getState());
+        view.facingRight = player.isFacingRight();
+        view.alive = player.isAlive();
+        view.chargingThrow = player.isChargingThrow();
+    }
+
+    snapshot.boomerangCount = 0;
+    for (const auto& boomerang : world.getBoomerangs()) {
+        if (boomerang.getState() == Boomerang::State::Caught) continue;
+        if (snapshot.boomerangCount == RenderSnapshot::MaxBoomerangs) break;
+        RenderSnapshot::BoomerangView& view = snapshot.boomerangs[snapshot.boomerangCount++];
+        view.position = boomerang.getPosition();
+        view.rotation = boomerang.getRotation();
+        view.ownerId = static_cast<std::uint8_t>(boomerang.getOwnerId());
+        view.state = static_cast<std::uint8_t>(boomerang.getState());
+    }
+}
+
+void captureScores(const World& world, RenderSnapshot& snapshot) {
+    snapshot.kills.fill(0);
+    for (const auto& kill : world.getKills()) {
+        if (kill.killerId >= 0 && kill.killerId < RenderSnapshot::MaxPlayers) ++snapshot.kills[kill.killerId];
+    }
+    snapshot.matchTicks = world.getTick();
+}
+
+static sf::Vector2f lerp(sf::Vector2f from, sf::Vector2f to, float alpha) {
+    return from + (to - from) * alpha;
+}
+
+static float lerpAngle(float from, float to, float alpha) {
+    // Take the short way round so 350 -> 10 doesn't spin backwards
+    float delta = std::fmod(to - from + 540.0f, 360.0f) - 180.0f;
+    float angle = from + delta * alpha;
+    if (angle >= 360.0f) angle -= 360.0f;
+    if (angle < 0.0f) angle += 360.0f;
+    return angle;
+}
+
+void interpolateSnapshots(const RenderSnapshot& previous, const RenderSnapshot& current, float alpha,
+                          RenderSnapshot& out) {
+    out = current;
+
+    // Only neighbouring ticks of one state blend: across a skipped tick alpha
+    // would cover the wrong span, and across a rematch respawn or a switch
+    // into or out of the killcam the same id is somewhere else entirely
+    if (current.tick != previous.tick + 1 || current.gameState != previous.gameState) return;
+
+    // Where each id sits in previous, so matching stays linear in players
+    std::array<std::int8_t, RenderSnapshot::MaxPlayers> previousIndex;
+    previousIndex.fill(-1);
+    for (int j = 0; j < previous.playerCount; j++) {
+        if (previous.players[j].id < RenderSnapshot::MaxPlayers) {
+            previousIndex[previous.players[j].id] = static_cast<std::int8_t>(j);
+        }
+    }
+
+    for (int i = 0; i < out.playerCount; i++) {
+        RenderSnapshot::PlayerView& player = out.players[i];
+        int j = player.id < RenderSnapshot::MaxPlayers ? previousIndex[player.id] : -1;
+        if (j >= 0) player.position = lerp(previous.players[j].position, player.position, alpha);
+    }
+
+    std::array<std::int8_t, RenderSnapshot::MaxPlayers> previousBoomerang;
+    previousBoomerang.fill(-1);
+    for (int j = 0; j < previous.boomerangCount; j++) {
+        if (previous.boomerangs[j].ownerId < RenderSnapshot::MaxPlayers) {
+            previousBoomerang[previous.boomerangs[j].ownerId] = static_cast<std::int8_t>(j);
+        }
+    }
+
+    for (int i = 0; i < out.boomerangCount; i++) {
+        RenderSnapshot::BoomerangView& boomerang = out.boomerangs[i];
+        int j = boomerang.ownerId < RenderSnapshot::MaxPlayers ? previousBoomerang[boomerang.ownerId] : -1;
+        if (j < 0) continue;
+        boomerang.position = lerp(previous.boomerangs[j].position, boomerang.position, alpha);
+        boomerang.rotation = lerpAngle(previous.boomerangs[j].rotation, boomerang.rotation, alpha);
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef RENDER_SNAPSHOT_HPP
+#define RENDER_SNAPSHOT_HPP
+
+#include <SFML/System.hpp>
+#include <array>
+#include <cstdint>
+#include "game_state.hpp"
+#include "player_slots.hpp"
+
+class World;
+
+// Everything the renderer needs to draw one tick, copied out of the
+// simulation so the render thread never touches live Player/Boomerang
+// objects. Fixed size, so publishing one never allocates.
+struct RenderSnapshot {
+    static constexpr int MaxPlayers = MAX_PLAYERS;
+    static constexpr int MaxBoomerangs = 16;
+
+    struct PlayerView {
+        sf::Vector2f position;
+        sf::Vector2f throwVelocity;     // Where a throw would go right now
+        sf::Vector2f aimDirection;
+        std::uint8_t id;
+        std::uint8_t frame;             // Index in the 24x24 sprite sheet
+        std::uint8_t state;             // Player::State
+        bool facingRight;
+        bool alive;
+        bool chargingThrow;
+    };
+
+    struct BoomerangView {
+        sf::Vector2f position;
+        float rotation;                 // Degrees
+        std::uint8_t ownerId;
+        std::uint8_t state;             // Boomerang::State
+    };
+
+    std::uint64_t tick = 0;
+    sf::Time time;                      // When this tick was due, on the runner's clock
+    GameState gameState = GameState::MainMenu;
+    int backgroundIndex = 0;
+    int nextBackgroundIndex = -1;       // Already picked for the next match, so it can be made ready
+    int joinedCount = 0;                // Players shown on the join screen
+
+    // Latest controller change consumed by the simulation, for measuring
+    // input latency. The sequence number goes up with every change.
+    std::uint32_t inputSequence = 0;
+    sf::Time inputTime;                 // When that change was sampled
+
+    // Scoreboard for the HUD, indexed by player id. Kept separately from the
+    // players above, which lose an entry when a dino dies and are replaced
+    // by the replay during the killcam.
+    int scoreCount = 0;                 // Players who started the match
+    std::array<std::uint8_t, MaxPlayers> kills{};
+    std::array<std::uint8_t, MaxPlayers> wins{};
+    int matchTicks = 0;
+
+    int playerCount = 0;
+    int boomerangCount = 0;
+    std::array<PlayerView, MaxPlayers> players;
+    std::array<BoomerangView, MaxBoomerangs> boomerangs;
+};
+
+// Copies the drawable state of every player and boomerang into snapshot
+void captureWorld(const World& world, RenderSnapshot& snapshot);
+
+// Fills the kill counts and match time; wins and scoreCount are up to the caller
+void captureScores(const World& world, RenderSnapshot& snapshot);
+
+// Blends two consecutive ticks for displays faster than the simulation.
+// alpha 0 gives previous, 1 gives current. Players are matched by id and
+// boomerangs by owner (one in flight each); anything that only exists in
+// current is drawn where current has it. Everything but positions and
+// boomerang rotation is taken from current. Unless current is the tick
+// right after previous in the same game state, out is just current.
+void interpolateSnapshots(const RenderSnapshot& previous, const RenderSnapshot& current, float alpha,
+                          RenderSnapshot& out);
+
+#endif
@@ -0,0 +1,511 @@
+#include "renderer.hpp"
+#include "boomerang.hpp"
+#include "player.hpp"
+#include "player_slots.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+static sf::Color indicatorColor(int playerId) {
+    // Aim indicator color based on player ID
+    sf::Color color = playerColor(playerId);
+    color.a = 220; // Add some transparency
+    return color;
+}
+
+// Segments in a boomerang's debug circle (the same as sf::CircleShape)
+static constexpr int RingSegments = 30;
+
+// Two triangles; corners go round the quad starting top left
+static void appendQuad(std::vector<sf::Vertex>& vertices, const sf::Vector2f (&corners)[4],
+                       const sf::Vector2f (&texCoords)[4], sf::Color color) {
+    static const int order[6] = {0, 1, 3, 3, 1, 2};
+    for (int i : order) {
+        vertices.push_back({corners[i], color, texCoords[i]});
+    }
+}
+
+static void appendRect(std::vector<sf::Vertex>& vertices, sf::FloatRect rect, sf::Color color) {
+    sf::Vector2f end = rect.position + rect.size;
+    const sf::Vector2f corners[4] = {rect.position, {end.x, rect.position.y}, end, {rect.position.x, end.y}};
+    const sf::Vector2f none[4] = {};
+    appendQuad(vertices, corners, none, color);
+}
+
+// An outline drawn outside rect, like a shape's outline thickness
+static void appendOutline(std::vector<sf::Vertex>& vertices, sf::FloatRect rect, float thickness, sf::Color color) {
+    sf::Vector2f start = rect.position - sf::Vector2f(thickness, thickness);
+    float width = rect.size.x + 2.f * thickness;
+    float height = rect.size.y + 2.f * thickness;
+    appendRect(vertices, sf::FloatRect(start, {width, thickness}), color);
+    appendRect(vertices, sf::FloatRect({start.x, start.y + height - thickness}, {width, thickness}), color);
+    appendRect(vertices, sf::FloatRect({start.x, rect.position.y}, {thickness, rect.size.y}), color);
+    appendRect(vertices, sf::FloatRect({start.x + width - thickness, rect.position.y}, {thickness, rect.size.y}), color);
+}
+
+static void appendRing(std::vector<sf::Vertex>& vertices, sf::Vector2f center, float radius, float thickness,
+                       sf::Color color) {
+    static const std::array<sf::Vector2f, RingSegments + 1> directions = [] {
+        std::array<sf::Vector2f, RingSegments + 1> result;
+        for (int i = 0; i <= RingSegments; ++i) {
+            float angle = 2.f * 3.14159265f * i / RingSegments;
+            result[i] = {std::cos(angle), std::sin(angle)};
+        }
+        return result;
+    }();
+    const sf::Vector2f none[4] = {};
+    for (int i = 0; i < RingSegments; ++i) {
+        const sf::Vector2f corners[4] = {
+            center + directions[i] * radius, center + directions[i + 1] * radius,
+            center + directions[i + 1] * (radius + thickness), center + directions[i] * (radius + thickness)
+        };
+        appendQuad(vertices, corners, none, color);
+    }
+}
+
+Renderer::Renderer(sf::Vector2u canvasSize, const Level& level, const Tuning& tuning)
+    : m_canvasSize(canvasSize)
+    , m_tuning(tuning)
+    , m_selectedBackgroundIndex(-1)
+    , m_warmedBackgroundIndex(-1)
+    , m_aimIndicatorDistance(50.0f)
+    , m_lastTrailTick(0)
+{
+    const float canvasWidth = static_cast<float>(canvasSize.x);
+    const float canvasHeight = static_cast<float>(canvasSize.y);
+
+    // Load main menu background
+    if(!m_menuBackgroundTexture.loadFromFile("assets/mc_bg.jpg")){
+        std::cerr << "Error: Could not load menu background image!" << std::endl;
+    }
+    m_menuBackgroundSprite.emplace(m_menuBackgroundTexture);
+
+    // Scale menu background
+    sf::Vector2u menuBgSize = m_menuBackgroundTexture.getSize();
+    if (menuBgSize.x > 0 && menuBgSize.y > 0) {
+        m_menuBackgroundSprite->setScale({canvasWidth / menuBgSize.x, canvasHeight / menuBgSize.y});
+    }
+
+    // Load gameplay backgrounds (array of possible backgrounds)
+    std::vector<std::string> gameplayBackgroundFiles = {
+        "assets/clouds.jpg",
+        "assets/cyberpunk2_bg.jpg",
+        "assets/cyberpunk_background.png",
+        "assets/minecraft_bg.jpg",
+        "assets/minecarft_bg.jpg"
+    };
+
+    for (const auto& filename : gameplayBackgroundFiles) {
+        sf::Texture texture;
+        if (texture.loadFromFile(filename)) {
+            sf::Vector2u bgSize = texture.getSize();
+            m_gameplayBackgroundScales.push_back({canvasWidth / bgSize.x, canvasHeight / bgSize.y});
+            m_gameplayBackgroundTextures.push_back(std::move(texture));
+        } else {
+            std::cerr << "Warning: Could not load background " << filename << std::endl;
+        }
+    }
+    // Sprite for gameplay background (initialize with first texture if available)
+    m_gameplayBackgroundSprite.emplace(m_gameplayBackgroundTextures.empty() ? m_menuBackgroundTexture
+                                                                            : m_gameplayBackgroundTextures[0]);
+    selectBackground(0);
+
+    // Load grass texture and build the visual tiles
+    if (!m_grassTexture.loadFromFile("assets/grass_tile.png")) {
+        std::cerr << "Error: Could not load grass texture!" << std::endl;
+    }
+    m_tiles = buildTiles(level, &m_grassTexture);
+
+    // Create dark overlay for main menu to make UI elements stand out
+    m_menuOverlay.setSize({canvasWidth, canvasHeight});
+    m_menuOverlay.setFillColor(sf::Color(0, 0, 0, 150)); // Semi-transparent black (alpha: 150/255)
+
+    // Load boomerang texture once (shared by all boomerangs)
+    if (!m_boomerangTexture.loadFromFile("vite_boomerang.png")) {
+        std::cerr << "Error: Could not load boomerang texture!" << std::endl;
+    }
+
+    // Load aim arrow texture once (shared by all players)
+    if (!m_aimArrowTexture.loadFromFile("assets/aim_arrow.png")) {
+        std::cerr << "Error: Could not load aim arrow texture!" << std::endl;
+    }
+
+    // One dino sheet for every slot. Only its brightness is kept, stretched
+    // so the lightest pixel is white; each slot's tint then sets the colour,
+    // which works as a palette swap without a texture per player.
+    sf::Image dinoImage;
+    if (!dinoImage.loadFromFile("assets/DinoSprites - doux.png")) {
+        std::cerr << "Error: Could not load dino texture assets/DinoSprites - doux.png" << std::endl;
+    } else {
+        sf::Vector2u size = dinoImage.getSize();
+        auto brightness = [](sf::Color c) { return (299 * c.r + 587 * c.g + 114 * c.b) / 1000; };
+        int brightest = 1;
+        for (unsigned int y = 0; y < size.y; y++) {
+            for (unsigned int x = 0; x < size.x; x++) {
+                sf::Color pixel = dinoImage.getPixel({x, y});
+                if (pixel.a > 0) brightest = std::max(brightest, brightness(pixel));
+            }
+        }
+        for (unsigned int y = 0; y < size.y; y++) {
+            for (unsigned int x = 0; x < size.x; x++) {
+                sf::Color pixel = dinoImage.getPixel({x, y});
+                auto grey = static_cast<std::uint8_t>(std::min(255, brightness(pixel) * 255 / brightest));
+                dinoImage.setPixel({x, y}, sf::Color(grey, grey, grey, pixel.a));
+            }
+        }
+        if (!m_dinoSheet.loadFromImage(dinoImage)) {
+            std::cerr << "Error: Could not create the dino texture" << std::endl;
+        }
+    }
+    m_batch.reserve(RenderSnapshot::MaxBoomerangs * RingSegments * 6);
+
+    // Load p1-p4 indicator textures; slots past the fourth are told apart by colour
+    m_playerIndicatorTextures.resize(4);
+    std::string indicatorFiles[4] = {
+        "assets/p1.png",
+        "assets/p2.png",
+        "assets/p3.png",
+        "assets/p4.png"
+    };
+
+    for (int i = 0; i < 4; i++) {
+        m_playerIndicatorTextures[i] = std::make_shared<sf::Texture>();
+        if (!m_playerIndicatorTextures[i]->loadFromFile(indicatorFiles[i])) {
+            std::cerr << "Error: Could not load indicator texture " << indicatorFiles[i] << std::endl;
+        } else {
+            sf::Sprite sprite(*m_playerIndicatorTextures[i]);
+            // Position indicators at bottom of screen, spread out
+            float spacing = canvasWidth / 5.0f; // Divide screen into 5 sections for 4 indicators
+            float yPosition = canvasHeight - 80.0f; // 80 pixels from bottom
+            sprite.setPosition({spacing * (i + 1) - m_playerIndicatorTextures[i]->getSize().x / 2.0f, yPosition});
+            sprite.setScale({2.0f, 2.0f}); // Scale up the indicators
+            m_playerIndicatorSprites.push_back(sprite);
+        }
+    }
+
+    // Load game over and restart textures
+    if (!m_gameOverTexture.loadFromFile("assets/gameover.png")) {
+        std::cerr << "Error: Could not load game over image!" << std::endl;
+    }
+    m_gameOverSprite.emplace(m_gameOverTexture);
+
+    if (!m_restartTexture.loadFromFile("assets/restart.png")) {
+        std::cerr << "Error: Could not load restart image!" << std::endl;
+    }
+    m_restartSprite.emplace(m_restartTexture);
+
+    // Position game over and restart sprites
+    m_gameOverSprite->setOrigin(sf::Vector2f(m_gameOverTexture.getSize()) / 2.0f);
+    m_gameOverSprite->setPosition(sf::Vector2f(canvasWidth / 2.0f, canvasHeight / 2.0f - 50));
+    m_gameOverSprite->setScale({3.0f, 3.0f});
+
+    m_restartSprite->setOrigin(sf::Vector2f(m_restartTexture.getSize()) / 2.0f);
+    m_restartSprite->setPosition(sf::Vector2f(canvasWidth / 2.0f, canvasHeight / 2.0f + 100));
+    m_restartSprite->setScale({3.0f, 3.0f});
+
+    // Create semi-transparent overlay
+    m_overlay.setSize({canvasWidth, canvasHeight});
+    m_overlay.setFillColor(sf::Color(0, 0, 0, 180)); // Semi-transparent black
+
+    // Killcam: letterbox bars and a blinking "recording" dot
+    m_letterbox.setSize({canvasWidth, canvasHeight * 0.08f});
+    m_letterbox.setFillColor(sf::Color::Black);
+    m_replayDot.setRadius(8.f);
+    m_replayDot.setOrigin({8.f, 8.f});
+    m_replayDot.setPosition({24.f, canvasHeight * 0.04f});
+    m_replayDot.setFillColor(sf::Color(220, 30, 30));
+
+    if (!m_titleCardTexture.loadFromFile("assets/titlecard.png")) {
+        std::cerr << "Error: Could not load title card image!" << std::endl;
+    }
+    m_titleCardSprite.emplace(m_titleCardTexture);
+
+    // Load "Press any button to join" text art
+    if (!m_joinPromptTexture.loadFromFile("assets/pabtj.png")) {
+        std::cerr << "Error: Could not load join prompt image!" << std::endl;
+    }
+    m_joinPromptSprite.emplace(m_joinPromptTexture);
+
+    // Title card centered at the top of the screen
+    sf::Vector2u titleSize = m_titleCardTexture.getSize();
+    m_titleCardSprite->setScale({2.5f, 2.5f});
+    m_titleCardSprite->setPosition({
+        (canvasWidth - (titleSize.x * m_titleCardSprite->getScale().x)) / 2.0f,
+        50.0f
+    });
+
+    // Join prompt in the middle area of the screen, above the player indicators
+    float joinPromptY = 220.0f;
+    m_joinPromptSprite->setScale({2.0f, 2.0f});
+    m_joinPromptSprite->setPosition({
+        (canvasWidth - (m_joinPromptTexture.getSize().x * m_joinPromptSprite->getScale().x)) / 2.0f,
+        joinPromptY
+    });
+}
+
+int Renderer::getBackgroundCount() const {
+    return static_cast<int>(m_gameplayBackgroundTextures.size());
+}
+
+void Renderer::selectBackground(int index) {
+    if (index == m_selectedBackgroundIndex || index < 0 || index >= getBackgroundCount()) return;
+    m_selectedBackgroundIndex = index;
+    m_gameplayBackgroundSprite->setTexture(m_gameplayBackgroundTextures[index]);
+    m_gameplayBackgroundSprite->setScale(m_gameplayBackgroundScales[index]);
+}
+
+void Renderer::warmBackground(sf::RenderTarget& target, int index) {
+    if (index == m_warmedBackgroundIndex || index < 0 || index >= getBackgroundCount()) return;
+    m_warmedBackgroundIndex = index;
+    sf::Sprite sprite(m_gameplayBackgroundTextures[index]);
+    sprite.setScale(m_gameplayBackgroundScales[index]);
+    sprite.setColor(sf::Color::Transparent);
+    target.draw(sprite);
+}
+
+void Renderer::onEvent(const GameEvent& event) {
+    switch (event.type) {
+        case GameEvent::Type::Bounce:
+            m_particles.emitBounceSparks(event.position, event.vector);
+            break;
+        case GameEvent::Type::Dash:
+            m_particles.emitDashBurst(event.position, event.vector, indicatorColor(event.actorId));
+            break;
+        case GameEvent::Type::Kill:
+            m_particles.emitDeathBurst(event.position, indicatorColor(event.targetId));
+            break;
+        default:
+            break;
+    }
+}
+
+void Renderer::update(const RenderSnapshot& snapshot, float seconds) {
+    if (snapshot.gameState == GameState::MainMenu) {
+        m_particles.clear();
+        return;
+    }
+
+    // Trails are laid down once per simulation tick so their density doesn't
+    // depend on the display's refresh rate
+    if (snapshot.tick != m_lastTrailTick) {
+        m_lastTrailTick = snapshot.tick;
+        for (int i = 0; i < snapshot.playerCount; i++) {
+            const RenderSnapshot::PlayerView& player = snapshot.players[i];
+            if (player.state == static_cast<std::uint8_t>(Player::State::Dashing)) {
+                m_particles.emitDashTrail(player.position, indicatorColor(player.id));
+            }
+        }
+    }
+    m_particles.update(seconds);
+}
+
+void Renderer::draw(sf::RenderTarget& target, const RenderSnapshot& snapshot) {
+    switch (snapshot.gameState) {
+        case GameState::MainMenu:
+            drawMenu(target, snapshot);
+            warmBackground(target, snapshot.nextBackgroundIndex);
+            break;
+
+        case GameState::Gameplay:
+            drawArena(target, snapshot);
+            break;
+
+        case GameState::GameOver:
+            drawArena(target, snapshot);
+            warmBackground(target, snapshot.nextBackgroundIndex);
+
+            // Draw overlay and game over screen
+            target.draw(m_overlay);
+            target.draw(*m_gameOverSprite);
+            target.draw(*m_restartSprite);
+            break;
+
+        case GameState::Replay:
+            drawArena(target, snapshot);
+            warmBackground(target, snapshot.nextBackgroundIndex);
+            drawReplayOverlay(target, snapshot);
+            break;
+    }
+}
+
+void Renderer::drawReplayOverlay(sf::RenderTarget& target, const RenderSnapshot& snapshot) {
+    m_letterbox.setPosition({0.f, 0.f});
+    target.draw(m_letterbox);
+    m_letterbox.setPosition({0.f, m_canvasSize.y - m_letterbox.getSize().y});
+    target.draw(m_letterbox);
+
+    if (std::fmod(snapshot.time.asSeconds(), 1.f) < 0.6f) {
+        target.draw(m_replayDot);
+    }
+}
+
+void Renderer::drawMenu(sf::RenderTarget& target, const RenderSnapshot& snapshot) {
+    target.clear();
+    target.draw(*m_menuBackgroundSprite);
+    target.draw(m_menuOverlay); // Dark overlay to make UI stand out
+    target.draw(*m_titleCardSprite);
+    target.draw(*m_joinPromptSprite);
+
+    // Dino previews for joined players: up to four stand over their p1-p4
+    // indicators, more than that fill two rows of eight
+    const float canvasWidth = static_cast<float>(m_canvasSize.x);
+    const float canvasHeight = static_cast<float>(m_canvasSize.y);
+    int joined = std::min(snapshot.joinedCount, RenderSnapshot::MaxPlayers);
+    for (int i = 0; i < joined && m_dinoSheet.getSize().x > 0; i++) {
+        if (joined <= 4) {
+            float spacing = canvasWidth / 5.0f;
+            addDino({spacing * (i + 1), canvasHeight - 80.0f - 90.0f + 36.0f}, 0, true, 3.0f, playerColor(i));
+        } else {
+            float spacing = canvasWidth / 9.0f;
+            addDino({spacing * (i % 8 + 1), canvasHeight - 150.0f + 80.0f * (i / 8)}, 0, true, 2.5f, playerColor(i));
+        }
+    }
+    flushBatch(target, &m_dinoSheet);
+
+    for (int i = 0; joined <= 4 && i < joined && i < static_cast<int>(m_playerIndicatorSprites.size()); i++) {
+        target.draw(m_playerIndicatorSprites[i]);    // Draw p1-p4 indicator below
+    }
+}
+
+void Renderer::drawArena(sf::RenderTarget& target, const RenderSnapshot& snapshot) {
+    selectBackground(snapshot.backgroundIndex);
+
+    target.clear(sf::Color(50, 50, 150));
+    target.draw(*m_gameplayBackgroundSprite);
+    for (const auto& tile : m_tiles) { target.draw(tile); }
+
+    drawPlayers(target, snapshot);
+
+    // Previews of players who stopped charging (or left) are dropped so they
+    // re-simulate from scratch next time
+    std::array<bool, RenderSnapshot::MaxPlayers> charging{};
+    for (int i = 0; i < snapshot.playerCount; i++) {
+        const RenderSnapshot::PlayerView& player = snapshot.players[i];
+        if (player.chargingThrow && player.id < charging.size()) {
+            charging[player.id] = true;
+            drawAimIndicator(target, player);
+        }
+    }
+    for (size_t id = 0; id < charging.size(); id++) {
+        if (!charging[id]) m_throwPreviews[id].invalidate();
+    }
+
+    drawBoomerangs(target, snapshot);
+
+    m_particles.draw(target);
+}
+
+void Renderer::addDino(sf::Vector2f position, int frame, bool facingRight, float scale, sf::Color tint) {
+    float half = 12.f * scale;
+    const sf::Vector2f corners[4] = {
+        position + sf::Vector2f(-half, -half), position + sf::Vector2f(half, -half),
+        position + sf::Vector2f(half, half), position + sf::Vector2f(-half, half)
+    };
+    // Facing left swaps the left and right edges of the frame
+    float left = frame * 24.f;
+    float right = left + 24.f;
+    if (!facingRight) std::swap(left, right);
+    const sf::Vector2f texCoords[4] = {{left, 0.f}, {right, 0.f}, {right, 24.f}, {left, 24.f}};
+    appendQuad(m_batch, corners, texCoords, tint);
+}
+
+void Renderer::flushBatch(sf::RenderTarget& target, const sf::Texture* texture) {
+    if (!m_batch.empty()) {
+        sf::RenderStates states;
+        states.texture = texture;
+        target.draw(m_batch.data(), m_batch.size(), sf::PrimitiveType::Triangles, states);
+    }
+    m_batch.clear();
+}
+
+void Renderer::drawPlayers(sf::RenderTarget& target, const RenderSnapshot& snapshot) {
+    bool hasSheet = m_dinoSheet.getSize().x > 0;
+
+    // Debug: hitboxes behind the sprites (24x24 sprite * 2.0 scale = 48x48),
+    // or plain boxes if the sheet failed to load
+    for (int i = 0; i < snapshot.playerCount; i++) {
+        const RenderSnapshot::PlayerView& player = snapshot.players[i];
+        sf::FloatRect hitbox(player.position - sf::Vector2f(24.f, 24.f), {48.f, 48.f});
+        appendOutline(m_batch, hitbox, 2.0f, sf::Color::Red);
+        if (!hasSheet) {
+            bool dashing = player.state == static_cast<std::uint8_t>(Player::State::Dashing);
+            appendRect(m_batch, hitbox, dashing ? sf::Color::Yellow : playerColor(player.id));
+        }
+    }
+    flushBatch(target, nullptr);
+
+    if (!hasSheet) return;
+    for (int i = 0; i < snapshot.playerCount; i++) {
+        const RenderSnapshot::PlayerView& player = snapshot.players[i];
+        addDino(player.position, player.frame, player.facingRight, 3.f, playerColor(player.id));
+    }
+    flushBatch(target, &m_dinoSheet);
+}
+
+void Renderer::drawAimIndicator(sf::RenderTarget& target, const RenderSnapshot::PlayerView& player) {
+    sf::Color color = indicatorColor(player.id);
+
+    // Predicted flight path behind the arrow
+    ThrowPreview& preview = m_throwPreviews[player.id];
+    preview.update(player.position, player.throwVelocity, m_tiles, m_tuning, color);
+    preview.draw(target);
+
+    if (m_aimArrowTexture.getSize().x == 0) return;
+
+    // Only show if there's a valid aim direction
+    if (player.aimDirection.x == 0 && player.aimDirection.y == 0) return;
+
+    // Position arrow at a distance from player center in aim direction
+    float playerRadius = 24.0f; // Half of 48x48 hitbox
+    sf::Vector2f arrowPos = player.position + player.aimDirection * (playerRadius + m_aimIndicatorDistance);
+
+    // Calculate rotation angle from aim direction
+    float angle = std::atan2(player.aimDirection.y, player.aimDirection.x) * 180.0f / 3.14159f;
+
+    sf::Sprite arrow(m_aimArrowTexture);
+    sf::Vector2u arrowSize = m_aimArrowTexture.getSize();
+    arrow.setOrigin({arrowSize.x / 2.0f, arrowSize.y / 2.0f});
+    arrow.setScale({2.0f, 2.0f}); // Scale for visibility
+    arrow.setColor(color);
+    arrow.setPosition(arrowPos);
+    arrow.setRotation(sf::degrees(angle));
+    target.draw(arrow);
+}
+
+void Renderer::drawBoomerangs(sf::RenderTarget& target, const RenderSnapshot& snapshot) {
+    if (m_boomerangTexture.getSize().x == 0) {
+        // Fallback to rectangles if texture not loaded
+        float size = m_tuning.boomerangSize;
+        for (int i = 0; i < snapshot.boomerangCount; i++) {
+            sf::Vector2f position = snapshot.boomerangs[i].position;
+            appendRect(m_batch, sf::FloatRect(position - sf::Vector2f(size, size) / 2.0f, {size, size}),
+                       sf::Color::Magenta);
+        }
+        flushBatch(target, nullptr);
+        return;
+    }
+
+    sf::Vector2f textureSize(m_boomerangTexture.getSize());
+    sf::Vector2f half = textureSize * 2.5f / 2.0f;
+    const sf::Vector2f texCoords[4] = {{0.f, 0.f}, {textureSize.x, 0.f}, textureSize, {0.f, textureSize.y}};
+    for (int i = 0; i < snapshot.boomerangCount; i++) {
+        const RenderSnapshot::BoomerangView& boomerang = snapshot.boomerangs[i];
+        float angle = boomerang.rotation * 3.14159265f / 180.0f;
+        sf::Vector2f across(std::cos(angle), std::sin(angle));
+        sf::Vector2f down(-across.y, across.x);
+        const sf::Vector2f corners[4] = {
+            boomerang.position - across * half.x - down * half.y, boomerang.position + across * half.x - down * half.y,
+            boomerang.position + across * half.x + down * half.y, boomerang.position - across * half.x + down * half.y
+        };
+        appendQuad(m_batch, corners, texCoords, sf::Color::White);
+    }
+    flushBatch(target, &m_boomerangTexture);
+
+    // Debug: the circular hitboxes
+    float radius = Boomerang::collisionRadius(m_tuning);
+    for (int i = 0; i < snapshot.boomerangCount; i++) {
+        appendRing(m_batch, snapshot.boomerangs[i].position, radius, 2.0f, sf::Color::Cyan);
+    }
+    flushBatch(target, nullptr);
+}
@@ -0,0 +1,105 @@
+#ifndef RENDERER_HPP
+#define RENDERER_HPP
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "event_bus.hpp"
+#include "level.hpp"
+#include "particle_system.hpp"
+#include "tuning.hpp"
+#include "render_snapshot.hpp"
+#include "throw_preview.hpp"
+
+// Owns every texture and sprite and draws a RenderSnapshot: the menu, the
+// arena with its dinos and boomerangs, and the game over screen. It never
+// looks at the live simulation, so it can run on its own thread.
+//
+// Every dino is drawn from one sprite sheet, tinted with its slot's colour,
+// and all dinos go out in a single vertex batch (as do the boomerangs and
+// the debug hitboxes), so a frame costs the same few draw calls whether 2 or
+// 16 players are in the arena.
+class Renderer {
+public:
+    // Loads all textures; call on the thread that created the window. Every
+    // screen is laid out for a canvasSize target (see Presenter).
+    Renderer(sf::Vector2u canvasSize, const Level& level, const Tuning& tuning);
+
+    int getBackgroundCount() const;
+
+    // Spawns particles for bounces, dashes and kills
+    void onEvent(const GameEvent& event);
+
+    // Advances effects by one rendered frame
+    void update(const RenderSnapshot& snapshot, float seconds);
+
+    void draw(sf::RenderTarget& target, const RenderSnapshot& snapshot);
+
+private:
+    void drawMenu(sf::RenderTarget& target, const RenderSnapshot& snapshot);
+    void drawArena(sf::RenderTarget& target, const RenderSnapshot& snapshot);
+    void drawPlayers(sf::RenderTarget& target, const RenderSnapshot& snapshot);
+    void drawAimIndicator(sf::RenderTarget& target, const RenderSnapshot::PlayerView& player);
+    void drawBoomerangs(sf::RenderTarget& target, const RenderSnapshot& snapshot);
+
+    // Appends a dino standing at position, scale times the sheet's size
+    void addDino(sf::Vector2f position, int frame, bool facingRight, float scale, sf::Color tint);
+    // Sends m_batch to the target, textured or not, and empties it
+    void flushBatch(sf::RenderTarget& target, const sf::Texture* texture);
+    void drawReplayOverlay(sf::RenderTarget& target, const RenderSnapshot& snapshot);
+    void selectBackground(int index);
+    // Draws the background a match is about to use once, invisibly, so the
+    // driver has it resident before its first real frame
+    void warmBackground(sf::RenderTarget& target, int index);
+
+    sf::Vector2u m_canvasSize;
+    Tuning m_tuning;
+
+    // Menu
+    sf::Texture m_menuBackgroundTexture;
+    std::optional<sf::Sprite> m_menuBackgroundSprite;
+    sf::RectangleShape m_menuOverlay;
+    sf::Texture m_titleCardTexture;
+    std::optional<sf::Sprite> m_titleCardSprite;
+    sf::Texture m_joinPromptTexture;
+    std::optional<sf::Sprite> m_joinPromptSprite;
+    std::vector<std::shared_ptr<sf::Texture>> m_playerIndicatorTextures;
+    std::vector<sf::Sprite> m_playerIndicatorSprites;
+
+    // Arena
+    std::vector<sf::Texture> m_gameplayBackgroundTextures;
+    std::vector<sf::Vector2f> m_gameplayBackgroundScales;  // Fitting each to the canvas, worked out at load
+    std::optional<sf::Sprite> m_gameplayBackgroundSprite;
+    int m_selectedBackgroundIndex;
+    int m_warmedBackgroundIndex;
+    sf::Texture m_grassTexture;
+    std::vector<sf::RectangleShape> m_tiles;
+
+    // Entities
+    sf::Texture m_dinoSheet;        // Greyscale, so the tint sets the colour
+    sf::Texture m_boomerangTexture;
+    sf::Texture m_aimArrowTexture;
+    float m_aimIndicatorDistance;
+    std::array<ThrowPreview, RenderSnapshot::MaxPlayers> m_throwPreviews;
+    ParticleSystem m_particles;
+    std::uint64_t m_lastTrailTick;
+
+    // Triangles of the batch being built; capacity for a full arena is
+    // reserved up front
+    std::vector<sf::Vertex> m_batch;
+
+    // Game over
+    sf::Texture m_gameOverTexture;
+    std::optional<sf::Sprite> m_gameOverSprite;
+    sf::Texture m_restartTexture;
+    std::optional<sf::Sprite> m_restartSprite;
+    sf::RectangleShape m_overlay;
+
+    // Killcam
+    sf::RectangleShape m_letterbox;
+    sf::CircleShape m_replayDot;
+};
+
+#endif
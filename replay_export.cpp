@@ -0,0 +1,474 @@
+// Offline replay-to-video exporter.
+//
+// Replays a bot match tick by tick, renders every tick into an off-screen
+// texture at the chosen resolution and writes the frames out as numbered
+// PNGs or as one raw Y4M stream, for highlight reels:
+//
+//   ./dino_export --seed 1 --match 17 --size 1920x1080 --out frames
+//   ./dino_export --telemetry bots.dtel --match 3 --format y4m --out - | ffmpeg -i - reel.mp4
+//
+// Matches are replayed by simulating them again: a bot match is fully
+// determined by its seed, arena and player count, which dino_batch stores
+// in every telemetry block (--telemetry), or which can be given the way
+// dino_batch derives them (--seed/--match). Tuning isn't stored, so a match
+// played with overrides or a --variant needs the same --<tunable> flags
+// here. Matches recorded by the game itself have human inputs and can't be
+// replayed.
+//
+// Rendering stays on the main thread, which only draws each frame and reads
+// it back. Encoding a frame costs far more than drawing it, so finished
+// frames go to a pool of workers and the renderer moves straight on to the
+// next tick; Y4M frames are put back in order as they are written. Works
+// without a GPU through Mesa's llvmpipe (see --gl and the README).
+//
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "world.hpp"
+#include "bot.hpp"
+#include "level.hpp"
+#include "tuning.hpp"
+#include "tuning_params.hpp"
+#include "thread_pool.hpp"
+#include "telemetry_format.hpp"
+#include "match_seed.hpp"
+#include "render_snapshot.hpp"
+#include "renderer.hpp"
+#include "hud.hpp"
+#include "presenter.hpp"
+
+namespace {
+
+enum class Format {
+    Png,
+    Y4m
+};
+
+struct Options {
+    std::uint32_t seed = 1;
+    int match = 0;
+    int level = -1;             // -1 = as dino_batch rotates them
+    int players = 4;
+    int maxTicks = 60 * 90;
+    std::string telemetryPath;  // Replay the match stored here instead
+    Tuning tuning;              // As the match was played with
+    sf::Vector2u size{1920, 1080};
+    Presenter::Scaling scaling = Presenter::Scaling::Fit;
+    Format format = Format::Png;
+    std::string outPath = "frames";
+    unsigned int threads = 0;
+    int fromTick = 0;
+    int toTick = -1;            // -1 = to the end
+    bool softwareGl = false;
+};
+
+// What a match is replayed from
+struct MatchSpec {
+    std::uint32_t seed = 0;
+    int levelIndex = 0;
+    int players = 0;
+    int recordedTicks = -1;     // From telemetry, to check the replay against
+    int recordedWinner = -1;
+};
+
+// Reads the header of the match-th block in a telemetry file
+bool readTelemetryMatch(const std::string& path, int match, MatchSpec& spec) {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (!in.is_open() || data.size() < 5 || std::memcmp(data.data(), TELEMETRY_FILE_MAGIC, 4) != 0 ||
+        data[4] != TELEMETRY_VERSION) {
+        std::cerr << "Error: " << path << " is not a version " << int(TELEMETRY_VERSION) << " telemetry file"
+                  << std::endl;
+        return false;
+    }
+
+    const std::uint8_t* position = data.data() + 5;
+    const std::uint8_t* end = data.data() + data.size();
+    for (int index = 0; end - position >= 8 && std::memcmp(position, TELEMETRY_BLOCK_MAGIC, 4) == 0; ++index) {
+        std::uint32_t blockSize = position[4] | (position[5] << 8) | (position[6] << 16) |
+                                  (static_cast<std::uint32_t>(position[7]) << 24);
+        position += 8;
+        if (blockSize > static_cast<std::size_t>(end - position)) break;
+        if (index < match) {
+            position += blockSize;
+            continue;
+        }
+
+        TelemetryReader block(position, position + blockSize);
+        block.varint();     // matchIndex
+        spec.seed = static_cast<std::uint32_t>(block.varint());
+        std::size_t nameLength = block.varint();
+        if (!block.ok || nameLength > static_cast<std::size_t>(block.end - block.position)) break;
+        std::string levelName(reinterpret_cast<const char*>(block.position), nameLength);
+        block.position += nameLength;
+        spec.recordedTicks = static_cast<int>(block.varint());
+        spec.players = static_cast<int>(block.varint());
+        spec.recordedWinner = static_cast<int>(block.varint()) - 1;
+        if (!block.ok) break;
+
+        const auto& levels = builtinLevels();
+        auto level = std::find_if(levels.begin(), levels.end(),
+                                  [&](const Level& candidate) { return candidate.name == levelName; });
+        if (level == levels.end()) {
+            std::cerr << "Error: Match " << match << " was played on an unknown arena, " << levelName << std::endl;
+            return false;
+        }
+        // The game records its matches with seed 0; they were played by
+        // humans, and simulating them again from a seed would export some
+        // other match
+        if (spec.seed == 0) {
+            std::cerr << "Error: Match " << match << " has no seed; matches played in the game can't be replayed"
+                      << std::endl;
+            return false;
+        }
+        spec.levelIndex = static_cast<int>(level - levels.begin());
+        return true;
+    }
+    std::cerr << "Error: " << path << " has no match " << match << std::endl;
+    return false;
+}
+
+// Encodes frames on a thread pool while the caller renders the next one.
+// PNGs are written by whichever worker encoded them; Y4M frames are
+// converted in parallel and appended to the stream in frame order.
+class FrameEncoder {
+public:
+    FrameEncoder(Format format, const std::string& path, sf::Vector2u size, unsigned int threads)
+        : m_format(format)
+        , m_path(path)
+        , m_size(size)
+        , m_inFlight(0)
+        , m_nextToWrite(0)
+        , m_file(nullptr)
+        , m_failed(false)
+        , m_pool(threads)
+    {
+        m_maxInFlight = m_pool.getThreadCount() * 2;
+        if (m_format == Format::Png) {
+            std::error_code error;
+            std::filesystem::create_directories(m_path, error);
+            return;
+        }
+        m_file = m_path == "-" ? stdout : std::fopen(m_path.c_str(), "wb");
+        if (!m_file) {
+            std::cerr << "Error: Could not write " << m_path << std::endl;
+            m_failed = true;
+            return;
+        }
+        // 4:2:0 JPEG-sited chroma, 60 frames per second, square pixels
+        std::fprintf(m_file, "YUV4MPEG2 W%u H%u F60:1 Ip A1:1 C420jpeg\n", m_size.x, m_size.y);
+    }
+
+    ~FrameEncoder() {
+        finish();
+        if (m_file && m_file != stdout) std::fclose(m_file);
+    }
+
+    bool isOk() const { return !m_failed; }
+    unsigned int getThreadCount() const { return m_pool.getThreadCount(); }
+
+    // Queues frame number index. Waits while the workers are a couple of
+    // frames per thread behind, so a slow disk can't fill up the memory.
+    void submit(int index, sf::Image image) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_drained.wait(lock, [this] { return m_inFlight < m_maxInFlight; });
+            ++m_inFlight;
+        }
+        m_pool.submit([this, index, image = std::move(image)] {
+            if (m_format == Format::Png) writePng(index, image);
+            else writeY4m(index, image);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                --m_inFlight;
+            }
+            m_drained.notify_one();
+        });
+    }
+
+    // Waits for every queued frame to be written
+    void finish() {
+        m_pool.wait();
+        if (m_file) std::fflush(m_file);
+    }
+
+private:
+    void writePng(int index, const sf::Image& image) {
+        char name[32];
+        std::snprintf(name, sizeof name, "frame_%06d.png", index);
+        if (!image.saveToFile(std::filesystem::path(m_path) / name)) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_failed = true;
+        }
+    }
+
+    void writeY4m(int index, const sf::Image& image) {
+        std::vector<std::uint8_t> frame = toI420(image);
+
+        // Frames finish out of order; each is held until those before it
+        // have gone out
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.emplace(index, std::move(frame));
+        for (auto next = m_pending.find(m_nextToWrite); next != m_pending.end(); next = m_pending.find(m_nextToWrite)) {
+            std::fputs("FRAME\n", m_file);
+            if (std::fwrite(next->second.data(), 1, next->second.size(), m_file) != next->second.size()) {
+                m_failed = true;
+            }
+            m_pending.erase(next);
+            ++m_nextToWrite;
+        }
+    }
+
+    // RGBA to planar Y, U, V with BT.601 studio-range coefficients, chroma
+    // averaged over each 2x2 block
+    std::vector<std::uint8_t> toI420(const sf::Image& image) const {
+        const unsigned int width = m_size.x;
+        const unsigned int height = m_size.y;
+        const unsigned int chromaWidth = (width + 1) / 2;
+        const unsigned int chromaHeight = (height + 1) / 2;
+        std::vector<std::uint8_t> frame(width * height + 2 * chromaWidth * chromaHeight);
+        std::uint8_t* lumaPlane = frame.data();
+        std::uint8_t* uPlane = lumaPlane + width * height;
+        std::uint8_t* vPlane = uPlane + chromaWidth * chromaHeight;
+        const std::uint8_t* pixels = image.getPixelsPtr();
+
+        for (unsigned int y = 0; y < height; ++y) {
+            const std::uint8_t* row = pixels + y * width * 4;
+            for (unsigned int x = 0; x < width; ++x) {
+                int r = row[x * 4], g = row[x * 4 + 1], b = row[x * 4 + 2];
+                lumaPlane[y * width + x] = static_cast<std::uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+            }
+        }
+        for (unsigned int cy = 0; cy < chromaHeight; ++cy) {
+            for (unsigned int cx = 0; cx < chromaWidth; ++cx) {
+                int r = 0, g = 0, b = 0, count = 0;
+                for (unsigned int y = cy * 2; y < std::min(cy * 2 + 2, height); ++y) {
+                    for (unsigned int x = cx * 2; x < std::min(cx * 2 + 2, width); ++x) {
+                        const std::uint8_t* pixel = pixels + (y * width + x) * 4;
+                        r += pixel[0];
+                        g += pixel[1];
+                        b += pixel[2];
+                        ++count;
+                    }
+                }
+                r /= count;
+                g /= count;
+                b /= count;
+                uPlane[cy * chromaWidth + cx] = static_cast<std::uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+                vPlane[cy * chromaWidth + cx] = static_cast<std::uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+            }
+        }
+        return frame;
+    }
+
+    Format m_format;
+    std::string m_path;
+    sf::Vector2u m_size;
+
+    std::mutex m_mutex;
+    std::condition_variable m_drained;
+    unsigned int m_inFlight;
+    unsigned int m_maxInFlight;
+    std::map<int, std::vector<std::uint8_t>> m_pending;     // Y4M frames waiting for earlier ones
+    int m_nextToWrite;
+    std::FILE* m_file;
+    bool m_failed;
+    ThreadPool m_pool;      // Last, so its workers stop before anything they use goes away
+};
+
+void printUsage() {
+    std::cerr << "Usage: dino_export [options]\n"
+              << "  --seed N           base seed, as for dino_batch (default 1)\n"
+              << "  --match N          match number, as for dino_batch; with --telemetry, the\n"
+              << "                     Nth match stored in the file (default 0)\n"
+              << "  --level N          arena (default: as dino_batch picks it)\n"
+              << "  --players N        bots in the match (default 4)\n"
+              << "  --telemetry FILE   replay a match recorded by dino_batch --telemetry\n"
+              << "  --size WxH         frame size (default 1920x1080)\n"
+              << "  --scaling fit|integer\n"
+              << "  --format png|y4m   numbered PNGs in a directory, or one Y4M stream (default png)\n"
+              << "  --out PATH         directory for PNGs, file for Y4M, - for stdout (default frames)\n"
+              << "  --from TICK        first tick to export (default 0)\n"
+              << "  --to TICK          last tick to export (default: the end)\n"
+              << "  --threads N        encoding threads (default: all cores)\n"
+              << "  --gl software      render with Mesa's llvmpipe even if there is a GPU\n"
+              << "  --<tunable> VALUE  the tuning the match was played with, as given to dino_batch\n"
+              << "                     (its --variant overrides too):\n"
+              << "                    ";
+    for (const auto& param : TUNING_FLOAT_PARAMS) std::cerr << " " << param.name;
+    for (const auto& param : TUNING_INT_PARAMS) std::cerr << " " << param.name;
+    std::cerr << std::endl;
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc) return false;
+        std::string value = argv[++i];
+        if (arg == "--seed") options.seed = std::stoul(value);
+        else if (arg == "--match") options.match = std::max(0, std::stoi(value));
+        else if (arg == "--level") options.level = std::stoi(value);
+        else if (arg == "--players") options.players = std::clamp(std::stoi(value), 2, World::MaxPlayers);
+        else if (arg == "--max-ticks") options.maxTicks = std::stoi(value);
+        else if (arg == "--telemetry") options.telemetryPath = value;
+        else if (arg == "--size") {
+            if (std::sscanf(value.c_str(), "%ux%u", &options.size.x, &options.size.y) != 2) return false;
+        }
+        else if (arg == "--scaling") {
+            if (!Presenter::parseScaling(value, options.scaling)) return false;
+        }
+        else if (arg == "--format") {
+            if (value == "png") options.format = Format::Png;
+            else if (value == "y4m") options.format = Format::Y4m;
+            else return false;
+        }
+        else if (arg == "--out") options.outPath = value;
+        else if (arg == "--from") options.fromTick = std::stoi(value);
+        else if (arg == "--to") options.toTick = std::stoi(value);
+        else if (arg == "--threads") options.threads = std::stoul(value);
+        else if (arg == "--gl") options.softwareGl = value == "software";
+        else if (arg.rfind("--", 0) != 0 || !setTuningParam(options.tuning, arg.substr(2), value)) {
+            std::cerr << "Error: Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+    return options.size.x > 0 && options.size.y > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    bool parsed = false;
+    try {
+        parsed = parseOptions(argc, argv, options);
+    } catch (const std::exception&) {
+        // A value that isn't a number gets the usage text like any other mistake
+    }
+    if (!parsed) {
+        printUsage();
+        return 1;
+    }
+    // Must be set before SFML creates its first OpenGL context
+    if (options.softwareGl) {
+        setenv("LIBGL_ALWAYS_SOFTWARE", "1", 1);
+        setenv("GALLIUM_DRIVER", "llvmpipe", 1);
+    }
+
+    const auto& levels = builtinLevels();
+    MatchSpec spec;
+    if (!options.telemetryPath.empty()) {
+        if (!readTelemetryMatch(options.telemetryPath, options.match, spec)) return 1;
+    } else {
+        spec.seed = mixSeed(options.seed, options.match);
+        spec.levelIndex = options.level >= 0 ? options.level : options.match % levels.size();
+        spec.players = options.players;
+        if (spec.levelIndex >= static_cast<int>(levels.size())) {
+            std::cerr << "Error: There are only " << levels.size() << " arenas" << std::endl;
+            return 1;
+        }
+    }
+    if (spec.players < 2 || spec.players > World::MaxPlayers) {
+        std::cerr << "Error: Can't replay a match of " << spec.players << " players" << std::endl;
+        return 1;
+    }
+
+    // The frame everything is scaled into before it is read back
+    sf::RenderTexture frame;
+    if (!frame.resize(options.size)) {
+        std::cerr << "Error: Could not create a " << options.size.x << "x" << options.size.y
+                  << " render texture. Without a display, run under xvfb-run (see the README)." << std::endl;
+        return 1;
+    }
+
+    const Level& level = levels[spec.levelIndex];
+    World world(level, options.tuning);
+    std::vector<Bot> bots;
+    for (int i = 0; i < spec.players; ++i) {
+        world.addPlayer(-1);
+        bots.emplace_back(mixSeed(spec.seed, i + 1));
+    }
+
+    Presenter presenter(options.scaling);
+    Renderer renderer(presenter.getCanvasSize(), level, world.getTuning());
+    Hud hud(presenter.getCanvasSize());
+    FrameEncoder encoder(options.format, options.outPath, options.size, options.threads);
+    if (!encoder.isOk()) return 1;
+
+    RenderSnapshot snapshot;
+    snapshot.gameState = GameState::Gameplay;
+    snapshot.backgroundIndex = renderer.getBackgroundCount() > 0
+        ? static_cast<int>(spec.seed % renderer.getBackgroundCount()) : 0;
+    snapshot.scoreCount = spec.players;
+
+    // The match, then a second more for the last death, as the game shows it
+    // before its game over screen
+    const int afterDecided = 60;
+    const float secondsPerTick = 1.f / 60.f;
+    int decidedAt = -1;
+    int frames = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::cerr << "Exporting " << level.name << ", " << spec.players << " players, seed " << spec.seed
+              << ", encoding on " << encoder.getThreadCount() << " threads..." << std::endl;
+
+    std::vector<PlayerInput> inputs(spec.players);
+    while (world.getTick() < options.maxTicks && (decidedAt < 0 || world.getTick() < decidedAt + afterDecided)) {
+        if (options.toTick >= 0 && world.getTick() > options.toTick) break;
+        for (int i = 0; i < spec.players; ++i) {
+            inputs[i] = bots[i].think(world, i);
+        }
+        world.step(inputs);
+        if (decidedAt < 0 && world.getAliveCount() <= 1) decidedAt = world.getTick();
+
+        captureWorld(world, snapshot);
+        captureScores(world, snapshot);
+        snapshot.tick = world.getTick();
+        for (const auto& event : world.getStepEvents()) {
+            renderer.onEvent(event);
+        }
+        renderer.update(snapshot, secondsPerTick);
+        hud.update(snapshot, secondsPerTick);
+        if (world.getTick() - 1 < options.fromTick) continue;
+
+        sf::RenderTarget& canvas = presenter.beginFrame();
+        renderer.draw(canvas, snapshot);
+        hud.draw(canvas);
+        presenter.present(frame, options.size);
+        frame.display();
+        encoder.submit(frames++, frame.getTexture().copyToImage());
+    }
+    encoder.finish();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cerr << frames << " frames in " << seconds << " s (" << (seconds > 0 ? frames / seconds : 0.0)
+              << " fps, " << (seconds > 0 ? frames / 60.0 / seconds : 0.0) << "x real time)" << std::endl;
+    if (spec.recordedTicks >= 0 && options.toTick < 0) {
+        int winner = -1;
+        for (const auto& player : world.getPlayers()) {
+            if (player.isAlive() && world.getAliveCount() == 1) winner = player.getId();
+        }
+        if ((decidedAt >= 0 ? decidedAt : world.getTick()) != spec.recordedTicks || winner != spec.recordedWinner) {
+            std::cerr << "Warning: The replay doesn't end as the recording does (" << spec.recordedTicks
+                      << " ticks); it was probably played with other tuning, which needs the same --<tunable> flags"
+                      << std::endl;
+        }
+    }
+    if (!encoder.isOk()) {
+        std::cerr << "Error: Some frames could not be written" << std::endl;
+        return 1;
+    }
+    return 0;
+}
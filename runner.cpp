@@ -2,304 +2,346 @@
 #include <iostream>
 #include <cstdio>
 #include <vector>
-#include "player.hpp"
-#include "boomerang.hpp"
+#include "world.hpp"
+#include "input.hpp"
+#include "bot.hpp"
+#include "player_slots.hpp"
+#include "event_bus.hpp"
+#include "frame_pacer.hpp"
+#include "latency_monitor.hpp"
+#include "match_stats.hpp"
+#include "telemetry.hpp"
+#include "spectator_publisher.hpp"
+#include "killcam.hpp"
+#include "audio_mixer.hpp"
+#include "audio_output.hpp"
+#include "game_state.hpp"
+#include "render_snapshot.hpp"
+#include "renderer.hpp"
+#include "hud.hpp"
+#include "triple_buffer.hpp"
+#include "thread_pool.hpp"
+#include "alloc_tracker.hpp"
+#include "presenter.hpp"
 #include <SFML/Graphics.hpp>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
 #include <string>
 #include <random>
+#include <thread>
 #include <ctime>
 
-enum class GameState {
-    MainMenu,
-    Gameplay,
-    GameOver
-};
-
-template<typename T>
-void resetToMainMenu(GameState& gameState, bool& gameOverTriggered, 
-                    std::vector<T>& players, 
-                    std::vector<Boomerang>& boomerangs,
+void resetToMainMenu(GameState& gameState, bool& gameOverTriggered,
+                    World& world,
                     std::vector<int>& joinedControllers,
-                    sf::Time& gameOverDelay) {
+                    std::vector<std::unique_ptr<Bot>>& slotBots,
+                    int& gameOverDelayTicks) {
     gameState = GameState::MainMenu;
     gameOverTriggered = false;
-    players.clear();
-    boomerangs.clear();
+    world.clear();
     joinedControllers.clear();
-    gameOverDelay = sf::Time::Zero;
+    slotBots.clear();
+    gameOverDelayTicks = 0;
 }
 
-sf::Vector2f bnormalize(const sf::Vector2f& source) {
-    float length = std::sqrt(source.x * source.x + source.y * source.y);
-        if (length != 0) return {source.x / length, source.y / length};
-        return source;
-    }
-int main() {
-    const unsigned int windowWidth = 800;
-    const unsigned int windowHeight = 500;
-    sf::RenderWindow window(sf::VideoMode({windowWidth, windowHeight}), "Platformer Sandbox");
-    window.setFramerateLimit(60);
-    // --- Load Textures ---
-    // Load main menu background
-    sf::Texture menuBackgroundTexture;
-    if(!menuBackgroundTexture.loadFromFile("assets/mc_bg.jpg")){
-        std::cerr << "Error: Could not load menu background image!" << std::endl;
-    }
-    sf::Sprite menuBackgroundSprite(menuBackgroundTexture);
-    
-    // Scale menu background
-    sf::Vector2u menuBgSize = menuBackgroundTexture.getSize();
-    float menuScaleX = (float)windowWidth / menuBgSize.x;
-    float menuScaleY = (float)windowHeight / menuBgSize.y;
-    menuBackgroundSprite.setScale({menuScaleX, menuScaleY});
-    
-    // Load gameplay backgrounds (array of possible backgrounds)
-    std::vector<std::string> gameplayBackgroundFiles = {
-        "assets/clouds.jpg",
-        "assets/cyberpunk2_bg.jpg",
-        "assets/cyberpunk_background.png",
-        "assets/minecraft_bg.jpg",
-        "assets/minecarft_bg.jpg"
-    };
-    
-    std::vector<sf::Texture> gameplayBackgroundTextures;
-    for (const auto& filename : gameplayBackgroundFiles) {
-        sf::Texture texture;
-        if (texture.loadFromFile(filename)) {
-            gameplayBackgroundTextures.push_back(std::move(texture));
-        } else {
-            std::cerr << "Warning: Could not load background " << filename << std::endl;
-        }
-    }
-    
-    // Random number generator for background selection
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> bgDist(0, gameplayBackgroundTextures.size() - 1);
-    
-    // Sprite for gameplay background (initialize with first texture if available)
-    int selectedBackgroundIndex = 0;
-    sf::Sprite gameplayBackgroundSprite(gameplayBackgroundTextures.empty() ? menuBackgroundTexture : gameplayBackgroundTextures[0]);
-
-    // Load grass texture
-    sf::Texture grassTexture;
-    if (!grassTexture.loadFromFile("assets/grass_tile.png")) {
-        std::cerr << "Error: Could not load grass texture!" << std::endl;
-    }
-    //grassTexture.setRepeated(true);
-    
-    // Create dark overlay for main menu to make UI elements stand out
-    sf::RectangleShape menuOverlay;
-    menuOverlay.setSize({static_cast<float>(windowWidth), static_cast<float>(windowHeight)});
-    menuOverlay.setFillColor(sf::Color(0, 0, 0, 150)); // Semi-transparent black (alpha: 150/255)
-    
-    //backgroundSprite.setPosition(0, 0);
-    // Load boomerang texture once (shared by all boomerangs)
-    std::shared_ptr<sf::Texture> boomerangTexture = std::make_shared<sf::Texture>();
-    if (!boomerangTexture->loadFromFile("vite_boomerang.png")) {
-        std::cerr << "Error: Could not load boomerang texture!" << std::endl;
-    }
+// Window sizes cross to the render thread as a single atomic word
+static std::uint64_t packSize(sf::Vector2u size) {
+    return (static_cast<std::uint64_t>(size.x) << 32) | size.y;
+}
 
-    // Load dino character textures (one for each player)
-    std::vector<std::shared_ptr<sf::Texture>> dinoTextures(4);
-    std::string dinoFiles[4] = {
-        "assets/DinoSprites - doux.png",
-        "assets/DinoSprites - mort.png",
-        "assets/DinoSprites - tard.png",
-        "assets/DinoSprites - vita.png"
-    };
-    
-    for (int i = 0; i < 4; i++) {
-        dinoTextures[i] = std::make_shared<sf::Texture>();
-        if (!dinoTextures[i]->loadFromFile(dinoFiles[i])) {
-            std::cerr << "Error: Could not load dino texture " << dinoFiles[i] << std::endl;
-        }
-    }
+static sf::Vector2u unpackSize(std::uint64_t packed) {
+    return {static_cast<unsigned int>(packed >> 32), static_cast<unsigned int>(packed & 0xffffffffu)};
+}
 
-    // Load p1-p4 indicator textures
-    std::vector<std::shared_ptr<sf::Texture>> playerIndicatorTextures(4);
-    std::vector<sf::Sprite> playerIndicatorSprites;
-    std::vector<sf::Sprite> playerDinoPreviewSprites; // Dino sprites for menu preview
-    std::string indicatorFiles[4] = {
-        "assets/p1.png",
-        "assets/p2.png",
-        "assets/p3.png",
-        "assets/p4.png"
-    };
-    
-    for (int i = 0; i < 4; i++) {
-        playerIndicatorTextures[i] = std::make_shared<sf::Texture>();
-        if (!playerIndicatorTextures[i]->loadFromFile(indicatorFiles[i])) {
-            std::cerr << "Error: Could not load indicator texture " << indicatorFiles[i] << std::endl;
-        } else {
-            sf::Sprite sprite(*playerIndicatorTextures[i]);
-            // Position indicators at bottom of screen, spread out
-            float spacing = windowWidth / 5.0f; // Divide screen into 5 sections for 4 indicators
-            float yPosition = windowHeight - 80.0f; // 80 pixels from bottom
-            sprite.setPosition({spacing * (i + 1) - playerIndicatorTextures[i]->getSize().x / 2.0f, yPosition});
-            sprite.setScale({2.0f, 2.0f}); // Scale up the indicators
-            playerIndicatorSprites.push_back(sprite);
-            
-            // Create dino preview sprite (first frame of animation)
-            sf::Sprite dinoPreview(*dinoTextures[i]);
-            dinoPreview.setTextureRect(sf::IntRect({0, 0}, {24, 24})); // First frame
-            dinoPreview.setScale({3.0f, 3.0f}); // Make it bigger for visibility
-            // Position above the indicator
-            float dinoX = spacing * (i + 1) - 12.0f * 3.0f; // Center the 24px sprite scaled 3x
-            float dinoY = yPosition - 90.0f; // Position above indicator
-            dinoPreview.setPosition({dinoX, dinoY});
-            playerDinoPreviewSprites.push_back(dinoPreview);
+int main(int argc, char** argv) {
+    // --- Frame pacing ---
+    // --pacing vsync|hybrid|uncapped, --fps N (the hybrid target; default 60)
+    FramePacer::Mode pacingMode = FramePacer::Mode::VSync;
+    float pacingFps = 60.f;
+    // --substeps 1|2|4|8 runs physics at 60/120/240/480 Hz
+    Tuning tuning;
+    // --spectate tcp:PORT or unix:PATH streams the match to dino_spectator
+    std::string spectateAddress;
+    // --killcam slow|normal|off replays the final kill before game over
+    std::string killcamMode = "slow";
+    // --audio device|null|off; null mixes without a sound card
+    std::string audioMode = "device";
+    // --bots N seats N bots before anyone joins; B on the join screen adds one more
+    int botCount = 0;
+    // --sim-threads N splits each physics substep across N extra workers;
+    // 0 (the default) keeps the simulation on the game thread
+    int simThreads = 0;
+    // --alloc-strict aborts on any heap allocation by a Gameplay tick (builds
+    // with -DDINO_TRACK_ALLOCATIONS only; see alloc_tracker.hpp)
+    bool allocStrict = false;
+    // --display window|fullscreen, --window WxH (default: the canvas size) and
+    // --scaling fit|integer for how the canvas is blown up to the screen
+    bool fullscreen = false;
+    sf::Vector2u windowSize(Presenter::CanvasWidth, Presenter::CanvasHeight);
+    Presenter::Scaling scaling = Presenter::Scaling::Fit;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        try {
+            if (arg == "--pacing" && FramePacer::parseMode(argv[i + 1], pacingMode)) continue;
+            if (arg == "--fps") { pacingFps = std::stof(argv[i + 1]); continue; }
+            if (arg == "--substeps") { tuning.physicsSubsteps = std::stoi(argv[i + 1]); continue; }
+            if (arg == "--bots") { botCount = std::clamp(std::stoi(argv[i + 1]), 0, MAX_PLAYERS); continue; }
+            if (arg == "--alloc-strict") { allocStrict = std::string(argv[i + 1]) != "off"; continue; }
+            if (arg == "--sim-threads") { simThreads = std::max(0, std::stoi(argv[i + 1])); continue; }
+            if (arg == "--spectate" && checkSpectatorListenAddress(argv[i + 1])) {
+                spectateAddress = argv[i + 1];
+                continue;
+            }
+            if (arg == "--scaling" && Presenter::parseScaling(argv[i + 1], scaling)) continue;
+            if (arg == "--window" && std::sscanf(argv[i + 1], "%ux%u", &windowSize.x, &windowSize.y) == 2) continue;
+            if (arg == "--display") {
+                std::string display = argv[i + 1];
+                fullscreen = display == "fullscreen";
+                if (fullscreen || display == "window") continue;
+            }
+            if (arg == "--killcam") {
+                killcamMode = argv[i + 1];
+                if (killcamMode == "slow" || killcamMode == "normal" || killcamMode == "off") continue;
+            }
+            if (arg == "--audio") {
+                audioMode = argv[i + 1];
+                if (audioMode == "device" || audioMode == "null" || audioMode == "off") continue;
+            }
+        } catch (const std::exception&) {
+            // A value that isn't a number falls through to the usage text
         }
+        std::cerr << "Usage: runner [--pacing vsync|hybrid|uncapped] [--fps N] [--substeps 1|2|4|8]"
+                  << " [--spectate tcp:PORT|unix:PATH] [--killcam slow|normal|off]"
+                  << " [--audio device|null|off] [--bots N] [--sim-threads N]"
+                  << " [--alloc-strict on|off] [--display window|fullscreen] [--window WxH]"
+                  << " [--scaling fit|integer]" << std::endl;
+        return 1;
     }
-    // Load game over and restart textures
-    sf::Texture gameOverTexture;
-    if (!gameOverTexture.loadFromFile("assets/gameover.png")) {
-        std::cerr << "Error: Could not load game over image!" << std::endl;
-    }
-    sf::Sprite gameOverSprite(gameOverTexture);
-    
-    sf::Texture restartTexture;
-    if (!restartTexture.loadFromFile("assets/restart.png")) {
-        std::cerr << "Error: Could not load restart image!" << std::endl;
+    FramePacer pacer(pacingMode, pacingFps);
+    if (allocStrict && !AllocTracker::Enabled) {
+        std::cerr << "Warning: --alloc-strict needs a build with -DDINO_TRACK_ALLOCATIONS; ignoring it" << std::endl;
     }
-    sf::Sprite restartSprite(restartTexture);
-    
-    // Position game over and restart sprites
-    gameOverSprite.setOrigin(sf::Vector2f(gameOverTexture.getSize()) / 2.0f);
-    gameOverSprite.setPosition(sf::Vector2f(windowWidth / 2.0f, windowHeight / 2.0f - 50));
-    gameOverSprite.setScale({3.0f, 3.0f});
-    
-    restartSprite.setOrigin(sf::Vector2f(restartTexture.getSize()) / 2.0f);
-    restartSprite.setPosition(sf::Vector2f(windowWidth / 2.0f, windowHeight / 2.0f + 100));
-    restartSprite.setScale({3.0f, 3.0f});
-    
-    // Create semi-transparent overlay
-    sf::RectangleShape overlay(sf::Vector2f(windowWidth, windowHeight));
-    overlay.setFillColor(sf::Color(0, 0, 0, 180)); // Semi-transparent black
-    
-    sf::Texture titleCardTexture;
-    if (!titleCardTexture.loadFromFile("assets/titlecard.png")) {
-        std::cerr << "Error: Could not load title card image!" << std::endl;
-    }
-    sf::Sprite titleCardSprite(titleCardTexture);
-
-    // Position the title card at the top center of the screen
-    sf::Vector2u titleSize = titleCardTexture.getSize();
-    titleCardSprite.setPosition({(windowWidth - titleSize.x) / 2.0f, 50.0f});
 
-
-    // Load "Press any button to join" text art
-    sf::Texture joinPromptTexture;
-    if (!joinPromptTexture.loadFromFile("assets/pabtj.png")) {  // Update with your actual filename
-        std::cerr << "Error: Could not load join prompt image!" << std::endl;
+    // The game is drawn at the canvas size and scaled to whatever the window
+    // turns out to be; the render thread reads the size from here as the
+    // window is resized
+    sf::RenderWindow window(fullscreen ? sf::VideoMode::getDesktopMode() : sf::VideoMode(windowSize), "Platformer Sandbox",
+                            sf::Style::Default, fullscreen ? sf::State::Fullscreen : sf::State::Windowed);
+    std::atomic<std::uint64_t> presentSize(packSize(window.getSize()));
+    const sf::Vector2u canvasSize(Presenter::CanvasWidth, Presenter::CanvasHeight);
+
+    // --- Level ---
+    const int levelIndex = 0;
+    const Level& level = builtinLevels()[levelIndex];
+    World world(level, tuning);
+    std::unique_ptr<ThreadPool> simJobs;
+    if (simThreads > 0) {
+        simJobs = std::make_unique<ThreadPool>(simThreads);
+        world.setJobPool(simJobs.get());
     }
 
-    sf::Sprite joinPromptSprite(joinPromptTexture);
-
-    // Position join prompt below the title card with some spacing
-    float spacing = 20.0f;  // Space between title and join prompt
-    joinPromptSprite.setPosition(
-        {(windowWidth - joinPromptTexture.getSize().x) / 2.0f,  // Center horizontally
-        titleCardSprite.getPosition().y + titleSize.y + spacing});
-
-
-
+    // All textures and sprites live in the renderer
+    Renderer renderer(canvasSize, level, world.getTuning());
+    Hud hud(canvasSize);
 
-
-            // After loading the title card texture but before setting its position
-    titleCardSprite.setScale({2.5f, 2.5f});  // 2x scale - adjust these values as needed
-
-    // After loading the join prompt texture but before setting its position
-    joinPromptSprite.setScale({2.0f, 2.0f});  // 2x scale - adjust these values as needed
-
-    // Then update their positions to account for the new size
-    titleCardSprite.setPosition({
-        (windowWidth - (titleSize.x * titleCardSprite.getScale().x)) / 2.0f, 
-        50.0f
+    // Random number generator for background selection. The next match's
+    // background is picked ahead of time, on the join screen and as soon as
+    // a match is decided, so the renderer can have it ready.
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<> bgDist(0, std::max(0, renderer.getBackgroundCount() - 1));
+    int selectedBackgroundIndex = 0;
+    int nextBackgroundIndex = bgDist(gen);
+
+    // --- Gameplay events ---
+    // The simulation publishes kills, throws, bounces, catches and dashes;
+    // each consumer drains its own queue on its own thread
+    EventBus events;
+    world.setEventBus(&events);
+    MatchStats matchStats;
+    EventListener statsListener(events, [&matchStats](const GameEvent& event) { matchStats.onEvent(event); });
+    EventListener killFeed(events, [](const GameEvent& event) {
+        if (event.type != GameEvent::Type::Kill) return;
+        static const char* causes[] = {"flying", "hanging", "returning"};
+        const char* cause = event.cause < 3 ? causes[event.cause] : "";
+        std::cout << "P" << (event.targetId + 1) << " was hit by P" << (event.actorId + 1)
+                  << "'s " << cause << " boomerang" << std::endl;
     });
 
-// Update join prompt position with scaling in mind
-// Position it in the middle area of the screen to ensure visibility
-float joinPromptY = 220.0f; // Fixed position to keep it visible above player indicators
-joinPromptSprite.setPosition({
-    (windowWidth - (joinPromptTexture.getSize().x * joinPromptSprite.getScale().x)) / 2.0f,
-    joinPromptY
-});
-
-    // --- Tilemap Data ---
-    // Here we define our level layout using strings.
-    // '#' = a solid tile. '.' = empty space.
-    std::vector<std::string> tilemap = {
-        "....................",
-        "....................",
-        "..G.................",
-        "..#..........GG..G..",
-        "..#.................",
-        ".....GGG.......#.....",
-        ".......#G...........",
-        "..G.........#.......",
-        "....................",
-        ".....GGGG......G....",
-        "....................",
-        "GG................GG",
-        "##GGGGGGGGGG..GGGG##",
-        "############..######"
-    };
+    // --- Telemetry ---
+    // Every match is appended to telemetry.dtel for dino_telemetry; the file
+    // is written from a background thread
+    TelemetryWriter telemetry("telemetry.dtel");
+    MatchRecording recording;
+    int matchIndex = 0;
+
+    // --- Spectators ---
+    // Encoding and sending happen on the publisher's thread; the game only
+    // hands it a copy of each tick's snapshot
+    std::unique_ptr<SpectatorPublisher> spectators;
+    if (!spectateAddress.empty()) {
+        spectators = std::make_unique<SpectatorPublisher>(spectateAddress, levelIndex);
+        if (!spectators->isOpen()) return 1;
+    }
 
-    // --- Create the visual tiles from the map data ---
-    std::vector<sf::RectangleShape> tiles;
-    const float TILE_SIZE = 40.f; // Each tile will be 40x40 pixels
-
-    for (int y = 0; y < tilemap.size(); ++y) {
-        for (int x = 0; x < tilemap[y].size(); ++x) {
-            if (tilemap[y][x] == '#' || tilemap[y][x] == 'G') {
-                sf::RectangleShape tile;
-                tile.setSize({TILE_SIZE, TILE_SIZE});
-                
-                if (tilemap[y][x] == 'G') {
-                    // Grass tile
-                    tile.setTexture(&grassTexture);
-                    int tileSize = static_cast<int>(TILE_SIZE);
-                    tile.setTextureRect(sf::IntRect(
-                        sf::Vector2i(0, 0),  // position
-                        sf::Vector2i(tileSize, tileSize)  // size
-                    ));
-                } else {
-                    // Regular solid tile
-                    tile.setFillColor(sf::Color(100, 100, 100)); // Dark grey
-                }
-                
-                tile.setPosition({x * TILE_SIZE, y * TILE_SIZE});
-                tiles.push_back(tile);
+    // --- Killcam ---
+    // The last seconds of every match are kept in a fixed ring; when the
+    // match is decided the final kill is replayed from it
+    ReplayBuffer replay;
+    KillcamPresenter killcam;
+    KillcamPresenter::Settings killcamSettings;
+    if (killcamMode == "normal") killcamSettings.slowMotion = 1.f;
+    killcam.setSettings(killcamSettings);
+
+    // --- Audio ---
+    // Every effect is decoded before the first frame; the game thread only
+    // queues which ones to start, and mixing runs on the output's thread
+    SampleBank sounds;
+    sounds.loadDirectory("assets/sounds");
+    AudioMixer audio(sounds);
+    std::unique_ptr<AudioOutput> audioOutput;
+    if (audioMode != "off") {
+        audioOutput = createAudioOutput(audioMode, audio);
+        audioOutput->start();
+    }
+
+    // --- Render thread ---
+    // The simulation runs here at a fixed 60 Hz and publishes a snapshot
+    // after every tick; the render thread draws at the display's refresh
+    // rate, blending the two newest ticks so motion stays smooth on 120, 144
+    // and 240 Hz monitors. This shows the game one tick late, which costs less
+    // than waiting for the next 60 Hz frame.
+    TripleBuffer<RenderSnapshot> snapshots;
+    EventBus::Queue* effectEvents = events.subscribe();
+    std::atomic<bool> rendering(true);
+    std::atomic<bool> showLatency(false);   // F3 toggles the latency overlay
+    std::atomic<bool> showFrameTimes(false);    // F4 toggles the HUD's FPS readout
+    const sf::Time timePerFrame = sf::seconds(1.f / 60.f);
+    const sf::Clock gameClock;
+    window.setActive(false);
+    std::thread renderThread([&window, &renderer, &hud, &snapshots, effectEvents, &rendering, &showLatency,
+                               &showFrameTimes, &pacer, &gameClock, timePerFrame, &presentSize, scaling]() {
+        AllocTracker::Scope tag(AllocSubsystem::Render);
+        window.setActive(true);
+        pacer.apply(window);
+        Presenter presenter(scaling);
+        RenderSnapshot previous;
+        RenderSnapshot current;
+        RenderSnapshot blended;
+        sf::Clock frameClock;
+        LatencyMonitor latency("latency.log");
+        std::uint32_t measuredSequence = 0;
+        while (rendering.load(std::memory_order_relaxed)) {
+            if (snapshots.acquire()) {
+                previous = current;
+                current = snapshots.readBuffer();
+            }
+            GameEvent event;
+            while (effectEvents && effectEvents->tryPop(event)) {
+                renderer.onEvent(event);
+            }
+            float alpha = (gameClock.getElapsedTime() - current.time) / timePerFrame;
+            alpha = std::clamp(alpha, 0.0f, 1.0f);
+            interpolateSnapshots(previous, current, alpha, blended);
+            float frameSeconds = frameClock.restart().asSeconds();
+            renderer.update(blended, frameSeconds);
+            sf::RenderTarget& canvas = presenter.beginFrame();
+            renderer.draw(canvas, blended);
+            hud.setShowFrameTimes(showFrameTimes.load(std::memory_order_relaxed));
+            hud.update(blended, frameSeconds);
+            hud.draw(canvas);
+            if (showLatency.load(std::memory_order_relaxed)) {
+                latency.draw(canvas);
+                pacer.draw(canvas, {10.f, 44.f});
             }
+            presenter.present(window, unpackSize(presentSize.load(std::memory_order_relaxed)));
+            window.display();
+
+            // First frame showing a tick that consumed a new input: measure
+            // from when the controller change was sampled. The clock is read
+            // before the pacer's sleep, which is not part of the latency
+            if (current.inputSequence != measuredSequence) {
+                measuredSequence = current.inputSequence;
+                sf::Time now = gameClock.getElapsedTime();
+                latency.record(now - current.inputTime, now);
+            }
+            pacer.endFrame();
         }
-    }
+        window.setActive(false);
+    });
 
-        sf::Vector2f startpositions[] = {
-        {100.f, 100.f},
-        {700.f, 100.f},
-        {200.f, 100.f},
-        {600.f, 100.f}
-    };
     // --- Game Entities ---
-    std::vector<Player> players;
-    std::vector<Boomerang> boomerangs;
+    // One entry per player slot, by id: the bot playing it, or nullptr for a
+    // human on a controller
     std::vector<int> joinedControllers;
+    std::vector<std::unique_ptr<Bot>> slotBots;
+    auto addBot = [&world, &slotBots, &rd]() {
+        int id = world.addPlayer(BOT_CONTROLLER);
+        if (id < 0) return false;
+        slotBots.resize(id + 1);
+        slotBots[id] = std::make_unique<Bot>(rd());
+        return true;
+    };
+    for (int i = 0; i < botCount; i++) addBot();
+    std::vector<PlayerInput> inputs;
+    std::vector<PlayerInput> lastInputs;
+    std::uint32_t inputSequence = 0;
+    sf::Time inputTime;
     sf::Clock clock;
     sf::Time timeSinceLastUpdate = sf::Time::Zero;
-    const sf::Time timePerFrame = sf::seconds(1.f / 60.f);
-    sf::Time gameOverDelay = sf::Time::Zero;
+    const int gameOverDelay = 60;   // Ticks between the last kill and the game over screen (1 second)
+    int gameOverDelayTicks = 0;
     bool gameOverTriggered = false;
+    std::array<std::uint8_t, RenderSnapshot::MaxPlayers> wins{};  // This session, by player id
+    // Game over controls from the previous tick, so that screen only acts on
+    // a fresh press: button 0 (dash) or 1 (jump) still held from the match
+    // must not rematch or leave the moment it comes up
+    bool rematchHeld = false;
+    bool backHeld = false;
 
     // Start the game in the Main Menu
     GameState gameState = GameState::MainMenu;
 
-    while (window.isOpen()) {
+    // --- Match lifecycle ---
+    // Join screen -> match -> killcam -> game over, then either a rematch
+    // with the same roster or back to the join screen. A rematch revives
+    // everyone in place (see World::rematch), so it reads nothing from disk
+    // and takes a few microseconds.
+    auto startMatch = [&]() {
+        selectedBackgroundIndex = nextBackgroundIndex;
+        matchStats.reset();
+        recording = MatchRecording(telemetry.getChunkPool(), matchIndex++, 0, level.name, world.getPlayers().size());
+        replay.clear();
+        gameOverTriggered = false;
+        gameOverDelayTicks = 0;
+        gameState = GameState::Gameplay;
+    };
+    auto rematch = [&]() {
+        world.rematch();
+        for (auto& bot : slotBots) {
+            if (bot) bot->reset();
+        }
+        startMatch();
+    };
+
+    bool running = true;
+    while (running) {
         // Handle events first
         while (const auto event = window.pollEvent()) {
             if (event->is<sf::Event::Closed>()) {
-                window.close();
+                running = false;
+            }
+            if (const auto* resized = event->getIf<sf::Event::Resized>()) {
+                presentSize.store(packSize(resized->size), std::memory_order_relaxed);
+            }
+            if (const auto* key = event->getIf<sf::Event::KeyPressed>()) {
+                if (key->code == sf::Keyboard::Key::F3) showLatency = !showLatency;
+                if (key->code == sf::Keyboard::Key::F4) showFrameTimes = !showFrameTimes;
+                if (key->code == sf::Keyboard::Key::B && gameState == GameState::MainMenu && addBot()) {
+                    audio.play(SoundId::Join);
+                }
             }
 
             if (gameState == GameState::MainMenu) {
@@ -308,188 +350,189 @@ joinPromptSprite.setPosition({
                         unsigned int jid = joybtn->joystickId;
                         bool alreadyjoined = (std::find(joinedControllers.begin(), joinedControllers.end(), jid) != joinedControllers.end());
 
-                        if(!alreadyjoined && players.size() < 4){
-                            int newplayerid = players.size();
-                            // Pass the appropriate dino texture based on player ID
-                            players.emplace_back(startpositions[newplayerid].x, startpositions[newplayerid].y, newplayerid, jid, dinoTextures[newplayerid]);
+                        int id = alreadyjoined ? -1 : world.addPlayer(jid);
+                        if(id >= 0){
+                            slotBots.resize(id + 1);
                             joinedControllers.push_back(jid);
+                            audio.play(SoundId::Join);
                         }
                     }
                 }
             }
         }
-
-        // Update game state
-        switch (gameState) {
-            case GameState::MainMenu:
-            {
-                // Check for game start
-                if ((sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Enter) || 
-                    (sf::Joystick::isConnected(0) && sf::Joystick::isButtonPressed(0, 7))) // Start button
-                    && !players.empty()) {
-                    // Select a random background for gameplay
-                    if (!gameplayBackgroundTextures.empty()) {
-                        selectedBackgroundIndex = bgDist(gen);
-                        gameplayBackgroundSprite.setTexture(gameplayBackgroundTextures[selectedBackgroundIndex]);
-                        
-                        // Scale the gameplay background to fit the window
-                        sf::Vector2u bgSize = gameplayBackgroundTextures[selectedBackgroundIndex].getSize();
-                        float bgScaleX = (float)windowWidth / bgSize.x;
-                        float bgScaleY = (float)windowHeight / bgSize.y;
-                        gameplayBackgroundSprite.setScale({bgScaleX, bgScaleY});
+        if (!running) break;
+
+        // Run as many fixed ticks as real time calls for
+        timeSinceLastUpdate += clock.restart();
+        while (timeSinceLastUpdate >= timePerFrame) {
+            timeSinceLastUpdate -= timePerFrame;
+
+            bool rematchDown = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Enter) ||
+                               sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Space) ||
+                               (sf::Joystick::isConnected(0) && sf::Joystick::isButtonPressed(0, 0));
+            bool backDown = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Escape) ||
+                            (sf::Joystick::isConnected(0) && sf::Joystick::isButtonPressed(0, 1));
+
+            switch (gameState) {
+                case GameState::MainMenu:
+                {
+                    // Check for game start
+                    if ((sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Enter) ||
+                        (sf::Joystick::isConnected(0) && sf::Joystick::isButtonPressed(0, 7))) // Start button
+                        && !world.getPlayers().empty()) {
+                        startMatch();
                     }
-                    gameState = GameState::Gameplay;
+                    break;
                 }
 
-                window.clear();
-                window.draw(menuBackgroundSprite);
-                window.draw(menuOverlay); // Dark overlay to make UI stand out
-                window.draw(titleCardSprite);
-                window.draw(joinPromptSprite);
-                
-                // Draw dino previews and p1-p4 indicators for joined players
-                for (int i = 0; i < players.size() && i < 4; i++) {
-                    window.draw(playerDinoPreviewSprites[i]); // Draw dino sprite above
-                    window.draw(playerIndicatorSprites[i]);    // Draw p1-p4 indicator below
-                }
-                
-                window.display();
-                break;
-            }
-            
-        
-
-            case GameState::Gameplay:
-            {
-                // --- Gameplay Logic ---
-                for (auto& player : players) {
-                    sf::Vector2f aimDir = {0,0};
-                    bool throwPressed = false;
-                    int controllerId = player.getControllerId();
-                    
-                    if (controllerId != -1 && sf::Joystick::isConnected(controllerId)) {
-                        // DEBUG: Print all axis values to find the right stick mapping
-                        ;
-                        
-                        // Get aim direction from right stick (using Z and R axes)
-                        float rightX = sf::Joystick::getAxisPosition(controllerId, sf::Joystick::Axis::Z);
-                        float rightY = sf::Joystick::getAxisPosition(controllerId, sf::Joystick::Axis::R);
-                        
-                        // Apply deadzone but still pass the direction if outside deadzone
-                        const float deadZone = 25.0f;
-                        if (std::abs(rightX) > deadZone || std::abs(rightY) > deadZone) {
-                            // Normalize the direction vector
-                            aimDir = bnormalize({rightX, rightY});
-                            
+                case GameState::Gameplay:
+                {
+                    // --- Gameplay Logic ---
+                    // Sample every joined controller and let the bots think; inputs
+                    // are indexed by player id and any change is timestamped for
+                    // the latency overlay
+                    // With --alloc-strict none of the tick's work may touch the
+                    // heap
+                    inputs.resize(slotBots.size());
+                    lastInputs.resize(slotBots.size());
+                    bool changed = false;
+                    {
+                        AllocTracker::Scope tag(AllocSubsystem::Bots);
+                        AllocTracker::Forbid noAllocations(allocStrict);
+                        for (const auto& player : world.getPlayers()) {
+                            PlayerInput& input = inputs[player.getId()];
+                            if (slotBots[player.getId()]) {
+                                input = slotBots[player.getId()]->think(world, player.getId());
+                                continue;
+                            }
+                            input = readPlayerInput(player.getControllerId());
+                            changed |= inputChanged(lastInputs[player.getId()], input);
+                            lastInputs[player.getId()] = input;
                         }
-                        // If inside deadzone, aimDir stays {0,0} and player keeps last direction
-                        
-                        // Check throw button state (R1)
-                        throwPressed = sf::Joystick::isButtonPressed(controllerId, 5);
                     }
-
-                    // Handle throw input
-                    player.handleThrowInput(throwPressed, aimDir);
-                    
-                    // Handle player movement
-                    player.handleInput();
-                    if (player.getReadyToThrow() && boomerangs.size() < 1) {
-                        Boomerang boomerang(boomerangTexture, player.getPosition(), player.releaseThrow(), player.getId());
-                        boomerangs.push_back(boomerang);
+                    if (changed) {
+                        ++inputSequence;
+                        inputTime = gameClock.getElapsedTime();
                     }
-                }
-
-
-                for (auto& player : players) {
-                    player.handleInput();  // Handle input for each player
-                    player.update(tiles);
-                }
-
-                for (auto& boomerang : boomerangs) {
-                    int ownerId = boomerang.getOwnerId();
-                    if (ownerId >= 0 && ownerId < players.size()) {
-                        boomerang.update(players[ownerId].getPosition(), tiles); 
+                    {
+                        AllocTracker::Scope tag(AllocSubsystem::Simulation);
+                        AllocTracker::Forbid noAllocations(allocStrict);
+                        world.step(inputs);
+                    }
+                    {
+                        AllocTracker::Scope tag(AllocSubsystem::Audio);
+                        AllocTracker::Forbid noAllocations(allocStrict);
+                        audio.onEvents(world.getStepEvents(), ARENA_COLUMNS * TILE_SIZE);
+                    }
+                    {
+                        AllocTracker::Scope tag(AllocSubsystem::Telemetry);
+                        {
+                            AllocTracker::Forbid noAllocations(allocStrict);
+                            recording.recordTick(world);
+                        }
+                        // The next chunk is taken outside the check; it only
+                        // allocates in a match longer than any so far
+                        recording.prepare();
+                    }
+                    {
+                        AllocTracker::Scope tag(AllocSubsystem::Killcam);
+                        AllocTracker::Forbid noAllocations(allocStrict);
+                        replay.record(world);
                     }
-                }
 
-                for (auto& boomerang : boomerangs) {
-                    for (auto& player : players) {
-                        sf::FloatRect boomBounds = boomerang.getBounds();
-                        sf::FloatRect playerBounds = player.getBounds();
-                        if(boomBounds.findIntersection(playerBounds) && boomerang.getOwnerId() != player.getId() && player.isAlive()){
-                            player.kill();    
+                    if(world.getPlayers().size() == 1 && !gameOverTriggered) {
+                        // After 1 second with one player remaining, trigger game over
+                        if (++gameOverDelayTicks >= gameOverDelay) {
+                            gameState = GameState::GameOver;
+                            if (killcamMode != "off" && !world.getKills().empty() &&
+                                killcam.start(replay, world.getKills().back().tick + 1)) {
+                                gameState = GameState::Replay;
+                            }
+                            gameOverTriggered = true;
+                            nextBackgroundIndex = bgDist(gen);
+                            matchStats.print(std::cout);
+                            int winnerId = world.getAliveCount() == 1 ? world.getPlayers()[0].getId() : -1;
+                            if (winnerId >= 0 && winnerId < RenderSnapshot::MaxPlayers) ++wins[winnerId];
+                            recording.finish(winnerId);
+                            telemetry.submit(std::move(recording));
                         }
+                    } else if (world.getPlayers().size() > 1) {
+                        // Reset the timer if players are revived or added back
+                        gameOverDelayTicks = 0;
                     }
+                    break;
                 }
 
-                boomerangs.erase(
-                    std::remove_if(boomerangs.begin(), boomerangs.end(), 
-                        [](const Boomerang& b) {
-                            return b.getState() == Boomerang::State::Caught;
-                        }),
-                    boomerangs.end()
-                );
-
-
-                players.erase(
-                    std::remove_if(players.begin(), players.end(), 
-                        [](const Player& p) {
-                            return p.isDeathAnimationComplete() == true;
-                        }),
-                    players.end()
-                );
-
-                if(players.size() == 1 && !gameOverTriggered) {
-                    if (gameOverDelay == sf::Time::Zero) {
-                        // Start the delay timer when we first detect one player remaining
-                        gameOverDelay = clock.getElapsedTime();
-                    } else if (clock.getElapsedTime() - gameOverDelay >= sf::seconds(1.0f)) {
-                        // After 1 second delay, trigger game over
-                        gameState = GameState::GameOver;
-                        gameOverTriggered = true;
+                case GameState::Replay:
+                    // Played back below, one recorded tick per snapshot
+                    break;
+
+                case GameState::GameOver:
+                {
+                    // Handle input for game over screen: pressing Enter, Space or the
+                    // first controller's button 0 plays again with the same players;
+                    // Escape or its button 1 goes back to the join screen
+                    if (rematchDown && !rematchHeld) {
+                        std::cout << "Button pressed - rematch" << std::endl;
+                        rematch();
+                    } else if (backDown && !backHeld) {
+                        std::cout << "Button pressed - back to the join screen" << std::endl;
+                        resetToMainMenu(gameState, gameOverTriggered, world, joinedControllers, slotBots,
+                                        gameOverDelayTicks);
+                        for (int i = 0; i < botCount; i++) addBot();
                     }
-                } else if (players.size() > 1) {
-                    // Reset the timer if players are revived or added back
-                    gameOverDelay = sf::Time::Zero;
+                    break;
                 }
-
-                window.clear(sf::Color(50, 50, 150));
-                window.draw(gameplayBackgroundSprite);
-                for (const auto& tile : tiles) { window.draw(tile); }
-                for (auto& player : players) { player.draw(window); }
-                for (auto& boomerang : boomerangs) { boomerang.draw(window); }
-                window.display();
-                break;
             }
-            case GameState::GameOver: 
-            {
-                // Handle input for game over screen
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Enter) ||
-                    sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Space) ||
-                    (sf::Joystick::isConnected(0) && sf::Joystick::isButtonPressed(0, 0))) {  // Any button on any controller
-                    
-                    std::cout << "Button pressed - restarting" << std::endl;
-                    resetToMainMenu(gameState, gameOverTriggered, players, boomerangs, joinedControllers, gameOverDelay);
-                }
+            rematchHeld = rematchDown;
+            backHeld = backDown;
 
-                // Draw the game state
-                window.clear(sf::Color(50, 50, 150));
-                window.draw(gameplayBackgroundSprite);
-                for (const auto& tile : tiles) { window.draw(tile); }
-                for (auto& player : players) { player.draw(window); }
-                for (auto& boomerang : boomerangs) { boomerang.draw(window); }
-                
-                // Draw overlay and game over screen
-                window.draw(overlay);
-                window.draw(gameOverSprite);
-                window.draw(restartSprite);
-                
-                window.display();
-                break;
+            // Hand this tick to the render thread
+            RenderSnapshot& snapshot = snapshots.writeBuffer();
+            if (gameState == GameState::Replay && !killcam.step(snapshot)) {
+                gameState = GameState::GameOver;
             }
+            AllocTracker::Scope tag(AllocSubsystem::Render);
+            AllocTracker::Forbid noAllocations(allocStrict && gameState == GameState::Gameplay);
+            if (gameState != GameState::Replay) captureWorld(world, snapshot);
+            captureScores(world, snapshot);
+            snapshot.scoreCount = static_cast<int>(slotBots.size());
+            snapshot.wins = wins;
+            snapshot.time = gameClock.getElapsedTime() - timeSinceLastUpdate;
+            snapshot.gameState = gameState;
+            snapshot.backgroundIndex = selectedBackgroundIndex;
+            snapshot.nextBackgroundIndex = nextBackgroundIndex;
+            snapshot.joinedCount = static_cast<int>(world.getPlayers().size());
+            snapshot.inputSequence = inputSequence;
+            snapshot.inputTime = inputTime;
+            if (spectators) spectators->publish(snapshot);
+            snapshots.publish();
+            audio.endTick();
+            AllocTracker::endTick();
         }
+
+        // Sleep until the next tick is due
+        sf::sleep(timePerFrame - timeSinceLastUpdate);
     }
 
+    rendering = false;
+    renderThread.join();
+    window.close();
+
+    const FramePacer::Stats& frames = pacer.getStats();
+    std::cout << "Frame pacing (" << FramePacer::modeName(pacer.getMode()) << "): " << frames.frames << " frames, "
+              << frames.droppedFrames << " dropped, mean " << frames.meanMs << " ms, jitter " << frames.jitterMs
+              << " ms, p99 " << frames.p99Ms << " ms, max " << frames.maxMs << " ms" << std::endl;
+    if (audioOutput) {
+        audioOutput->stop();
+        std::cout << "Audio (" << audioOutput->getName() << "): " << audio.getLateCount() << " late, "
+                  << audio.getStolenCount() << " voices stolen, " << audio.getDroppedCount() << " dropped" << std::endl;
+    }
+    if (spectators) {
+        std::cout << "Spectator stream: " << spectators->getDroppedTicks() << " ticks dropped, "
+                  << spectators->getResyncCount() << " slow client resyncs" << std::endl;
+    }
+    if (AllocTracker::Enabled) AllocTracker::printReport(std::cout);
+
     return 0;
 }
-
@@ -0,0 +1,193 @@
+// Spectator display for a match streamed with `runner --spectate`.
+//
+// Connects to the game, decodes the per-tick stream and draws it with the
+// game's own renderer, blending ticks like the game does. Nothing is
+// simulated here, so any number of commentary screens can watch one match.
+// If the connection drops, the last frame stays up and the client keeps
+// trying to reconnect.
+//
+//   ./dino_spectator tcp:192.168.1.20:7777
+//   ./dino_spectator unix:/tmp/dino.sock
+//
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "level.hpp"
+#include "render_snapshot.hpp"
+#include "renderer.hpp"
+#include "presenter.hpp"
+#include "spectator_stream.hpp"
+#include "telemetry_format.hpp"
+#include "tuning.hpp"
+
+namespace {
+
+// One connection to the game and what has been decoded from it so far
+struct Connection {
+    int socket = -1;
+    std::vector<std::uint8_t> inbox;
+    bool greeted = false;       // Hello received
+    int levelIndex = 0;
+    SpectatorState state;
+    bool synced = false;        // A keyframe has arrived
+
+    void close() {
+        if (socket >= 0) ::close(socket);
+        socket = -1;
+        inbox.clear();
+        greeted = false;
+        synced = false;
+    }
+};
+
+// Reads whatever has arrived. Returns false once the connection is gone.
+bool receive(Connection& connection) {
+    std::uint8_t buffer[4096];
+    while (true) {
+        ssize_t result = recv(connection.socket, buffer, sizeof(buffer), 0);
+        if (result > 0) {
+            connection.inbox.insert(connection.inbox.end(), buffer, buffer + result);
+            continue;
+        }
+        if (result < 0 && errno == EINTR) continue;
+        if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+        return false;
+    }
+}
+
+// Decodes every complete message in the inbox. Returns false if the stream
+// is not one we understand.
+bool decode(Connection& connection, int& ticksDecoded) {
+    const std::uint8_t* begin = connection.inbox.data();
+    const std::uint8_t* end = begin + connection.inbox.size();
+    const std::uint8_t* position = begin;
+
+    if (!connection.greeted) {
+        if (end - position < 5) return true;
+        if (std::memcmp(position, SPECTATOR_MAGIC, 4) != 0 || position[4] != SPECTATOR_VERSION) {
+            std::cerr << "Error: Not a Dino Fu spectator stream, or a different version" << std::endl;
+            return false;
+        }
+        TelemetryReader reader(position + 5, end);
+        std::uint64_t levelIndex = reader.varint();
+        if (!reader.ok) return true;
+        if (levelIndex >= builtinLevels().size()) {
+            std::cerr << "Error: Unknown arena " << levelIndex << std::endl;
+            return false;
+        }
+        connection.levelIndex = static_cast<int>(levelIndex);
+        connection.greeted = true;
+        position = reader.position;
+    }
+
+    while (position < end) {
+        TelemetryReader reader(position, end);
+        std::uint64_t length = reader.varint();
+        if (!reader.ok || length > static_cast<std::uint64_t>(end - reader.position)) break;
+        if (!decodeSpectatorMessage(reader.position, length, connection.state, connection.synced)) {
+            std::cerr << "Error: Bad message in the spectator stream" << std::endl;
+            return false;
+        }
+        ++ticksDecoded;
+        position = reader.position + length;
+    }
+
+    connection.inbox.erase(connection.inbox.begin(), connection.inbox.begin() + (position - begin));
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string address = argc > 1 ? argv[1] : "tcp:" + std::to_string(SPECTATOR_DEFAULT_PORT);
+    if (argc > 2 || address == "--help" || address == "-h") {
+        std::cout << "Usage: dino_spectator [tcp:HOST:PORT | tcp:PORT | unix:PATH]" << std::endl;
+        return argc > 2 ? 1 : 0;
+    }
+
+    // Drawn at the game's canvas size and scaled to fit however the window
+    // is resized, so commentary screens of any size show the whole arena
+    sf::RenderWindow window(sf::VideoMode({Presenter::CanvasWidth, Presenter::CanvasHeight}), "Dino Fu - Spectator");
+    window.setVerticalSyncEnabled(true);
+    Presenter presenter;
+    sf::Vector2u windowSize = window.getSize();
+
+    // Created once the game says which arena it is playing
+    std::unique_ptr<Renderer> renderer;
+    int rendererLevel = -1;
+
+    Connection connection;
+    sf::Clock reconnectClock;
+    bool firstAttempt = true;
+
+    const sf::Time timePerTick = sf::seconds(1.f / 60.f);
+    sf::Clock clock;
+    sf::Clock frameClock;
+    RenderSnapshot previous;
+    RenderSnapshot current;
+    RenderSnapshot blended;
+    bool haveFrame = false;
+
+    while (window.isOpen()) {
+        while (const auto event = window.pollEvent()) {
+            if (event->is<sf::Event::Closed>()) window.close();
+            if (const auto* resized = event->getIf<sf::Event::Resized>()) windowSize = resized->size;
+        }
+
+        if (connection.socket < 0 && (firstAttempt || reconnectClock.getElapsedTime() > sf::seconds(1.f))) {
+            firstAttempt = false;
+            reconnectClock.restart();
+            connection.socket = connectSpectator(address);
+            if (connection.socket >= 0) {
+                fcntl(connection.socket, F_SETFL, fcntl(connection.socket, F_GETFL) | O_NONBLOCK);
+                std::cout << "Watching " << address << std::endl;
+            }
+        }
+
+        if (connection.socket >= 0) {
+            int ticksDecoded = 0;
+            bool open = receive(connection);
+            if (!decode(connection, ticksDecoded) || !open) {
+                std::cout << "Lost the game at " << address << "; retrying" << std::endl;
+                connection.close();
+                reconnectClock.restart();
+            } else if (ticksDecoded > 0 && connection.synced) {
+                // Several ticks can arrive at once after a hiccup; only the
+                // newest is shown
+                if (haveFrame) previous = current;
+                expandSnapshot(connection.state, current);
+                current.time = clock.getElapsedTime();
+                if (!haveFrame) previous = current;
+                haveFrame = true;
+            }
+
+            if (connection.greeted && connection.levelIndex != rendererLevel) {
+                rendererLevel = connection.levelIndex;
+                renderer = std::make_unique<Renderer>(presenter.getCanvasSize(), builtinLevels()[rendererLevel],
+                                                      Tuning());
+            }
+        }
+
+        sf::RenderTarget& canvas = presenter.beginFrame();
+        if (renderer && haveFrame) {
+            float alpha = std::clamp((clock.getElapsedTime() - current.time) / timePerTick, 0.0f, 1.0f);
+            interpolateSnapshots(previous, current, alpha, blended);
+            renderer->update(blended, frameClock.restart().asSeconds());
+            renderer->draw(canvas, blended);
+        }
+        presenter.present(window, windowSize);
+        window.display();
+    }
+
+    connection.close();
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include "spectator_publisher.hpp"
+#include "alloc_tracker.hpp"
+#include <cerrno>
+#include <chrono>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+SpectatorPublisher::SpectatorPublisher(const std::string& address, int levelIndex)
+    : m_listener(openSpectatorListener(address))
+    , m_levelIndex(levelIndex)
+    , m_running(true)
+    , m_dropped(0)
+    , m_resyncs(0)
+{
+    if (m_listener < 0) return;
+    std::cout << "Streaming to spectators on " << address << std::endl;
+    m_thread = std::thread(&SpectatorPublisher::run, this);
+}
+
+SpectatorPublisher::~SpectatorPublisher() {
+    m_running = false;
+    if (m_thread.joinable()) m_thread.join();
+    for (const Client& client : m_clients) close(client.socket);
+    if (m_listener >= 0) close(m_listener);
+}
+
+bool SpectatorPublisher::isOpen() const { return m_listener >= 0; }
+
+void SpectatorPublisher::publish(const RenderSnapshot& snapshot) {
+    if (m_listener < 0) return;
+    if (!m_queue.tryPush(snapshot)) m_dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::uint64_t SpectatorPublisher::getDroppedTicks() const { return m_dropped.load(std::memory_order_relaxed); }
+std::uint64_t SpectatorPublisher::getResyncCount() const { return m_resyncs.load(std::memory_order_relaxed); }
+
+void SpectatorPublisher::run() {
+    AllocTracker::Scope tag(AllocSubsystem::Spectator);
+    RenderSnapshot snapshot;
+    SpectatorState previous;
+    SpectatorState current;
+    bool havePrevious = false;
+    std::vector<std::uint8_t> delta;
+    std::vector<std::uint8_t> keyframe;
+
+    while (m_running.load(std::memory_order_acquire)) {
+        acceptClients();
+
+        bool idle = true;
+        while (m_queue.tryPop(snapshot)) {
+            idle = false;
+            quantizeSnapshot(snapshot, current);
+
+            // One delta shared by every client that is in step; a keyframe
+            // only when someone needs one
+            delta.clear();
+            keyframe.clear();
+            if (havePrevious) encodeSpectatorMessage(current, &previous, delta);
+            for (Client& client : m_clients) {
+                if (client.needsKeyframe || !havePrevious) {
+                    if (keyframe.empty()) encodeSpectatorMessage(current, nullptr, keyframe);
+                    append(client, keyframe);
+                    client.needsKeyframe = false;
+                } else {
+                    append(client, delta);
+                }
+                if (client.backlog.size() > MaxBacklogBytes) dropBacklog(client);
+            }
+            previous = current;
+            havePrevious = true;
+        }
+
+        for (std::size_t i = 0; i < m_clients.size();) {
+            if (flush(m_clients[i])) {
+                ++i;
+                continue;
+            }
+            close(m_clients[i].socket);
+            m_clients.erase(m_clients.begin() + i);
+            std::cout << "Spectator disconnected" << std::endl;
+        }
+
+        // Ticks arrive every ~16 ms, so polling each millisecond adds
+        // little delay
+        if (idle) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void SpectatorPublisher::acceptClients() {
+    while (true) {
+        int fd = accept(m_listener, nullptr, nullptr);
+        if (fd < 0) return;
+        if (m_clients.size() >= MaxClients) {
+            close(fd);
+            continue;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+#ifdef SO_NOSIGPIPE
+        int noSignal = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &noSignal, sizeof(noSignal));
+#endif
+
+        m_clients.push_back({fd, {}, {}, 0, 0, true});
+        std::vector<std::uint8_t> hello;
+        encodeSpectatorHello(m_levelIndex, hello);
+        append(m_clients.back(), hello);
+        std::cout << "Spectator connected" << std::endl;
+    }
+}
+
+void SpectatorPublisher::append(Client& client, const std::vector<std::uint8_t>& message) {
+    client.backlog.insert(client.backlog.end(), message.begin(), message.end());
+    client.messageSizes.push_back(message.size());
+}
+
+void SpectatorPublisher::dropBacklog(Client& client) {
+    // A message that is partly on the wire has to be finished, or the
+    // client loses track of where messages start. The hello always stays.
+    std::size_t keep = 0;
+    if (client.frontSent > 0 || client.messagesSent == 0) {
+        keep = client.messageSizes.front() - client.frontSent;
+        client.messageSizes.resize(1);
+    } else {
+        client.messageSizes.clear();
+    }
+    client.backlog.resize(keep);
+    client.needsKeyframe = true;
+    m_resyncs.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool SpectatorPublisher::flush(Client& client) {
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+    std::size_t sent = 0;
+    while (sent < client.backlog.size()) {
+        ssize_t result = send(client.socket, client.backlog.data() + sent, client.backlog.size() - sent, flags);
+        if (result < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return false;
+        }
+        sent += static_cast<std::size_t>(result);
+    }
+    if (sent == 0) return true;
+
+    client.backlog.erase(client.backlog.begin(), client.backlog.begin() + sent);
+    client.frontSent += sent;
+    while (!client.messageSizes.empty() && client.frontSent >= client.messageSizes.front()) {
+        client.frontSent -= client.messageSizes.front();
+        client.messageSizes.pop_front();
+        ++client.messagesSent;
+    }
+    return true;
+}
@@ -0,0 +1,72 @@
+#ifndef SPECTATOR_PUBLISHER_HPP
+#define SPECTATOR_PUBLISHER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+#include "render_snapshot.hpp"
+#include "spectator_stream.hpp"
+#include "spsc_queue.hpp"
+
+// Streams the match to dino_spectator clients over a socket.
+//
+// The game thread only copies each tick's snapshot into a lock-free ring;
+// encoding and all socket work happen on the publisher's own thread. Every
+// client gets a keyframe when it connects and one delta per tick after that.
+// A client that stops reading has its backlog thrown away once it passes
+// MaxBacklogBytes and gets a fresh keyframe when it catches up, so a slow
+// display loses ticks but never slows the match down.
+class SpectatorPublisher {
+public:
+    static constexpr std::size_t QueueCapacity = 64;            // About a second of ticks
+    static constexpr std::size_t MaxBacklogBytes = 64 * 1024;
+    static constexpr int MaxClients = 8;
+
+    // address as for openSpectatorListener; levelIndex tells clients which
+    // built-in arena to draw
+    SpectatorPublisher(const std::string& address, int levelIndex);
+    ~SpectatorPublisher();
+
+    SpectatorPublisher(const SpectatorPublisher&) = delete;
+    SpectatorPublisher& operator=(const SpectatorPublisher&) = delete;
+
+    bool isOpen() const;
+
+    // Game thread only. Never blocks or allocates; drops the tick if the
+    // publisher thread has fallen a whole queue behind.
+    void publish(const RenderSnapshot& snapshot);
+
+    std::uint64_t getDroppedTicks() const;     // Never reached the publisher thread
+    std::uint64_t getResyncCount() const;      // Times a slow client's backlog was thrown away
+
+private:
+    struct Client {
+        int socket;
+        std::vector<std::uint8_t> backlog;      // Encoded but not yet sent
+        std::deque<std::size_t> messageSizes;   // Message boundaries within the backlog
+        std::size_t frontSent;                  // Bytes of the first message already sent
+        std::uint64_t messagesSent;             // Completely sent; the first is the hello
+        bool needsKeyframe;
+    };
+
+    void run();
+    void acceptClients();
+    void append(Client& client, const std::vector<std::uint8_t>& message);
+    void dropBacklog(Client& client);
+    bool flush(Client& client);     // False once the connection is gone
+
+    int m_listener;
+    int m_levelIndex;
+    SpscQueue<RenderSnapshot, QueueCapacity> m_queue;
+    std::vector<Client> m_clients;
+
+    std::atomic<bool> m_running;
+    std::atomic<std::uint64_t> m_dropped;
+    std::atomic<std::uint64_t> m_resyncs;
+    std::thread m_thread;
+};
+
+#endif
@@ -0,0 +1,328 @@
+#include "spectator_stream.hpp"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "telemetry_format.hpp"
+
+static std::int32_t quantize(float value, float scale) {
+    return static_cast<std::int32_t>(std::lround(value * scale));
+}
+
+void quantizeSnapshot(const RenderSnapshot& snapshot, SpectatorState& state) {
+    state.tick = snapshot.tick;
+    state.header[SpectatorState::GameStateField] = static_cast<std::int32_t>(snapshot.gameState);
+    state.header[SpectatorState::BackgroundField] = snapshot.backgroundIndex;
+    state.header[SpectatorState::JoinedField] = snapshot.joinedCount;
+
+    state.playerCount = snapshot.playerCount;
+    for (int i = 0; i < snapshot.playerCount; ++i) {
+        const RenderSnapshot::PlayerView& view = snapshot.players[i];
+        SpectatorState::PlayerFields& fields = state.players[i];
+        fields[SpectatorState::PlayerX] = quantize(view.position.x, SPECTATOR_POSITION_SCALE);
+        fields[SpectatorState::PlayerY] = quantize(view.position.y, SPECTATOR_POSITION_SCALE);
+        fields[SpectatorState::ThrowX] = quantize(view.throwVelocity.x, SPECTATOR_VELOCITY_SCALE);
+        fields[SpectatorState::ThrowY] = quantize(view.throwVelocity.y, SPECTATOR_VELOCITY_SCALE);
+        fields[SpectatorState::AimX] = quantize(view.aimDirection.x, SPECTATOR_DIRECTION_SCALE);
+        fields[SpectatorState::AimY] = quantize(view.aimDirection.y, SPECTATOR_DIRECTION_SCALE);
+        fields[SpectatorState::PlayerId] = view.id;
+        fields[SpectatorState::Frame] = view.frame;
+        fields[SpectatorState::PlayerState] = view.state;
+        fields[SpectatorState::Flags] = (view.facingRight ? SpectatorState::FacingRight : 0) |
+                                        (view.alive ? SpectatorState::Alive : 0) |
+                                        (view.chargingThrow ? SpectatorState::ChargingThrow : 0);
+    }
+
+    state.boomerangCount = snapshot.boomerangCount;
+    for (int i = 0; i < snapshot.boomerangCount; ++i) {
+        const RenderSnapshot::BoomerangView& view = snapshot.boomerangs[i];
+        SpectatorState::BoomerangFields& fields = state.boomerangs[i];
+        fields[SpectatorState::BoomerangX] = quantize(view.position.x, SPECTATOR_POSITION_SCALE);
+        fields[SpectatorState::BoomerangY] = quantize(view.position.y, SPECTATOR_POSITION_SCALE);
+        fields[SpectatorState::Rotation] = quantize(view.rotation, SPECTATOR_ROTATION_SCALE);
+        fields[SpectatorState::Owner] = view.ownerId;
+        fields[SpectatorState::BoomerangState] = view.state;
+    }
+}
+
+void expandSnapshot(const SpectatorState& state, RenderSnapshot& snapshot) {
+    snapshot.tick = state.tick;
+    snapshot.gameState = static_cast<GameState>(state.header[SpectatorState::GameStateField]);
+    snapshot.backgroundIndex = state.header[SpectatorState::BackgroundField];
+    snapshot.joinedCount = state.header[SpectatorState::JoinedField];
+
+    snapshot.playerCount = state.playerCount;
+    for (int i = 0; i < state.playerCount; ++i) {
+        const SpectatorState::PlayerFields& fields = state.players[i];
+        RenderSnapshot::PlayerView& view = snapshot.players[i];
+        view.position = {fields[SpectatorState::PlayerX] / SPECTATOR_POSITION_SCALE,
+                         fields[SpectatorState::PlayerY] / SPECTATOR_POSITION_SCALE};
+        view.throwVelocity = {fields[SpectatorState::ThrowX] / SPECTATOR_VELOCITY_SCALE,
+                              fields[SpectatorState::ThrowY] / SPECTATOR_VELOCITY_SCALE};
+        view.aimDirection = {fields[SpectatorState::AimX] / SPECTATOR_DIRECTION_SCALE,
+                             fields[SpectatorState::AimY] / SPECTATOR_DIRECTION_SCALE};
+        view.id = static_cast<std::uint8_t>(fields[SpectatorState::PlayerId]);
+        view.frame = static_cast<std::uint8_t>(fields[SpectatorState::Frame]);
+        view.state = static_cast<std::uint8_t>(fields[SpectatorState::PlayerState]);
+        view.facingRight = fields[SpectatorState::Flags] & SpectatorState::FacingRight;
+        view.alive = fields[SpectatorState::Flags] & SpectatorState::Alive;
+        view.chargingThrow = fields[SpectatorState::Flags] & SpectatorState::ChargingThrow;
+    }
+
+    snapshot.boomerangCount = state.boomerangCount;
+    for (int i = 0; i < state.boomerangCount; ++i) {
+        const SpectatorState::BoomerangFields& fields = state.boomerangs[i];
+        RenderSnapshot::BoomerangView& view = snapshot.boomerangs[i];
+        view.position = {fields[SpectatorState::BoomerangX] / SPECTATOR_POSITION_SCALE,
+                         fields[SpectatorState::BoomerangY] / SPECTATOR_POSITION_SCALE};
+        view.rotation = fields[SpectatorState::Rotation] / SPECTATOR_ROTATION_SCALE;
+        view.ownerId = static_cast<std::uint8_t>(fields[SpectatorState::Owner]);
+        view.state = static_cast<std::uint8_t>(fields[SpectatorState::BoomerangState]);
+    }
+}
+
+// Changed-field mask, then the difference of each changed field. A null
+// baseline means all zeros.
+template <std::size_t N>
+static void putFields(std::vector<std::uint8_t>& out, const std::array<std::int32_t, N>& fields,
+                      const std::array<std::int32_t, N>* baseline) {
+    std::uint64_t mask = 0;
+    for (std::size_t i = 0; i < N; ++i) {
+        std::int32_t before = baseline ? (*baseline)[i] : 0;
+        if (fields[i] != before) mask |= std::uint64_t(1) << i;
+    }
+    putVarint(out, mask);
+    for (std::size_t i = 0; i < N; ++i) {
+        if (!(mask & (std::uint64_t(1) << i))) continue;
+        std::int32_t before = baseline ? (*baseline)[i] : 0;
+        putZigzag(out, static_cast<std::int64_t>(fields[i]) - before);
+    }
+}
+
+template <std::size_t N>
+static void readFields(TelemetryReader& in, std::array<std::int32_t, N>& fields) {
+    std::uint64_t mask = in.varint();
+    for (std::size_t i = 0; i < N; ++i) {
+        if (mask & (std::uint64_t(1) << i)) fields[i] += static_cast<std::int32_t>(in.zigzag());
+    }
+}
+
+void encodeSpectatorHello(int levelIndex, std::vector<std::uint8_t>& out) {
+    out.insert(out.end(), SPECTATOR_MAGIC, SPECTATOR_MAGIC + 4);
+    out.push_back(SPECTATOR_VERSION);
+    putVarint(out, levelIndex);
+}
+
+void encodeSpectatorMessage(const SpectatorState& state, const SpectatorState* baseline,
+                            std::vector<std::uint8_t>& out) {
+    // Payload first, then its length in front of it
+    std::size_t start = out.size();
+    out.push_back(static_cast<std::uint8_t>(baseline ? SpectatorMessage::Delta : SpectatorMessage::Keyframe));
+    putVarint(out, baseline ? state.tick - baseline->tick : state.tick);
+    putFields(out, state.header, baseline ? &baseline->header : nullptr);
+
+    putVarint(out, state.playerCount);
+    for (int i = 0; i < state.playerCount; ++i) {
+        bool known = baseline && i < baseline->playerCount;
+        putFields(out, state.players[i], known ? &baseline->players[i] : nullptr);
+    }
+    putVarint(out, state.boomerangCount);
+    for (int i = 0; i < state.boomerangCount; ++i) {
+        bool known = baseline && i < baseline->boomerangCount;
+        putFields(out, state.boomerangs[i], known ? &baseline->boomerangs[i] : nullptr);
+    }
+
+    std::uint8_t length[10];
+    int lengthBytes = 0;
+    std::uint64_t remaining = out.size() - start;
+    while (remaining >= 0x80) {
+        length[lengthBytes++] = static_cast<std::uint8_t>(remaining | 0x80);
+        remaining >>= 7;
+    }
+    length[lengthBytes++] = static_cast<std::uint8_t>(remaining);
+    out.insert(out.begin() + start, length, length + lengthBytes);
+}
+
+bool decodeSpectatorMessage(const std::uint8_t* data, std::size_t size, SpectatorState& state, bool& synced) {
+    TelemetryReader in(data, data + size);
+    std::uint64_t kind = in.varint();
+    if (kind == static_cast<std::uint64_t>(SpectatorMessage::Keyframe)) {
+        state = SpectatorState();
+        synced = true;
+    } else if (kind != static_cast<std::uint64_t>(SpectatorMessage::Delta) || !synced) {
+        return false;
+    }
+
+    state.tick += in.varint();
+    readFields(in, state.header);
+
+    std::uint64_t playerCount = in.varint();
+    if (playerCount > RenderSnapshot::MaxPlayers) {
+        synced = false;
+        return false;
+    }
+    for (int i = 0; i < static_cast<int>(playerCount); ++i) {
+        // Slots the previous message didn't have start from zero
+        if (i >= state.playerCount) state.players[i] = SpectatorState::PlayerFields();
+        readFields(in, state.players[i]);
+    }
+    state.playerCount = static_cast<int>(playerCount);
+
+    std::uint64_t boomerangCount = in.varint();
+    if (boomerangCount > RenderSnapshot::MaxBoomerangs) {
+        synced = false;
+        return false;
+    }
+    for (int i = 0; i < static_cast<int>(boomerangCount); ++i) {
+        if (i >= state.boomerangCount) state.boomerangs[i] = SpectatorState::BoomerangFields();
+        readFields(in, state.boomerangs[i]);
+    }
+    state.boomerangCount = static_cast<int>(boomerangCount);
+
+    if (!in.ok) synced = false;
+    return in.ok;
+}
+
+// --- Sockets ---
+
+static bool splitAddress(const std::string& address, std::string& scheme, std::string& rest) {
+    std::size_t colon = address.find(':');
+    if (colon == std::string::npos) return false;
+    scheme = address.substr(0, colon);
+    rest = address.substr(colon + 1);
+    return scheme == "tcp" || scheme == "unix";
+}
+
+static bool makeUnixAddress(const std::string& path, sockaddr_un& address) {
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) return false;
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+    return true;
+}
+
+// The whole of text as a port number, 1-65535
+static bool parsePort(const std::string& text, std::uint16_t& port) {
+    unsigned int value = 0;
+    const char* end = text.data() + text.size();
+    auto result = std::from_chars(text.data(), end, value);
+    if (result.ec != std::errc() || result.ptr != end || value < 1 || value > 65535) return false;
+    port = static_cast<std::uint16_t>(value);
+    return true;
+}
+
+bool checkSpectatorListenAddress(const std::string& address) {
+    std::string scheme, rest;
+    if (!splitAddress(address, scheme, rest)) {
+        std::cerr << "Error: Bad spectator address " << address << " (use tcp:PORT or unix:PATH)" << std::endl;
+        return false;
+    }
+    if (scheme == "unix") {
+        sockaddr_un unixAddress;
+        if (makeUnixAddress(rest, unixAddress)) return true;
+        std::cerr << "Error: Bad socket path " << rest << std::endl;
+        return false;
+    }
+    if (rest.find(':') != std::string::npos) {
+        std::cerr << "Error: The game listens on every interface; use tcp:PORT, not " << address << std::endl;
+        return false;
+    }
+    std::uint16_t port;
+    if (!parsePort(rest, port)) {
+        std::cerr << "Error: Bad port " << rest << " (use 1-65535)" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int openSpectatorListener(const std::string& address) {
+    if (!checkSpectatorListenAddress(address)) return -1;
+    std::string scheme, rest;
+    splitAddress(address, scheme, rest);
+
+    int fd = -1;
+    if (scheme == "unix") {
+        sockaddr_un unixAddress;
+        makeUnixAddress(rest, unixAddress);
+        unlink(rest.c_str());   // A stale socket from a previous run
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && bind(fd, reinterpret_cast<sockaddr*>(&unixAddress), sizeof(unixAddress)) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    } else {
+        sockaddr_in tcpAddress;
+        std::memset(&tcpAddress, 0, sizeof(tcpAddress));
+        tcpAddress.sin_family = AF_INET;
+        tcpAddress.sin_addr.s_addr = htonl(INADDR_ANY);
+        std::uint16_t port = 0;
+        parsePort(rest, port);
+        tcpAddress.sin_port = htons(port);
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        if (fd >= 0) setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (fd >= 0 && bind(fd, reinterpret_cast<sockaddr*>(&tcpAddress), sizeof(tcpAddress)) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    if (fd < 0 || listen(fd, 8) != 0 || fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != 0) {
+        std::cerr << "Error: Could not listen for spectators on " << address << std::endl;
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int connectSpectator(const std::string& address) {
+    std::string scheme, rest;
+    if (!splitAddress(address, scheme, rest)) {
+        std::cerr << "Error: Bad spectator address " << address << " (use tcp:HOST:PORT or unix:PATH)" << std::endl;
+        return -1;
+    }
+
+    if (scheme == "unix") {
+        sockaddr_un unixAddress;
+        if (!makeUnixAddress(rest, unixAddress)) return -1;
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&unixAddress), sizeof(unixAddress)) == 0) return fd;
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+
+    // tcp:PORT means this machine
+    std::string host = "127.0.0.1";
+    std::string port = rest;
+    std::size_t colon = rest.rfind(':');
+    if (colon != std::string::npos) {
+        host = rest.substr(0, colon);
+        port = rest.substr(colon + 1);
+    }
+
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* results = nullptr;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &results) != 0) {
+        std::cerr << "Error: Could not resolve " << host << std::endl;
+        return -1;
+    }
+    int fd = -1;
+    for (addrinfo* result = results; result; result = result->ai_next) {
+        fd = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+        if (fd < 0) continue;
+        if (connect(fd, result->ai_addr, result->ai_addrlen) == 0) break;
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(results);
+    return fd;
+}
@@ -0,0 +1,88 @@
+#ifndef SPECTATOR_STREAM_HPP
+#define SPECTATOR_STREAM_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "render_snapshot.hpp"
+
+// --- Spectator stream layout ---
+// On connect the publisher sends the magic "DSPC", one version byte and the
+// arena index as a varint. Every message after that is its payload length
+// as a varint followed by the payload:
+//   kind          0 = keyframe, 1 = delta
+//   tick          keyframe: the tick; delta: ticks since the last message
+//   header        gameState, backgroundIndex, joinedCount
+//   playerCount   then the fields of each player
+//   boomerangCount then the fields of each boomerang
+// A group of fields is a varint bitmask of the fields that changed, then the
+// zigzag difference of each changed field in order. Keyframes are encoded
+// against an all-zero state and deltas against the previous message, so a
+// player standing still costs a single byte per tick.
+
+constexpr char SPECTATOR_MAGIC[4] = {'D', 'S', 'P', 'C'};
+constexpr std::uint8_t SPECTATOR_VERSION = 1;
+constexpr std::uint16_t SPECTATOR_DEFAULT_PORT = 7777;
+
+constexpr float SPECTATOR_POSITION_SCALE = 4.f;     // Quarter pixels
+constexpr float SPECTATOR_VELOCITY_SCALE = 16.f;
+constexpr float SPECTATOR_DIRECTION_SCALE = 1024.f;
+constexpr float SPECTATOR_ROTATION_SCALE = 16.f;
+
+enum class SpectatorMessage : std::uint8_t {
+    Keyframe,
+    Delta
+};
+
+// A RenderSnapshot as the stream sees it: every drawable value as an integer
+struct SpectatorState {
+    enum HeaderField { GameStateField, BackgroundField, JoinedField, HeaderFieldCount };
+    enum PlayerField { PlayerX, PlayerY, ThrowX, ThrowY, AimX, AimY, PlayerId, Frame, PlayerState, Flags,
+                       PlayerFieldCount };
+    enum BoomerangField { BoomerangX, BoomerangY, Rotation, Owner, BoomerangState, BoomerangFieldCount };
+
+    // Bits of the Flags field
+    static constexpr std::int32_t FacingRight = 1;
+    static constexpr std::int32_t Alive = 2;
+    static constexpr std::int32_t ChargingThrow = 4;
+
+    using PlayerFields = std::array<std::int32_t, PlayerFieldCount>;
+    using BoomerangFields = std::array<std::int32_t, BoomerangFieldCount>;
+
+    std::uint64_t tick = 0;
+    std::array<std::int32_t, HeaderFieldCount> header{};
+    int playerCount = 0;
+    int boomerangCount = 0;
+    std::array<PlayerFields, RenderSnapshot::MaxPlayers> players{};
+    std::array<BoomerangFields, RenderSnapshot::MaxBoomerangs> boomerangs{};
+};
+
+void quantizeSnapshot(const RenderSnapshot& snapshot, SpectatorState& state);
+
+// Fills everything a stream carries; times and input fields are left alone
+void expandSnapshot(const SpectatorState& state, RenderSnapshot& snapshot);
+
+// The connection header, sent once before the first message
+void encodeSpectatorHello(int levelIndex, std::vector<std::uint8_t>& out);
+
+// Appends one length-prefixed message to out: a keyframe when baseline is
+// nullptr, otherwise the changes since baseline
+void encodeSpectatorMessage(const SpectatorState& state, const SpectatorState* baseline,
+                            std::vector<std::uint8_t>& out);
+
+// Applies one message payload (without its length prefix) to state. Returns
+// false if it is malformed, or a delta arrives before any keyframe.
+bool decodeSpectatorMessage(const std::uint8_t* data, std::size_t size, SpectatorState& state, bool& synced);
+
+// Addresses are "tcp:PORT" (listen on every interface), "tcp:HOST:PORT" or
+// "unix:PATH". Both return a socket descriptor, or -1 after printing why.
+int openSpectatorListener(const std::string& address);  // Non-blocking
+int connectSpectator(const std::string& address);
+
+// Whether openSpectatorListener can take address: "tcp:PORT" with a port of
+// 1-65535, or "unix:PATH". Prints why not, for checking arguments up front.
+bool checkSpectatorListenAddress(const std::string& address);
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock-free ring buffer for exactly one producer thread and one
+// consumer thread. Capacity must be a power of two. Neither side ever blocks
+// or allocates: tryPush fails when the ring is full and tryPop fails when it
+// is empty.
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    SpscQueue() : m_head(0), m_tail(0) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side
+    bool tryPush(const T& item) {
+        std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead == Capacity) {
+            // Looks full with the head we saw last time; refresh it
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == Capacity) return false;
+        }
+        m_items[tail & (Capacity - 1)] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool tryPop(T& item) {
+        std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) return false;
+        }
+        item = m_items[head & (Capacity - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate; exact only when called from one of the two sides while the
+    // other is idle
+    std::size_t size() const {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+private:
+    // Producer and consumer indices live on separate cache lines so the two
+    // threads don't keep stealing the same line from each other
+    alignas(64) std::atomic<std::size_t> m_head;
+    std::size_t m_cachedTail = 0;           // Consumer's last view of m_tail
+    alignas(64) std::atomic<std::size_t> m_tail;
+    std::size_t m_cachedHead = 0;           // Producer's last view of m_head
+    alignas(64) std::array<T, Capacity> m_items;
+};
+
+#endif
@@ -0,0 +1,73 @@
+#include "state_hash.hpp"
+
+namespace {
+    constexpr std::uint64_t Prime1 = 11400714785074694791ull;
+    constexpr std::uint64_t Prime2 = 14029467366897019727ull;
+    constexpr std::uint64_t Prime3 = 1609587929392839161ull;
+    constexpr std::uint64_t Prime4 = 9650029242287828579ull;
+    constexpr std::uint64_t Prime5 = 2870177450012600261ull;
+
+    std::uint64_t rotateLeft(std::uint64_t x, int bits) { return (x << bits) | (x >> (64 - bits)); }
+
+    std::uint64_t mixLane(std::uint64_t lane, std::uint64_t input) {
+        lane += input * Prime2;
+        return rotateLeft(lane, 31) * Prime1;
+    }
+
+    std::uint64_t mergeRound(std::uint64_t hash, std::uint64_t lane) {
+        hash ^= mixLane(0, lane);
+        return hash * Prime1 + Prime4;
+    }
+
+    // Two words as the little-endian 64-bit value they'd be in memory
+    std::uint64_t join(std::uint32_t low, std::uint32_t high) {
+        return static_cast<std::uint64_t>(low) | (static_cast<std::uint64_t>(high) << 32);
+    }
+}
+
+StateHash::StateHash(std::uint64_t seed)
+    : m_seed(seed)
+    , m_lanes{seed + Prime1 + Prime2, seed + Prime2, seed, seed - Prime1}
+    , m_buffer{}
+    , m_buffered(0)
+    , m_length(0)
+{
+}
+
+void StateHash::consumeStripe() {
+    for (int lane = 0; lane < 4; ++lane) {
+        m_lanes[lane] = mixLane(m_lanes[lane], join(m_buffer[lane * 2], m_buffer[lane * 2 + 1]));
+    }
+    m_buffered = 0;
+    m_length += sizeof m_buffer;
+}
+
+std::uint64_t StateHash::finish() const {
+    std::uint64_t hash;
+    if (m_length > 0) {
+        hash = rotateLeft(m_lanes[0], 1) + rotateLeft(m_lanes[1], 7) + rotateLeft(m_lanes[2], 12) +
+               rotateLeft(m_lanes[3], 18);
+        for (std::uint64_t lane : m_lanes) hash = mergeRound(hash, lane);
+    } else {
+        hash = m_seed + Prime5;
+    }
+    hash += m_length + m_buffered * sizeof(std::uint32_t);
+
+    // The partial stripe, eight bytes and then four at a time
+    std::size_t word = 0;
+    for (; word + 2 <= m_buffered; word += 2) {
+        hash ^= mixLane(0, join(m_buffer[word], m_buffer[word + 1]));
+        hash = rotateLeft(hash, 27) * Prime1 + Prime4;
+    }
+    if (word < m_buffered) {
+        hash ^= m_buffer[word] * Prime1;
+        hash = rotateLeft(hash, 23) * Prime2 + Prime3;
+    }
+
+    hash ^= hash >> 33;
+    hash *= Prime2;
+    hash ^= hash >> 29;
+    hash *= Prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
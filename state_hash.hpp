@@ -0,0 +1,63 @@
+#ifndef STATE_HASH_HPP
+#define STATE_HASH_HPP
+
+#include <SFML/System.hpp>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Streaming 64-bit hash of simulation state, the xxHash64 algorithm over a
+// canonical layout: every value goes in as one or two little-endian 32-bit
+// words (floats by their bits, bools and enums widened), so the same state
+// hashes the same on any compiler and platform.
+//
+// Fed through the same visitState(visit) functions that name each field for
+// the desync tool, so it is called like a visitor and ignores the names:
+//
+//   StateHash hash(previous);
+//   player.visitState(hash);
+//   std::uint64_t value = hash.finish();
+class StateHash {
+public:
+    explicit StateHash(std::uint64_t seed = 0);
+
+    void operator()(const char*, std::uint32_t value) { addWord(value); }
+    void operator()(const char*, std::int32_t value) { addWord(static_cast<std::uint32_t>(value)); }
+    void operator()(const char*, std::uint64_t value) {
+        addWord(static_cast<std::uint32_t>(value));
+        addWord(static_cast<std::uint32_t>(value >> 32));
+    }
+    void operator()(const char*, bool value) { addWord(value ? 1u : 0u); }
+    void operator()(const char*, float value) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof bits);
+        addWord(bits);
+    }
+    void operator()(const char* field, sf::Vector2f value) {
+        (*this)(field, value.x);
+        (*this)(field, value.y);
+    }
+    template <typename Enum, typename = std::enable_if_t<std::is_enum_v<Enum>>>
+    void operator()(const char* field, Enum value) {
+        (*this)(field, static_cast<std::int32_t>(value));
+    }
+
+    // The hash of everything added so far; more can still be added after
+    std::uint64_t finish() const;
+
+private:
+    void addWord(std::uint32_t word) {
+        m_buffer[m_buffered++] = word;
+        if (m_buffered == m_buffer.size()) consumeStripe();
+    }
+    void consumeStripe();
+
+    std::uint64_t m_seed;
+    std::array<std::uint64_t, 4> m_lanes;
+    std::array<std::uint32_t, 8> m_buffer;    // One 32-byte stripe
+    std::size_t m_buffered;                   // Words in m_buffer
+    std::uint64_t m_length;                   // Bytes consumed in whole stripes
+};
+
+#endif
@@ -0,0 +1,304 @@
+#include "telemetry.hpp"
+#include "world.hpp"
+#include "alloc_tracker.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+static_assert(MatchRecording::MaxPlayers <= TELEMETRY_MAX_PLAYERS, "The analyzer must accept every recorded slot");
+
+static std::int32_t quantize(float value, float scale) {
+    return static_cast<std::int32_t>(std::lround(value * scale));
+}
+
+std::unique_ptr<TelemetryChunk> TelemetryChunkPool::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_free.empty()) {
+            std::unique_ptr<TelemetryChunk> chunk = std::move(m_free.back());
+            m_free.pop_back();
+            chunk->ticks = 0;
+            chunk->eventCount = 0;
+            return chunk;
+        }
+    }
+    return std::make_unique<TelemetryChunk>();
+}
+
+void TelemetryChunkPool::release(std::unique_ptr<TelemetryChunk> chunk) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_free.push_back(std::move(chunk));
+}
+
+MatchRecording::MatchRecording()
+    : m_pool(nullptr)
+    , m_matchIndex(0)
+    , m_seed(0)
+    , m_playerCount(0)
+    , m_winnerId(-1)
+    , m_ticks(0)
+    , m_lastX{}
+    , m_lastY{}
+{
+}
+
+MatchRecording::MatchRecording(TelemetryChunkPool& pool, int matchIndex, std::uint32_t seed,
+                               const std::string& levelName, int playerCount)
+    : m_pool(&pool)
+    , m_matchIndex(matchIndex)
+    , m_seed(seed)
+    , m_levelName(levelName)
+    , m_playerCount(std::min(playerCount, MaxPlayers))
+    , m_winnerId(-1)
+    , m_ticks(0)
+    , m_lastX{}
+    , m_lastY{}
+{
+    // Room for ten minutes of chunk pointers; prepare() makes more if needed
+    m_chunks.reserve(120);
+    m_chunks.push_back(pool.acquire());
+}
+
+MatchRecording::~MatchRecording() {
+    releaseChunks();
+}
+
+MatchRecording::MatchRecording(MatchRecording&& other) noexcept
+    : m_pool(other.m_pool)
+    , m_matchIndex(other.m_matchIndex)
+    , m_seed(other.m_seed)
+    , m_levelName(std::move(other.m_levelName))
+    , m_playerCount(other.m_playerCount)
+    , m_winnerId(other.m_winnerId)
+    , m_ticks(other.m_ticks)
+    , m_chunks(std::move(other.m_chunks))
+    , m_spare(std::move(other.m_spare))
+{
+    std::copy(std::begin(other.m_lastX), std::end(other.m_lastX), m_lastX);
+    std::copy(std::begin(other.m_lastY), std::end(other.m_lastY), m_lastY);
+    other.m_chunks.clear();
+}
+
+MatchRecording& MatchRecording::operator=(MatchRecording&& other) noexcept {
+    if (this == &other) return *this;
+    releaseChunks();
+    m_pool = other.m_pool;
+    m_matchIndex = other.m_matchIndex;
+    m_seed = other.m_seed;
+    m_levelName = std::move(other.m_levelName);
+    m_playerCount = other.m_playerCount;
+    m_winnerId = other.m_winnerId;
+    m_ticks = other.m_ticks;
+    m_chunks = std::move(other.m_chunks);
+    m_spare = std::move(other.m_spare);
+    std::copy(std::begin(other.m_lastX), std::end(other.m_lastX), m_lastX);
+    std::copy(std::begin(other.m_lastY), std::end(other.m_lastY), m_lastY);
+    other.m_chunks.clear();
+    return *this;
+}
+
+void MatchRecording::releaseChunks() {
+    if (!m_pool) return;
+    for (auto& chunk : m_chunks) m_pool->release(std::move(chunk));
+    if (m_spare) m_pool->release(std::move(m_spare));
+    m_chunks.clear();
+}
+
+void MatchRecording::prepare() {
+    if (!m_pool) return;
+    if (!m_spare) m_spare = m_pool->acquire();
+    if (m_chunks.size() == m_chunks.capacity()) m_chunks.reserve(m_chunks.size() * 2);
+}
+
+void MatchRecording::recordTick(const World& world) {
+    if (!m_pool) return;
+
+    // A chunk is full when it has no room for another tick or for the most
+    // events a tick can bring
+    TelemetryChunk* chunk = m_chunks.back().get();
+    if (chunk->ticks == TelemetryChunk::Ticks ||
+        chunk->eventCount + World::MaxStepEvents > TelemetryChunk::Events) {
+        prepare();
+        m_chunks.push_back(std::move(m_spare));
+        chunk = m_chunks.back().get();
+    }
+
+    int tick = chunk->ticks++;
+    for (int slot = 0; slot < m_playerCount; ++slot) {
+        const Player* player = world.findPlayer(slot);
+        if (player) {
+            m_lastX[slot] = quantize(player->getPosition().x, TELEMETRY_POSITION_SCALE);
+            m_lastY[slot] = quantize(player->getPosition().y, TELEMETRY_POSITION_SCALE);
+            chunk->state[slot][tick] = player->isAlive()
+                ? static_cast<std::uint8_t>(player->getState()) + static_cast<std::uint8_t>(TelemetryPlayerState::Normal)
+                : static_cast<std::uint8_t>(TelemetryPlayerState::Dying);
+        } else {
+            // Gone players keep their last position so the delta is zero
+            chunk->state[slot][tick] = static_cast<std::uint8_t>(TelemetryPlayerState::Absent);
+        }
+        chunk->x[slot][tick] = m_lastX[slot];
+        chunk->y[slot][tick] = m_lastY[slot];
+    }
+    const std::vector<GameEvent>& events = world.getStepEvents();
+    std::copy(events.begin(), events.end(), chunk->events + chunk->eventCount);
+    chunk->eventCount += static_cast<int>(events.size());
+    ++m_ticks;
+}
+
+void MatchRecording::finish(int winnerId) {
+    m_winnerId = winnerId;
+}
+
+int MatchRecording::getTickCount() const {
+    return m_ticks;
+}
+
+// Writes column as its length followed by its bytes
+static void putColumn(std::vector<std::uint8_t>& out, const std::vector<std::uint8_t>& column) {
+    putVarint(out, column.size());
+    out.insert(out.end(), column.begin(), column.end());
+}
+
+void MatchRecording::encode(std::vector<std::uint8_t>& out) const {
+    std::vector<std::uint8_t> payload;
+    putVarint(payload, m_matchIndex);
+    putVarint(payload, m_seed);
+    putVarint(payload, m_levelName.size());
+    payload.insert(payload.end(), m_levelName.begin(), m_levelName.end());
+    putVarint(payload, m_ticks);
+    putVarint(payload, m_playerCount);
+    putVarint(payload, m_winnerId + 1);
+    int eventCount = 0;
+    for (const auto& chunk : m_chunks) eventCount += chunk->eventCount;
+    putVarint(payload, eventCount);
+
+    std::vector<std::uint8_t> column;
+    auto putDeltas = [&](auto TelemetryChunk::*values, int slot) {
+        column.clear();
+        std::int64_t previous = 0;
+        for (const auto& chunk : m_chunks) {
+            const auto& row = ((*chunk).*values)[slot];
+            for (int tick = 0; tick < chunk->ticks; ++tick) {
+                putZigzag(column, static_cast<std::int64_t>(row[tick]) - previous);
+                previous = row[tick];
+            }
+        }
+        putColumn(payload, column);
+    };
+
+    for (int slot = 0; slot < m_playerCount; ++slot) {
+        putDeltas(&TelemetryChunk::x, slot);
+        putDeltas(&TelemetryChunk::y, slot);
+        putDeltas(&TelemetryChunk::state, slot);
+    }
+
+    // Event columns
+    for (int field = 0; field < static_cast<int>(TelemetryEventColumn::Count); ++field) {
+        column.clear();
+        std::int64_t previous = 0;
+        for (const auto& chunk : m_chunks) {
+            for (int i = 0; i < chunk->eventCount; ++i) {
+                const GameEvent& event = chunk->events[i];
+                switch (static_cast<TelemetryEventColumn>(field)) {
+                    case TelemetryEventColumn::Type: putVarint(column, static_cast<std::uint8_t>(event.type)); break;
+                    case TelemetryEventColumn::Tick: putVarint(column, event.tick - previous); previous = event.tick; break;
+                    case TelemetryEventColumn::Actor: putVarint(column, event.actorId); break;
+                    case TelemetryEventColumn::Target: putVarint(column, event.targetId + 1); break;
+                    case TelemetryEventColumn::X: {
+                        std::int32_t x = quantize(event.position.x, TELEMETRY_POSITION_SCALE);
+                        putZigzag(column, x - previous);
+                        previous = x;
+                        break;
+                    }
+                    case TelemetryEventColumn::Y: {
+                        std::int32_t y = quantize(event.position.y, TELEMETRY_POSITION_SCALE);
+                        putZigzag(column, y - previous);
+                        previous = y;
+                        break;
+                    }
+                    case TelemetryEventColumn::VX: putZigzag(column, quantize(event.vector.x, TELEMETRY_VELOCITY_SCALE)); break;
+                    case TelemetryEventColumn::VY: putZigzag(column, quantize(event.vector.y, TELEMETRY_VELOCITY_SCALE)); break;
+                    case TelemetryEventColumn::Cause: putVarint(column, event.cause); break;
+                    case TelemetryEventColumn::Count: break;
+                }
+            }
+        }
+        putColumn(payload, column);
+    }
+
+    out.insert(out.end(), TELEMETRY_BLOCK_MAGIC, TELEMETRY_BLOCK_MAGIC + 4);
+    std::uint32_t size = static_cast<std::uint32_t>(payload.size());
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<std::uint8_t>(size >> (8 * i)));
+    out.insert(out.end(), payload.begin(), payload.end());
+}
+
+TelemetryWriter::TelemetryWriter(const std::string& path)
+    : m_file(std::fopen(path.c_str(), "ab"))
+    , m_stopping(false)
+    , m_matchesWritten(0)
+{
+    if (!m_file) {
+        std::cerr << "Error: Could not open telemetry file " << path << std::endl;
+        return;
+    }
+    std::fseek(m_file, 0, SEEK_END);
+    if (std::ftell(m_file) == 0) {
+        std::fwrite(TELEMETRY_FILE_MAGIC, 1, 4, m_file);
+        std::fputc(TELEMETRY_VERSION, m_file);
+    }
+    m_thread = std::thread(&TelemetryWriter::run, this);
+}
+
+TelemetryWriter::~TelemetryWriter() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    if (m_thread.joinable()) m_thread.join();
+    if (m_file) std::fclose(m_file);
+}
+
+bool TelemetryWriter::isOpen() const {
+    return m_file != nullptr;
+}
+
+void TelemetryWriter::submit(MatchRecording recording) {
+    if (!m_file) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(std::move(recording));
+    }
+    m_wake.notify_one();
+}
+
+TelemetryChunkPool& TelemetryWriter::getChunkPool() {
+    return m_pool;
+}
+
+std::uint64_t TelemetryWriter::getMatchesWritten() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_matchesWritten;
+}
+
+void TelemetryWriter::run() {
+    AllocTracker::Scope tag(AllocSubsystem::Telemetry);
+    std::vector<std::uint8_t> buffer;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_wake.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+        if (m_queue.empty()) break;     // Stopping and drained
+
+        MatchRecording recording = std::move(m_queue.front());
+        m_queue.pop_front();
+        lock.unlock();
+
+        buffer.clear();
+        recording.encode(buffer);
+        std::fwrite(buffer.data(), 1, buffer.size(), m_file);
+
+        lock.lock();
+        ++m_matchesWritten;
+    }
+    std::fflush(m_file);
+}
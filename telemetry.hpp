@@ -0,0 +1,132 @@
+#ifndef TELEMETRY_HPP
+#define TELEMETRY_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "event_bus.hpp"
+#include "player_slots.hpp"
+#include "telemetry_format.hpp"
+
+class World;
+
+// Five seconds of a match's raw columns and the events that happened in
+// them. A recording is a list of these rather than growing vectors, so a
+// long match takes another chunk instead of reallocating and copying every
+// column.
+struct TelemetryChunk {
+    static constexpr int Ticks = 60 * 5;
+    static constexpr int Events = 1024;
+
+    int ticks = 0;
+    int eventCount = 0;
+    std::int32_t x[MAX_PLAYERS][Ticks];
+    std::int32_t y[MAX_PLAYERS][Ticks];
+    std::uint8_t state[MAX_PLAYERS][Ticks];
+    GameEvent events[Events];
+};
+
+// Chunks of finished matches, handed to the next ones. Only allocates when
+// a match runs longer than any before it. Thread-safe.
+class TelemetryChunkPool {
+public:
+    std::unique_ptr<TelemetryChunk> acquire();
+    void release(std::unique_ptr<TelemetryChunk> chunk);
+
+private:
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<TelemetryChunk>> m_free;
+};
+
+// Everything that happened in one match, kept as raw columns while it is
+// played. recordTick() only copies integers into chunks from a pool;
+// compressing and writing happen later on the TelemetryWriter's thread,
+// and the chunks go back to the pool when the recording is destroyed.
+class MatchRecording {
+public:
+    static constexpr int MaxPlayers = MAX_PLAYERS;
+
+    // Records nothing
+    MatchRecording();
+    // pool must outlive the recording; see TelemetryWriter::getChunkPool
+    MatchRecording(TelemetryChunkPool& pool, int matchIndex, std::uint32_t seed, const std::string& levelName,
+                   int playerCount);
+    ~MatchRecording();
+
+    MatchRecording(MatchRecording&& other) noexcept;
+    MatchRecording& operator=(MatchRecording&& other) noexcept;
+
+    // Call after every World::step(). Allocates nothing as long as
+    // prepare() was called since the last chunk filled up.
+    void recordTick(const World& world);
+
+    // Takes the chunk the next recordTick() may need, so a caller that
+    // can't allocate during the tick can do it between ticks instead
+    void prepare();
+
+    // winnerId is -1 when nobody won
+    void finish(int winnerId);
+
+    // Appends the block (magic, size and payload) to out
+    void encode(std::vector<std::uint8_t>& out) const;
+
+    int getTickCount() const;
+
+private:
+    void releaseChunks();
+
+    TelemetryChunkPool* m_pool;
+    int m_matchIndex;
+    std::uint32_t m_seed;
+    std::string m_levelName;
+    int m_playerCount;
+    int m_winnerId;
+    int m_ticks;
+
+    std::vector<std::unique_ptr<TelemetryChunk>> m_chunks;
+    std::unique_ptr<TelemetryChunk> m_spare;
+    // Where each slot was last seen, for ticks it is absent
+    std::int32_t m_lastX[MaxPlayers];
+    std::int32_t m_lastY[MaxPlayers];
+};
+
+// Appends finished matches to a telemetry file from a background thread, so
+// the game and the batch workers never wait on the disk. submit() may be
+// called from any thread.
+class TelemetryWriter {
+public:
+    // Appends to path, writing the file header if the file is new or empty
+    explicit TelemetryWriter(const std::string& path);
+    ~TelemetryWriter();   // Writes whatever is still queued
+
+    TelemetryWriter(const TelemetryWriter&) = delete;
+    TelemetryWriter& operator=(const TelemetryWriter&) = delete;
+
+    bool isOpen() const;
+    void submit(MatchRecording recording);
+    std::uint64_t getMatchesWritten() const;
+
+    // Where recordings for this writer get their chunks; written matches
+    // return theirs here
+    TelemetryChunkPool& getChunkPool();
+
+private:
+    void run();
+
+    TelemetryChunkPool m_pool;  // Outlives the queued recordings
+    std::FILE* m_file;
+    std::deque<MatchRecording> m_queue;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stopping;
+    std::uint64_t m_matchesWritten;
+    std::thread m_thread;
+};
+
+#endif
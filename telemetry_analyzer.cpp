@@ -0,0 +1,407 @@
+// Offline analyzer for telemetry files written by the game and dino_batch.
+//
+// Memory-maps every file given on the command line, walks the match blocks
+// and prints kill stats plus, for every arena, a heatmap of where players
+// spend their time, where they die, and the cells that kill the most
+// players for the time spent in them:
+//
+//   ./dino_telemetry telemetry.dtel batch_telemetry.dtel --csv cells.csv
+//
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "level.hpp"
+#include "telemetry_format.hpp"
+
+namespace {
+
+struct Options {
+    std::vector<std::string> paths;
+    std::string csvPath;
+    int top = 10;
+};
+
+struct ArenaStats {
+    std::string name;
+    const Level* level = nullptr;
+    int columns = 20;
+    int rows = 13;
+    std::uint64_t matches = 0;
+    std::uint64_t ticks = 0;
+    std::vector<std::uint64_t> occupancy;   // Alive player-ticks per cell
+    std::vector<std::uint64_t> deaths;      // Victims per cell
+};
+
+struct KillStats {
+    std::uint64_t matches = 0;
+    std::uint64_t ticks = 0;
+    std::uint64_t draws = 0;
+    int slots = 0;                          // Most players seen in one match
+    std::uint64_t winsBySlot[TELEMETRY_MAX_PLAYERS] = {};
+    std::uint64_t throws = 0;
+    std::uint64_t bounces = 0;
+    std::uint64_t catches = 0;
+    std::uint64_t dashes = 0;
+    std::uint64_t kills = 0;
+    std::uint64_t killsByCause[3] = {0, 0, 0};
+    std::uint64_t bankShots = 0;            // Kills after at least one bounce
+    std::uint64_t throwToKillTicks = 0;
+    std::uint64_t firstKillTicks = 0;
+    std::uint64_t matchesWithKills = 0;
+    std::uint64_t bytes = 0;
+};
+
+// Same values as GameEvent::Type, which the analyzer doesn't link against
+enum EventType { Throw, Bounce, Catch, Kill, Dash };
+
+void printUsage() {
+    std::cout << "Usage: dino_telemetry [options] FILE...\n"
+              << "  --csv FILE   write per-cell occupancy and deaths for every arena\n"
+              << "  --top N      death traps to list per arena (default 10)\n";
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return false;
+        }
+        if (arg == "--csv" && i + 1 < argc) options.csvPath = argv[++i];
+        else if (arg == "--top" && i + 1 < argc) {
+            std::string value = argv[++i];
+            try {
+                options.top = std::stoi(value);
+            } catch (const std::exception&) {
+                options.top = -1;
+            }
+            if (options.top < 0) {
+                std::cerr << "Error: Bad value " << value << " for --top" << std::endl;
+                printUsage();
+                return false;
+            }
+        }
+        else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Error: Bad argument " << arg << std::endl;
+            printUsage();
+            return false;
+        }
+        else options.paths.push_back(arg);
+    }
+    if (options.paths.empty()) {
+        printUsage();
+        return false;
+    }
+    return true;
+}
+
+ArenaStats& arenaFor(std::map<std::string, ArenaStats>& arenas, const std::string& name) {
+    auto found = arenas.find(name);
+    if (found != arenas.end()) return found->second;
+
+    ArenaStats& arena = arenas[name];
+    arena.name = name;
+    for (const auto& level : builtinLevels()) {
+        if (level.name == name && !level.rows.empty()) {
+            arena.level = &level;
+            arena.rows = static_cast<int>(level.rows.size());
+            arena.columns = static_cast<int>(level.rows[0].size());
+        }
+    }
+    arena.occupancy.assign(arena.columns * arena.rows, 0);
+    arena.deaths.assign(arena.columns * arena.rows, 0);
+    return arena;
+}
+
+// Cell index for a position in quarter pixels, or -1 outside the map
+int cellAt(const ArenaStats& arena, std::int64_t x, std::int64_t y) {
+    int column = static_cast<int>(x / TELEMETRY_POSITION_SCALE / TILE_SIZE);
+    int row = static_cast<int>(y / TELEMETRY_POSITION_SCALE / TILE_SIZE);
+    if (x < 0 || y < 0 || column >= arena.columns || row >= arena.rows) return -1;
+    return row * arena.columns + column;
+}
+
+bool analyzeMatch(TelemetryReader& block, std::map<std::string, ArenaStats>& arenas, KillStats& stats) {
+    block.varint();     // Match index
+    block.varint();     // Seed
+    std::uint64_t nameLength = block.varint();
+    if (!block.ok || nameLength > static_cast<std::uint64_t>(block.end - block.position)) return false;
+    std::string levelName(reinterpret_cast<const char*>(block.position), nameLength);
+    block.position += nameLength;
+    std::uint64_t ticks = block.varint();
+    int playerCount = static_cast<int>(block.varint());
+    int winnerId = static_cast<int>(block.varint()) - 1;
+    std::uint64_t eventCount = block.varint();
+    if (!block.ok || playerCount > TELEMETRY_MAX_PLAYERS) return false;
+
+    ArenaStats& arena = arenaFor(arenas, levelName);
+    ++arena.matches;
+    arena.ticks += ticks;
+    ++stats.matches;
+    stats.ticks += ticks;
+    stats.slots = std::max(stats.slots, playerCount);
+    if (winnerId >= 0 && winnerId < TELEMETRY_MAX_PLAYERS) ++stats.winsBySlot[winnerId];
+    else ++stats.draws;
+
+    // Player columns: only occupancy is needed, so decode x, y and state in step
+    for (int slot = 0; slot < playerCount; ++slot) {
+        TelemetryReader xs = block.column();
+        TelemetryReader ys = block.column();
+        TelemetryReader states = block.column();
+        std::int64_t x = 0, y = 0, state = 0;
+        for (std::uint64_t tick = 0; tick < ticks; ++tick) {
+            x += xs.zigzag();
+            y += ys.zigzag();
+            state += states.zigzag();
+            if (state == static_cast<int>(TelemetryPlayerState::Absent) ||
+                state == static_cast<int>(TelemetryPlayerState::Dying)) continue;
+            int cell = cellAt(arena, x, y);
+            if (cell >= 0) ++arena.occupancy[cell];
+        }
+        if (!xs.ok || !ys.ok || !states.ok) return false;
+    }
+
+    // Event columns
+    std::vector<TelemetryReader> columns;
+    for (int field = 0; field < static_cast<int>(TelemetryEventColumn::Count); ++field) {
+        columns.push_back(block.column());
+    }
+    if (!block.ok) return false;
+    auto& types = columns[static_cast<int>(TelemetryEventColumn::Type)];
+    auto& tickDeltas = columns[static_cast<int>(TelemetryEventColumn::Tick)];
+    auto& actors = columns[static_cast<int>(TelemetryEventColumn::Actor)];
+    auto& targets = columns[static_cast<int>(TelemetryEventColumn::Target)];
+    auto& xs = columns[static_cast<int>(TelemetryEventColumn::X)];
+    auto& ys = columns[static_cast<int>(TelemetryEventColumn::Y)];
+    auto& causes = columns[static_cast<int>(TelemetryEventColumn::Cause)];
+
+    std::int64_t tick = 0, x = 0, y = 0;
+    std::int64_t lastThrowTick[TELEMETRY_MAX_PLAYERS] = {};
+    int bouncesSinceThrow[TELEMETRY_MAX_PLAYERS] = {};
+    bool anyKill = false;
+    for (std::uint64_t i = 0; i < eventCount; ++i) {
+        int type = static_cast<int>(types.varint());
+        tick += tickDeltas.varint();
+        int actor = std::min(static_cast<int>(actors.varint()), TELEMETRY_MAX_PLAYERS - 1);
+        targets.varint();
+        x += xs.zigzag();
+        y += ys.zigzag();
+        int cause = static_cast<int>(causes.varint());
+        // A column that ran out means eventCount is wrong; stop rather than
+        // read on through garbage for however many events it claims
+        for (const auto& column : columns) {
+            if (!column.ok) return false;
+        }
+
+        switch (type) {
+            case Throw:
+                ++stats.throws;
+                lastThrowTick[actor] = tick;
+                bouncesSinceThrow[actor] = 0;
+                break;
+            case Bounce:
+                ++stats.bounces;
+                ++bouncesSinceThrow[actor];
+                break;
+            case Catch:
+                ++stats.catches;
+                break;
+            case Dash:
+                ++stats.dashes;
+                break;
+            case Kill: {
+                ++stats.kills;
+                if (cause >= 0 && cause < 3) ++stats.killsByCause[cause];
+                if (bouncesSinceThrow[actor] > 0) ++stats.bankShots;
+                stats.throwToKillTicks += tick - lastThrowTick[actor];
+                if (!anyKill) {
+                    stats.firstKillTicks += tick;
+                    ++stats.matchesWithKills;
+                    anyKill = true;
+                }
+                int cell = cellAt(arena, x, y);
+                if (cell >= 0) ++arena.deaths[cell];
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+bool analyzeFile(const std::string& path, std::map<std::string, ArenaStats>& arenas, KillStats& stats) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: Could not open " << path << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < 5) {
+        std::cerr << "Error: " << path << " is not a telemetry file" << std::endl;
+        close(fd);
+        return false;
+    }
+    std::size_t size = static_cast<std::size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Error: Could not map " << path << std::endl;
+        return false;
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+
+    const std::uint8_t* data = static_cast<const std::uint8_t*>(mapping);
+    const std::uint8_t* end = data + size;
+    bool ok = std::memcmp(data, TELEMETRY_FILE_MAGIC, 4) == 0 && data[4] == TELEMETRY_VERSION;
+    if (!ok) std::cerr << "Error: " << path << " is not a version " << int(TELEMETRY_VERSION) << " telemetry file" << std::endl;
+
+    const std::uint8_t* position = data + 5;
+    while (ok && end - position >= 8) {
+        if (std::memcmp(position, TELEMETRY_BLOCK_MAGIC, 4) != 0) break;
+        std::uint32_t blockSize = position[4] | (position[5] << 8) | (position[6] << 16) |
+                                  (static_cast<std::uint32_t>(position[7]) << 24);
+        position += 8;
+        if (blockSize > static_cast<std::size_t>(end - position)) break;     // Truncated by a crash
+        TelemetryReader block(position, position + blockSize);
+        if (!analyzeMatch(block, arenas, stats)) {
+            std::cerr << "Warning: Skipping a corrupt match in " << path << std::endl;
+        }
+        position += blockSize;
+    }
+    if (ok && position != end) std::cerr << "Warning: Ignoring " << (end - position) << " trailing bytes in " << path << std::endl;
+
+    stats.bytes += size;
+    munmap(mapping, size);
+    return ok;
+}
+
+bool isSolid(const ArenaStats& arena, int column, int row) {
+    if (!arena.level) return false;
+    char tile = arena.level->rows[row][column];
+    return tile == '#' || tile == 'G';
+}
+
+// Tiles as '#', empty cells shaded by value relative to the busiest cell
+void printHeatmap(std::ostream& out, const ArenaStats& arena, const std::vector<std::uint64_t>& values) {
+    static const char ramp[] = " .:-=+*%@";
+    std::uint64_t peak = std::max<std::uint64_t>(1, *std::max_element(values.begin(), values.end()));
+    for (int row = 0; row < arena.rows; ++row) {
+        out << "  |";
+        for (int column = 0; column < arena.columns; ++column) {
+            std::uint64_t value = values[row * arena.columns + column];
+            if (isSolid(arena, column, row)) out << '#';
+            else if (value == 0) out << ' ';
+            else out << ramp[(value * 8 + peak - 1) / peak];
+        }
+        out << "|\n";
+    }
+}
+
+void printArena(std::ostream& out, const ArenaStats& arena, int top) {
+    out << "\n== " << arena.name << ": " << arena.matches << " matches, "
+        << std::fixed << std::setprecision(1) << arena.ticks / 60.0 / std::max<std::uint64_t>(1, arena.matches)
+        << " s average\n";
+    out << " Where players spend their time:\n";
+    printHeatmap(out, arena, arena.occupancy);
+    out << " Where players die:\n";
+    printHeatmap(out, arena, arena.deaths);
+
+    // Death traps: most deaths per minute spent in the cell
+    std::vector<int> cells;
+    for (int cell = 0; cell < static_cast<int>(arena.deaths.size()); ++cell) {
+        if (arena.deaths[cell] >= 3) cells.push_back(cell);
+    }
+    auto rate = [&](int cell) {
+        return arena.deaths[cell] / (std::max<std::uint64_t>(arena.occupancy[cell], 60) / 3600.0);
+    };
+    std::sort(cells.begin(), cells.end(), [&](int a, int b) { return rate(a) > rate(b); });
+    if (cells.size() > static_cast<std::size_t>(top)) cells.resize(top);
+
+    out << " Death traps (deaths per minute spent in the cell, at least 3 deaths):\n";
+    if (cells.empty()) out << "  none yet\n";
+    for (int cell : cells) {
+        int column = cell % arena.columns;
+        int row = cell / arena.columns;
+        out << "  cell " << std::setw(2) << column << "," << std::setw(2) << row
+            << "  (x " << std::setw(3) << int(column * TILE_SIZE) << ", y " << std::setw(3) << int(row * TILE_SIZE) << ")"
+            << "  deaths " << std::setw(5) << arena.deaths[cell]
+            << "  time " << std::setw(7) << std::setprecision(1) << arena.occupancy[cell] / 60.0 << " s"
+            << "  rate " << std::setprecision(2) << rate(cell) << "/min\n";
+    }
+}
+
+void printKillStats(std::ostream& out, const KillStats& stats, std::size_t fileCount) {
+    auto percent = [](std::uint64_t part, std::uint64_t whole) {
+        return whole ? 100.0 * part / whole : 0.0;
+    };
+    out << std::fixed << std::setprecision(1);
+    out << "Files: " << fileCount << ", " << stats.bytes << " bytes, "
+        << (stats.matches ? stats.bytes / stats.matches : 0) << " bytes per match\n";
+    out << "Matches: " << stats.matches << ", " << stats.ticks / 60.0 / std::max<std::uint64_t>(1, stats.matches)
+        << " s average\n";
+    for (int slot = 0; slot < stats.slots; ++slot) {
+        out << "  P" << (slot + 1) << " wins: " << percent(stats.winsBySlot[slot], stats.matches) << "%\n";
+    }
+    out << "  No winner: " << percent(stats.draws, stats.matches) << "%\n";
+    out << "Throws: " << stats.throws << ", bounces: " << stats.bounces << ", catches: " << stats.catches
+        << ", dashes: " << stats.dashes << "\n";
+    out << "Kills: " << stats.kills << " (" << percent(stats.kills, stats.throws) << "% of throws)\n";
+    static const char* causes[] = {"flying", "hanging", "returning"};
+    for (int cause = 0; cause < 3; ++cause) {
+        out << "  " << causes[cause] << ": " << percent(stats.killsByCause[cause], stats.kills) << "%\n";
+    }
+    out << "  after a bounce: " << percent(stats.bankShots, stats.kills) << "%\n";
+    out << "  throw to kill: " << (stats.kills ? stats.throwToKillTicks / 60.0 / stats.kills : 0.0) << " s average\n";
+    out << "  first kill: " << (stats.matchesWithKills ? stats.firstKillTicks / 60.0 / stats.matchesWithKills : 0.0)
+        << " s into the match on average\n";
+}
+
+void writeCsv(std::ostream& out, const std::map<std::string, ArenaStats>& arenas) {
+    out << "arena,column,row,solid,occupancy_seconds,deaths\n";
+    for (const auto& [name, arena] : arenas) {
+        for (int row = 0; row < arena.rows; ++row) {
+            for (int column = 0; column < arena.columns; ++column) {
+                int cell = row * arena.columns + column;
+                out << name << "," << column << "," << row << "," << isSolid(arena, column, row) << ","
+                    << arena.occupancy[cell] / 60.0 << "," << arena.deaths[cell] << "\n";
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 1;
+
+    std::map<std::string, ArenaStats> arenas;
+    KillStats stats;
+    for (const auto& path : options.paths) {
+        analyzeFile(path, arenas, stats);
+    }
+
+    printKillStats(std::cout, stats, options.paths.size());
+    for (const auto& [name, arena] : arenas) {
+        printArena(std::cout, arena, options.top);
+    }
+
+    if (!options.csvPath.empty()) {
+        std::ofstream csv(options.csvPath);
+        if (!csv) {
+            std::cerr << "Error: Could not write " << options.csvPath << std::endl;
+            return 1;
+        }
+        writeCsv(csv, arenas);
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+#ifndef TELEMETRY_FORMAT_HPP
+#define TELEMETRY_FORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// --- Telemetry file layout ---
+// A file is the 4 byte magic "DTEL", one version byte, then match blocks
+// back to back until the end of the file. A block is the magic "MTCH", its
+// payload size as a 4 byte little endian integer, then the payload.
+//
+// Every number in a payload is a LEB128 varint; signed values are zigzag
+// encoded first. The payload starts with the match header:
+//   matchIndex, seed, levelName (length + bytes), ticks, playerCount,
+//   winnerId + 1 (0 = nobody), eventCount
+// followed by the columns, each stored as its byte length plus its bytes so
+// a reader can skip the ones it doesn't need:
+//   per player slot, one row per tick:
+//     x, y      position in quarter pixels, delta from the previous tick
+//     state     TelemetryPlayerState, delta from the previous tick
+//   events (throws, bounces, catches, kills, dashes), one row per event:
+//     type, tick (delta), actorId, targetId + 1,
+//     x, y      quarter pixels, delta from the previous event
+//     vx, vy    sixteenths of a pixel per tick
+//     cause     Boomerang::State for kills
+// Deltas make most values a single byte: players sit still or move a few
+// pixels per tick, and states rarely change.
+
+constexpr char TELEMETRY_FILE_MAGIC[4] = {'D', 'T', 'E', 'L'};
+constexpr char TELEMETRY_BLOCK_MAGIC[4] = {'M', 'T', 'C', 'H'};
+constexpr std::uint8_t TELEMETRY_VERSION = 1;
+
+// Most player slots a match block can hold
+constexpr int TELEMETRY_MAX_PLAYERS = 16;
+
+constexpr float TELEMETRY_POSITION_SCALE = 4.f;
+constexpr float TELEMETRY_VELOCITY_SCALE = 16.f;
+
+enum class TelemetryPlayerState : std::uint8_t {
+    Absent,     // Not in the arena (never joined, or removed after dying)
+    Normal,
+    Dashing,
+    Stunned,
+    Dying
+};
+
+enum class TelemetryEventColumn {
+    Type, Tick, Actor, Target, X, Y, VX, VY, Cause,
+    Count
+};
+
+inline void putVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+inline void putZigzag(std::vector<std::uint8_t>& out, std::int64_t value) {
+    putVarint(out, (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+}
+
+// Reads varints from a byte range. Running off the end sets ok to false and
+// returns zeros from then on.
+struct TelemetryReader {
+    const std::uint8_t* position;
+    const std::uint8_t* end;
+    bool ok = true;
+
+    TelemetryReader(const std::uint8_t* begin, const std::uint8_t* finish) : position(begin), end(finish) {}
+
+    std::uint64_t varint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (position >= end) { ok = false; return 0; }
+            std::uint8_t byte = *position++;
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        ok = false;
+        return 0;
+    }
+
+    std::int64_t zigzag() {
+        std::uint64_t value = varint();
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+
+    // Splits off the next length-prefixed column
+    TelemetryReader column() {
+        std::uint64_t length = varint();
+        if (!ok || length > static_cast<std::uint64_t>(end - position)) {
+            ok = false;
+            return TelemetryReader(end, end);
+        }
+        TelemetryReader sub(position, position + length);
+        position += length;
+        return sub;
+    }
+};
+
+#endif
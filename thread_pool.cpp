@@ -0,0 +1,195 @@
+#include "thread_pool.hpp"
+#include <algorithm>
+
+namespace {
+    // Which pool/worker the current thread belongs to, so submit() from inside
+    // a task can push to the local deque
+    thread_local const ThreadPool* t_pool = nullptr;
+    thread_local unsigned int t_workerIndex = 0;
+}
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+    : m_pending(0)
+    , m_nextWorker(0)
+    , m_stopping(false)
+{
+    if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+    if (threadCount == 0) threadCount = 1;
+
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        m_threads.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_wakeCondition.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    unsigned int index = (t_pool == this)
+        ? t_workerIndex
+        : m_nextWorker.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+
+    m_pending.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(m_workers[index]->mutex);
+        m_workers[index]->tasks.push_back(std::move(task));
+    }
+    {
+        // Taking the sleep mutex orders this wakeup after a worker's last
+        // empty check, so the notification can't be lost
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_wakeCondition.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(m_sleepMutex);
+    m_idleCondition.wait(lock, [this] { return m_pending.load(std::memory_order_acquire) == 0; });
+}
+
+void ThreadPool::parallelFor(std::size_t count, std::size_t grain,
+                             const std::function<void(std::size_t begin, std::size_t end)>& body) {
+    if (grain == 0) grain = 1;
+    const std::size_t chunks = (count + grain - 1) / grain;
+
+    // Claim a free batch; with one chunk, or every batch in use, just run it here
+    Batch* batch = nullptr;
+    for (std::size_t i = 0; chunks > 1 && !batch && i < m_batches.size(); ++i) {
+        int expected = 0;
+        if (m_batches[i].refs.compare_exchange_strong(expected, 1, std::memory_order_acquire)) batch = &m_batches[i];
+    }
+    if (!batch) {
+        if (count) body(0, count);
+        return;
+    }
+
+    batch->next.store(0, std::memory_order_relaxed);
+    batch->done.store(0, std::memory_order_relaxed);
+    batch->body = &body;
+    batch->count = count;
+    batch->grain = grain;
+    batch->chunks = chunks;
+
+    // Helpers that only get to run after this call has returned find no
+    // chunk left; they touch nothing but the batch, which they keep alive
+    std::size_t helpers = std::min<std::size_t>(chunks - 1, m_workers.size());
+    batch->refs.fetch_add(static_cast<int>(helpers), std::memory_order_relaxed);
+    for (std::size_t i = 0; i < helpers; ++i) {
+        submit([batch] {
+            runChunks(*batch);
+            batch->refs.fetch_sub(1, std::memory_order_release);
+        });
+    }
+    runChunks(*batch);
+
+    // Only chunks already claimed by a worker are left; they are short
+    while (batch->done.load(std::memory_order_acquire) < chunks) {
+        std::this_thread::yield();
+    }
+    batch->refs.fetch_sub(1, std::memory_order_release);
+}
+
+void ThreadPool::runChunks(Batch& batch) {
+    for (std::size_t chunk; (chunk = batch.next.fetch_add(1, std::memory_order_relaxed)) < batch.chunks;) {
+        std::size_t begin = chunk * batch.grain;
+        (*batch.body)(begin, std::min(begin + batch.grain, batch.count));
+        batch.done.fetch_add(1, std::memory_order_release);
+    }
+}
+
+unsigned int ThreadPool::getThreadCount() const {
+    return m_threads.size();
+}
+
+void ThreadPool::TaskRing::push_back(std::function<void()>&& task) {
+    if (count == slots.size()) {
+        // Full: double, unrolling the ring to start at 0
+        std::vector<std::function<void()>> grown(slots.empty() ? 16 : slots.size() * 2);
+        for (std::size_t i = 0; i < count; ++i) {
+            grown[i] = std::move(slots[(head + i) & (slots.size() - 1)]);
+        }
+        slots = std::move(grown);
+        head = 0;
+    }
+    slots[(head + count) & (slots.size() - 1)] = std::move(task);
+    ++count;
+}
+
+std::function<void()> ThreadPool::TaskRing::pop_back() {
+    --count;
+    return std::move(slots[(head + count) & (slots.size() - 1)]);
+}
+
+std::function<void()> ThreadPool::TaskRing::pop_front() {
+    std::function<void()> task = std::move(slots[head]);
+    head = (head + 1) & (slots.size() - 1);
+    --count;
+    return task;
+}
+
+bool ThreadPool::popTask(unsigned int index, std::function<void()>& task) {
+    // Own deque: newest first, it is most likely still in cache
+    {
+        Worker& own = *m_workers[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // Steal the oldest task from the other workers
+    for (std::size_t offset = 1; offset < m_workers.size(); ++offset) {
+        Worker& victim = *m_workers[(index + offset) % m_workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(unsigned int index) {
+    t_pool = this;
+    t_workerIndex = index;
+
+    std::function<void()> task;
+    while (true) {
+        if (popTask(index, task)) {
+            task();
+            task = nullptr;
+            if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lock(m_sleepMutex);
+                m_idleCondition.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        if (m_stopping) return;
+        // Nothing to pop: sleep until new work is submitted. Re-check the
+        // deques under the sleep mutex so a submit can't slip in between.
+        m_wakeCondition.wait(lock, [this] {
+            if (m_stopping) return true;
+            for (const auto& worker : m_workers) {
+                std::lock_guard<std::mutex> workerLock(worker->mutex);
+                if (!worker->tasks.empty()) return true;
+            }
+            return false;
+        });
+        if (m_stopping) return;
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads, each with its own task deque. A worker pops
+// its newest task first and, when it runs dry, steals the oldest task from
+// another worker, so uneven jobs (long vs short matches) still keep every
+// core busy without a single shared queue becoming the bottleneck.
+class ThreadPool {
+public:
+    // 0 = one worker per hardware thread
+    explicit ThreadPool(unsigned int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queues a task. Called from a worker, the task goes to that worker's own
+    // deque; otherwise tasks are dealt round-robin across workers.
+    void submit(std::function<void()> task);
+
+    // Blocks until every submitted task has finished
+    void wait();
+
+    // Runs body(begin, end) over [0, count) in chunks of at least grain
+    // items and returns once every chunk is done. The calling thread works
+    // through chunks alongside the workers, so this is safe to call from
+    // inside a task and never waits on a worker that is still asleep. The
+    // chunks may run in any order; a caller that needs a fixed result
+    // writes per-item output and merges it in item order afterwards.
+    void parallelFor(std::size_t count, std::size_t grain,
+                     const std::function<void(std::size_t begin, std::size_t end)>& body);
+
+    unsigned int getThreadCount() const;
+
+private:
+    // A worker's tasks: the owner pushes and pops at the back, thieves take
+    // from the front. Unlike std::deque it keeps its storage when emptied,
+    // so once a pool has been through its busiest moment, queueing a task
+    // never allocates.
+    struct TaskRing {
+        std::vector<std::function<void()>> slots;   // Size is 0 or a power of two
+        std::size_t head = 0;
+        std::size_t count = 0;
+
+        bool empty() const { return count == 0; }
+        void push_back(std::function<void()>&& task);
+        std::function<void()> pop_back();
+        std::function<void()> pop_front();
+    };
+
+    struct Worker {
+        TaskRing tasks;
+        std::mutex mutex;
+    };
+
+    // One parallelFor() in progress. Held by the caller and each helper task
+    // it queued; reused once refs drops back to 0.
+    struct Batch {
+        std::atomic<int> refs{0};
+        std::atomic<std::size_t> next{0};
+        std::atomic<std::size_t> done{0};
+        const std::function<void(std::size_t, std::size_t)>* body = nullptr;
+        std::size_t count = 0;
+        std::size_t grain = 0;
+        std::size_t chunks = 0;
+    };
+    static constexpr int MaxBatches = 16;   // parallelFor calls running at once, e.g. nested ones
+
+    void workerLoop(unsigned int index);
+    bool popTask(unsigned int index, std::function<void()>& task);
+    static void runChunks(Batch& batch);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+    std::array<Batch, MaxBatches> m_batches;
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeCondition;     // Signalled when work arrives
+    std::condition_variable m_idleCondition;     // Signalled when m_pending drops to 0
+    std::atomic<std::size_t> m_pending;          // Submitted but not yet finished
+    std::atomic<unsigned int> m_nextWorker;
+    bool m_stopping;
+};
+
+#endif
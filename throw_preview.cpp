@@ -0,0 +1,66 @@
+#include "throw_preview.hpp"
+#include "boomerang.hpp"
+#include <algorithm>
+#include <cmath>
+
+ThrowPreview::ThrowPreview()
+    : m_vertices(sf::PrimitiveType::Lines)
+    , m_valid(false)
+{
+}
+
+void ThrowPreview::invalidate() {
+    m_valid = false;
+}
+
+void ThrowPreview::update(sf::Vector2f origin, sf::Vector2f throwVelocity, const std::vector<sf::RectangleShape>& tiles,
+                          const Tuning& tuning, sf::Color color) {
+    // Stick noise moves the aim a tiny bit every frame; ignore changes that
+    // can't visibly move the path
+    sf::Vector2f velocityDelta = throwVelocity - m_velocity;
+    sf::Vector2f originDelta = origin - m_origin;
+    if (m_valid &&
+        std::abs(velocityDelta.x) < 0.01f && std::abs(velocityDelta.y) < 0.01f &&
+        std::abs(originDelta.x) < 0.5f && std::abs(originDelta.y) < 0.5f) {
+        return;
+    }
+    m_velocity = throwVelocity;
+    m_origin = origin;
+    m_valid = true;
+
+    Boomerang::predictPath(origin, throwVelocity, origin, tiles, Boomerang::collisionRadius(tuning), tuning,
+                           PreviewTicks, m_path);
+
+    // Turn the path into a dotted line, fading out towards the end
+    const float dashLength = 6.f;
+    const float period = 14.f;
+    float travelled = 0.f;
+    m_vertices.clear();
+    for (std::size_t i = 1; i < m_path.size(); ++i) {
+        sf::Vector2f from = m_path[i - 1];
+        sf::Vector2f segment = m_path[i] - from;
+        float segmentLength = std::sqrt(segment.x * segment.x + segment.y * segment.y);
+        if (segmentLength <= 0.f) continue;
+
+        sf::Color fadedColor = color;
+        fadedColor.a = static_cast<std::uint8_t>(color.a * (1.f - float(i) / m_path.size()));
+
+        float along = 0.f;
+        while (along < segmentLength) {
+            float phase = std::fmod(travelled + along, period);
+            if (phase < dashLength) {
+                float end = std::min(segmentLength, along + (dashLength - phase));
+                m_vertices.append({from + segment * (along / segmentLength), fadedColor});
+                m_vertices.append({from + segment * (end / segmentLength), fadedColor});
+                along = end;
+            } else {
+                along += period - phase;
+            }
+        }
+        travelled += segmentLength;
+    }
+}
+
+void ThrowPreview::draw(sf::RenderTarget& target) const {
+    if (m_valid) target.draw(m_vertices);
+}
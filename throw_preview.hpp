@@ -0,0 +1,32 @@
+#ifndef THROW_PREVIEW_HPP
+#define THROW_PREVIEW_HPP
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include "tuning.hpp"
+
+// Dotted line showing where a boomerang would fly if it were thrown now.
+// The path comes from Boomerang::predictPath, so it uses the real collision
+// code. It is cached: calling update() every frame only re-simulates when
+// the aim or the thrower's position has changed.
+class ThrowPreview {
+public:
+    // How far ahead the preview looks (2 seconds)
+    static constexpr int PreviewTicks = 120;
+
+    ThrowPreview();
+
+    void update(sf::Vector2f origin, sf::Vector2f throwVelocity, const std::vector<sf::RectangleShape>& tiles,
+                const Tuning& tuning, sf::Color color);
+    void invalidate();
+    void draw(sf::RenderTarget& target) const;
+
+private:
+    std::vector<sf::Vector2f> m_path;
+    sf::VertexArray m_vertices;
+    sf::Vector2f m_origin;
+    sf::Vector2f m_velocity;
+    bool m_valid;
+};
+
+#endif
@@ -0,0 +1,260 @@
+#include "training_env.hpp"
+#include "dino_env.h"
+#include "level.hpp"
+#include "match_seed.hpp"
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+// Matches handed to a worker at a time; one tick of one match is only a few
+// microseconds, less than waking a worker costs
+static constexpr std::size_t EnvsPerJob = 4;
+
+static_assert(TrainingEnv::PlayerFeatures == DINO_ENV_PLAYER_FEATURES, "dino_env.h is out of date");
+static_assert(TrainingEnv::BoomerangFeatures == DINO_ENV_BOOMERANG_FEATURES, "dino_env.h is out of date");
+static_assert(TrainingEnv::getTileBytes() == DINO_ENV_TILE_BYTES, "dino_env.h is out of date");
+static_assert(World::MaxPlayers == DINO_ENV_MAX_PLAYERS, "dino_env.h is out of date");
+static_assert(PhysicsStep::MaxSubsteps == DINO_ENV_MAX_SUBSTEPS, "dino_env.h is out of date");
+
+// The buffers are sized by the caller from config, so nothing may be
+// quietly adjusted: a config the environment would change is refused
+static const TrainingEnvConfig& validate(const TrainingEnvConfig& config) {
+    auto check = [](const char* name, int value, int low, int high) {
+        if (value < low || value > high) {
+            const std::string range = high == std::numeric_limits<int>::max()
+                ? "at least " + std::to_string(low)
+                : std::to_string(low) + " to " + std::to_string(high);
+            throw std::invalid_argument("Bad " + std::string(name) + " " + std::to_string(value) + " (use " + range + ")");
+        }
+    };
+    const int levels = static_cast<int>(builtinLevels().size());
+    check("envs", config.envs, 1, std::numeric_limits<int>::max());
+    check("players", config.players, 2, World::MaxPlayers);
+    check("bots", config.bots, 0, config.players);
+    check("level", config.level, -1, levels - 1);
+    check("max ticks", config.maxTicks, 1, std::numeric_limits<int>::max());
+    check("physics substeps", config.tuning.physicsSubsteps, 1, PhysicsStep::MaxSubsteps);
+    return config;
+}
+
+TrainingEnv::TrainingEnv(const TrainingEnvConfig& config, const TrainingEnvBuffers& buffers)
+    : m_config(validate(config))
+    , m_buffers(buffers)
+    , m_pool(config.threads)
+{
+    m_envs.resize(m_config.envs);
+    for (auto& env : m_envs) {
+        env.bots.assign(m_config.bots, Bot(0));
+        env.inputs.resize(m_config.players);
+    }
+
+    // Env k starts from seed k, so step() works without a reset() first
+    std::vector<std::uint32_t> seeds(m_config.envs);
+    for (int k = 0; k < m_config.envs; ++k) seeds[k] = k;
+    reset(seeds.data());
+}
+
+void TrainingEnv::reset(const std::uint32_t* seeds) {
+    for (int k = 0; k < m_config.envs; ++k) {
+        m_envs[k].seed = seeds[k];
+        m_envs[k].episode = 0;
+    }
+    std::fill(m_buffers.rewards, m_buffers.rewards + m_envs.size() * m_config.players, 0.f);
+    std::fill(m_buffers.dones, m_buffers.dones + m_envs.size(), static_cast<std::uint8_t>(Running));
+
+    m_pool.parallelFor(m_envs.size(), EnvsPerJob, [this](std::size_t begin, std::size_t end) {
+        for (std::size_t k = begin; k < end; ++k) startEpisode(static_cast<int>(k));
+    });
+}
+
+void TrainingEnv::step(const PlayerInput* actions) {
+    // Each env only touches its own world and its own slice of the buffers
+    m_pool.parallelFor(m_envs.size(), EnvsPerJob, [this, actions](std::size_t begin, std::size_t end) {
+        for (std::size_t k = begin; k < end; ++k) stepEnv(static_cast<int>(k), actions);
+    });
+}
+
+void TrainingEnv::startEpisode(int index) {
+    Env& env = m_envs[index];
+    const auto& levels = builtinLevels();
+    std::uint32_t seed = env.episode == 0 ? env.seed : mixSeed(env.seed, env.episode);
+    ++env.episode;
+
+    // Another match on the same arena reuses the world, as a rematch in the
+    // game does, so back-to-back episodes allocate nothing
+    int levelIndex = m_config.level >= 0 ? m_config.level : static_cast<int>(seed % levels.size());
+    if (env.world && env.levelIndex == levelIndex) {
+        env.world->rematch();
+    } else {
+        env.world = std::make_unique<World>(levels[levelIndex], m_config.tuning);
+        env.levelIndex = levelIndex;
+        for (int i = 0; i < m_config.players; ++i) {
+            env.world->addPlayer(-1);
+        }
+
+        std::uint8_t* tiles = m_buffers.tiles + index * getTileBytes();
+        const TileGrid& grid = env.world->getGrid();
+        for (int row = 0; row < ARENA_ROWS; ++row) {
+            for (int column = 0; column < ARENA_COLUMNS; ++column) {
+                tiles[row * ARENA_COLUMNS + column] = grid.isSolid(column, row) ? 1 : 0;
+            }
+        }
+    }
+
+    int firstBot = m_config.players - m_config.bots;
+    for (int i = 0; i < m_config.bots; ++i) {
+        env.bots[i] = Bot(mixSeed(seed, firstBot + i + 1));
+    }
+    writeObservation(index);
+}
+
+void TrainingEnv::stepEnv(int index, const PlayerInput* actions) {
+    Env& env = m_envs[index];
+    World& world = *env.world;
+
+    int firstBot = m_config.players - m_config.bots;
+    std::copy(actions + index * m_config.players, actions + index * m_config.players + firstBot, env.inputs.begin());
+    for (int i = 0; i < m_config.bots; ++i) {
+        env.inputs[firstBot + i] = env.bots[i].think(world, firstBot + i);
+    }
+    world.step(env.inputs);
+
+    float* rewards = m_buffers.rewards + index * m_config.players;
+    std::fill(rewards, rewards + m_config.players, 0.f);
+    for (const auto& event : world.getStepEvents()) {
+        if (event.type != GameEvent::Type::Kill) continue;
+        if (event.actorId >= 0 && event.actorId < m_config.players) rewards[event.actorId] += m_config.killReward;
+        if (event.targetId >= 0 && event.targetId < m_config.players) rewards[event.targetId] += m_config.deathReward;
+    }
+
+    std::uint8_t done = Running;
+    if (world.getAliveCount() <= 1) done = Decided;
+    else if (world.getTick() >= m_config.maxTicks) done = TimedOut;
+    m_buffers.dones[index] = done;
+
+    if (done != Running) {
+        startEpisode(index);
+    } else {
+        writeObservation(index);
+    }
+}
+
+void TrainingEnv::writeObservation(int index) {
+    const World& world = *m_envs[index].world;
+    const float arenaWidth = ARENA_COLUMNS * TILE_SIZE;
+    const float arenaHeight = ARENA_ROWS * TILE_SIZE;
+    float* out = m_buffers.entities + index * getEntityFloats();
+    float* boomerangOut = out + m_config.players * PlayerFeatures;
+    std::fill(out, out + getEntityFloats(), 0.f);
+
+    // Players that have left the arena after dying stay all zeros
+    for (int id = 0; id < m_config.players; ++id) {
+        const Player* player = world.findPlayer(id);
+        if (!player) continue;
+        float* features = out + id * PlayerFeatures;
+        features[0] = player->isAlive() ? 1.f : 0.f;
+        features[1] = player->getPosition().x / arenaWidth;
+        features[2] = player->getPosition().y / arenaHeight;
+        features[3] = player->getVelocity().x / TILE_SIZE;
+        features[4] = player->getVelocity().y / TILE_SIZE;
+        features[5] = player->isGrounded() ? 1.f : 0.f;
+        features[6] = player->getState() == Player::State::Dashing ? 1.f : 0.f;
+        features[7] = player->getState() == Player::State::Stunned ? 1.f : 0.f;
+        features[8] = player->isChargingThrow() ? 1.f : 0.f;
+        features[9] = player->canDash() ? 1.f : 0.f;
+        features[10] = player->isFacingRight() ? 1.f : 0.f;
+    }
+
+    // A player has at most one boomerang out, kept in the owner's slot
+    for (const auto& boomerang : world.getBoomerangs()) {
+        int owner = boomerang.getOwnerId();
+        if (owner < 0 || owner >= m_config.players) continue;
+        out[owner * PlayerFeatures + 11] = 1.f;
+        float* features = boomerangOut + owner * BoomerangFeatures;
+        features[0] = 1.f;
+        features[1] = boomerang.getPosition().x / arenaWidth;
+        features[2] = boomerang.getPosition().y / arenaHeight;
+        features[3] = boomerang.getVelocity().x / TILE_SIZE;
+        features[4] = boomerang.getVelocity().y / TILE_SIZE;
+        features[5] = boomerang.getState() == Boomerang::State::FlyingOut ? 1.f : 0.f;
+        features[6] = boomerang.getState() == Boomerang::State::Hanging ? 1.f : 0.f;
+        features[7] = boomerang.getState() == Boomerang::State::Returning ? 1.f : 0.f;
+    }
+}
+
+int TrainingEnv::getEnvCount() const { return m_config.envs; }
+int TrainingEnv::getPlayerCount() const { return m_config.players; }
+std::size_t TrainingEnv::getEntityFloats() const {
+    return m_config.players * (PlayerFeatures + BoomerangFeatures);
+}
+
+// --- C API ---
+
+struct DinoEnv {
+    std::unique_ptr<TrainingEnv> env;
+    std::vector<PlayerInput> inputs;    // dino_env_step's actions, converted
+};
+
+void dino_env_default_config(DinoEnvConfig* config) {
+    TrainingEnvConfig defaults;
+    config->envs = defaults.envs;
+    config->players = defaults.players;
+    config->bots = defaults.bots;
+    config->level = defaults.level;
+    config->max_ticks = defaults.maxTicks;
+    config->threads = defaults.threads;
+    config->physics_substeps = defaults.tuning.physicsSubsteps;
+    config->kill_reward = defaults.killReward;
+    config->death_reward = defaults.deathReward;
+}
+
+DinoEnv* dino_env_create(const DinoEnvConfig* config, const DinoEnvBuffers* buffers) {
+    TrainingEnvConfig settings;
+    settings.envs = config->envs;
+    settings.players = config->players;
+    settings.bots = config->bots;
+    settings.level = config->level;
+    settings.maxTicks = config->max_ticks;
+    settings.threads = config->threads;
+    settings.tuning.physicsSubsteps = config->physics_substeps;
+    settings.killReward = config->kill_reward;
+    settings.deathReward = config->death_reward;
+
+    // No exceptions across the C boundary
+    try {
+        auto handle = std::make_unique<DinoEnv>();
+        handle->env = std::make_unique<TrainingEnv>(
+            settings, TrainingEnvBuffers{buffers->entities, buffers->tiles, buffers->rewards, buffers->dones});
+        handle->inputs.resize(static_cast<std::size_t>(handle->env->getEnvCount()) * handle->env->getPlayerCount());
+        return handle.release();
+    } catch (const std::exception& error) {
+        std::cerr << "Error: Could not create the training environment: " << error.what() << std::endl;
+        return nullptr;
+    }
+}
+
+void dino_env_destroy(DinoEnv* env) { delete env; }
+
+int dino_env_count(const DinoEnv* env) { return env->env->getEnvCount(); }
+int dino_env_players(const DinoEnv* env) { return env->env->getPlayerCount(); }
+size_t dino_env_entity_floats(const DinoEnv* env) { return env->env->getEntityFloats(); }
+size_t dino_env_tile_bytes(void) { return TrainingEnv::getTileBytes(); }
+int dino_env_level_count(void) { return static_cast<int>(builtinLevels().size()); }
+
+void dino_env_reset(DinoEnv* env, const uint32_t* seeds) { env->env->reset(seeds); }
+
+void dino_env_step(DinoEnv* env, const DinoEnvAction* actions) {
+    for (std::size_t i = 0; i < env->inputs.size(); ++i) {
+        PlayerInput& input = env->inputs[i];
+        input.left = actions[i].left != 0;
+        input.right = actions[i].right != 0;
+        input.jump = actions[i].jump != 0;
+        input.dash = actions[i].dash != 0;
+        input.throwPressed = actions[i].throw_pressed != 0;
+        input.aim = {actions[i].aim_x, actions[i].aim_y};
+    }
+    env->env->step(env->inputs.data());
+}
@@ -0,0 +1,109 @@
+#ifndef TRAINING_ENV_HPP
+#define TRAINING_ENV_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "world.hpp"
+#include "bot.hpp"
+#include "input.hpp"
+#include "tuning.hpp"
+#include "thread_pool.hpp"
+
+struct TrainingEnvConfig {
+    int envs = 64;              // Matches played side by side, at least 1
+    int players = 2;            // Dinos per match, 2 to World::MaxPlayers
+    int bots = 0;               // The last this many slots are played by Bot; their actions are ignored
+    int level = -1;             // Built-in arena, or -1 to pick one from each episode's seed
+    int maxTicks = 60 * 90;     // Ticks before an episode is cut off, at least 1
+    unsigned int threads = 0;   // 0 = one per hardware thread
+    float killReward = 1.f;
+    float deathReward = -1.f;
+    Tuning tuning;
+};
+
+// Caller-owned arrays the environment writes into, so observations go
+// straight to wherever the trainer wants them (e.g. numpy arrays) without a
+// copy on the way out. Sizes follow from the config alone; every array is
+// env-major.
+struct TrainingEnvBuffers {
+    float* entities;        // envs x players x (PlayerFeatures + BoomerangFeatures)
+    std::uint8_t* tiles;    // envs x getTileBytes(), 1 for a solid cell, row by row
+    float* rewards;         // envs x players
+    std::uint8_t* dones;    // envs, a Done value
+};
+
+// K independent matches stepped in lockstep for training AI opponents
+// offline. Each step() takes one PlayerInput per player per match, the
+// same controls a controller or Bot produces, advances every match by a
+// 60 Hz tick on a thread pool, and writes observations, rewards and dones
+// into the buffers given at construction. Nothing is drawn; matches are
+// the same World::step a real game runs.
+//
+// Observations are one fixed-size vector per match: a PlayerFeatures block
+// per player slot and then a BoomerangFeatures block per slot for that
+// player's boomerang, with positions in arena widths/heights and velocities
+// in tiles per tick. The tile grid is only written when an env's match
+// moves to another arena, not every step.
+//
+// A match that ends starts over by itself, from a seed derived from the
+// one it was reset() with: its done is set for that step, its rewards are
+// the final step's, and its observation and tiles are already the new
+// match's first.
+class TrainingEnv {
+public:
+    enum Done : std::uint8_t {
+        Running = 0,
+        Decided = 1,    // One dino (or none) left standing
+        TimedOut = 2    // Cut off at maxTicks; the match wasn't over
+    };
+
+    // Per player: alive, x, y, vx, vy, grounded, dashing, stunned, charging
+    // a throw, can dash, facing right, has a boomerang out
+    static constexpr std::size_t PlayerFeatures = 12;
+    // Per boomerang: in flight, x, y, vx, vy, flying out, hanging, returning
+    static constexpr std::size_t BoomerangFeatures = 8;
+
+    // Throws std::invalid_argument, before touching the buffers, if any of
+    // config is out of range; it is never adjusted, since the caller sized
+    // the buffers from it
+    TrainingEnv(const TrainingEnvConfig& config, const TrainingEnvBuffers& buffers);
+
+    TrainingEnv(const TrainingEnv&) = delete;
+    TrainingEnv& operator=(const TrainingEnv&) = delete;
+
+    // Starts a new match in every env, env k from seeds[k], and writes the
+    // first observations and tiles. Rewards and dones are zeroed.
+    void reset(const std::uint32_t* seeds);
+
+    // Advances every match by one tick. actions holds envs x players
+    // inputs, env-major.
+    void step(const PlayerInput* actions);
+
+    int getEnvCount() const;
+    int getPlayerCount() const;
+    std::size_t getEntityFloats() const;    // Observation floats per env
+    static constexpr std::size_t getTileBytes() { return ARENA_ROWS * ARENA_COLUMNS; }
+
+private:
+    struct Env {
+        std::unique_ptr<World> world;
+        int levelIndex = -1;
+        std::uint32_t seed = 0;             // What reset() gave this env
+        std::uint32_t episode = 0;          // Matches since then
+        std::vector<Bot> bots;
+        std::vector<PlayerInput> inputs;
+    };
+
+    void startEpisode(int index);
+    void stepEnv(int index, const PlayerInput* actions);
+    void writeObservation(int index);
+
+    TrainingEnvConfig m_config;
+    TrainingEnvBuffers m_buffers;
+    std::vector<Env> m_envs;
+    ThreadPool m_pool;
+};
+
+#endif
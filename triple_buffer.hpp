@@ -0,0 +1,49 @@
+#ifndef TRIPLE_BUFFER_HPP
+#define TRIPLE_BUFFER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Hands the latest value from one producer thread to one consumer thread
+// without either of them ever waiting. The producer fills writeBuffer() and
+// publish()es it; the consumer calls acquire() and reads readBuffer(). Values
+// the consumer was too slow to see are simply replaced by newer ones.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : m_back(0), m_middle(1), m_front(2) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Producer side
+    T& writeBuffer() { return m_buffers[m_back]; }
+
+    void publish() {
+        // Swap the freshly written buffer into the middle and mark it new
+        std::uint8_t previous = m_middle.exchange(m_back | NewFlag, std::memory_order_acq_rel);
+        m_back = previous & IndexMask;
+    }
+
+    // Consumer side. Returns true if a newer value was picked up.
+    bool acquire() {
+        if (!(m_middle.load(std::memory_order_relaxed) & NewFlag)) return false;
+        std::uint8_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & IndexMask;
+        return true;
+    }
+
+    const T& readBuffer() const { return m_buffers[m_front]; }
+
+private:
+    static constexpr std::uint8_t IndexMask = 0x3;
+    static constexpr std::uint8_t NewFlag = 0x4;
+
+    std::array<T, 3> m_buffers;
+    std::uint8_t m_back;                    // Owned by the producer
+    std::atomic<std::uint8_t> m_middle;     // Shared: index plus NewFlag
+    std::uint8_t m_front;                   // Owned by the consumer
+};
+
+#endif
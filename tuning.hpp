@@ -0,0 +1,58 @@
+#ifndef TUNING_HPP
+#define TUNING_HPP
+
+#include <algorithm>
+#include <cmath>
+
+// Physics constants shared by Player and Boomerang.
+// Everything is expressed per 60 Hz tick so a match plays out the same
+// whether it is rendered in a window or simulated headless.
+struct Tuning {
+    // Player movement
+    float moveSpeed = 5.f;
+    float jumpVelocity = -10.f;
+    float gravity = 0.5f;
+    float maxFallSpeed = 15.f;
+    float dashSpeed = 25.f;
+    int dashDurationTicks = 9;      // 0.15 seconds
+    int dashCooldownTicks = 60;     // 1 second
+
+    // Boomerang flight
+    float throwSpeed = 30.f;
+    float damping = 0.98f;          // Velocity multiplier per tick while flying out
+    float bounceLoss = 0.85f;       // Velocity multiplier on each wall bounce
+    float hangSpeed = 1.f;          // Below this speed the boomerang starts hanging
+    int hangTicks = 3;              // 0.05 seconds
+    float returnSpeed = 5.f;
+    float catchDistance = 20.f;
+    float boomerangSize = 60.f;     // Hitbox side: the 24 px sprite drawn at 2.5x
+
+    // Motion and collision run this many times per tick: 1, 2, 4 or 8 for
+    // 60, 120, 240 or 480 Hz. Input, timers and rendering stay at 60 Hz.
+    int physicsSubsteps = 1;
+};
+
+// The per-tick constants above rescaled to one physics substep. Velocities
+// keep their per-tick units everywhere; a substep only covers part of a
+// tick, so the rates that compound (gravity, damping, hang time) are
+// converted here and a single substep reproduces the plain 60 Hz step.
+struct PhysicsStep {
+    static constexpr int MaxSubsteps = 8;
+
+    int substeps;
+    float fraction;         // Share of a tick covered by one substep
+    float gravity;          // Fall speed gained per substep
+    float damping;          // Boomerang velocity multiplier per substep
+    int hangSubsteps;
+
+    explicit PhysicsStep(const Tuning& tuning)
+        : substeps(std::clamp(tuning.physicsSubsteps, 1, MaxSubsteps))
+        , fraction(1.f / substeps)
+        , gravity(tuning.gravity * fraction)
+        , damping(substeps == 1 ? tuning.damping : std::pow(tuning.damping, fraction))
+        , hangSubsteps(tuning.hangTicks * substeps)
+    {
+    }
+};
+
+#endif
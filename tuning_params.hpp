@@ -0,0 +1,54 @@
+#ifndef TUNING_PARAMS_HPP
+#define TUNING_PARAMS_HPP
+
+#include <string>
+#include "tuning.hpp"
+
+// Tunables that can be set from the command line, by flag name. dino_batch
+// takes them as --<name> VALUE and in --variant overrides; dino_export
+// takes the same flags so a batch match can be replayed with the tuning it
+// was played with.
+struct TuningFloatParam { const char* name; float Tuning::*member; };
+struct TuningIntParam { const char* name; int Tuning::*member; };
+
+inline constexpr TuningFloatParam TUNING_FLOAT_PARAMS[] = {
+    {"move-speed", &Tuning::moveSpeed},
+    {"jump-velocity", &Tuning::jumpVelocity},
+    {"gravity", &Tuning::gravity},
+    {"max-fall-speed", &Tuning::maxFallSpeed},
+    {"dash-speed", &Tuning::dashSpeed},
+    {"throw-speed", &Tuning::throwSpeed},
+    {"damping", &Tuning::damping},
+    {"bounce-loss", &Tuning::bounceLoss},
+    {"hang-speed", &Tuning::hangSpeed},
+    {"return-speed", &Tuning::returnSpeed},
+    {"catch-distance", &Tuning::catchDistance},
+    {"boomerang-size", &Tuning::boomerangSize},
+};
+
+inline constexpr TuningIntParam TUNING_INT_PARAMS[] = {
+    {"dash-duration", &Tuning::dashDurationTicks},
+    {"dash-cooldown", &Tuning::dashCooldownTicks},
+    {"hang-ticks", &Tuning::hangTicks},
+    {"physics-substeps", &Tuning::physicsSubsteps},
+};
+
+// Returns false when name isn't a tunable. Throws std::invalid_argument or
+// std::out_of_range when value isn't a number.
+inline bool setTuningParam(Tuning& tuning, const std::string& name, const std::string& value) {
+    for (const auto& param : TUNING_FLOAT_PARAMS) {
+        if (name == param.name) {
+            tuning.*param.member = std::stof(value);
+            return true;
+        }
+    }
+    for (const auto& param : TUNING_INT_PARAMS) {
+        if (name == param.name) {
+            tuning.*param.member = std::stoi(value);
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif
@@ -0,0 +1,332 @@
+#include "world.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+
+// Players that might be hit are found through a bitmask per tile column
+static_assert(World::MaxPlayers <= 32, "Column masks hold one bit per player");
+
+// Smallest share of a stage worth handing to another core; below this the
+// wakeup costs more than the work
+static constexpr std::size_t PlayersPerJob = 4;
+static constexpr std::size_t BoomerangsPerJob = 2;
+
+// What a boomerang did during a substep, reported back to the serial merge
+enum FlightResult : std::uint8_t {
+    FlightBounced = 1,
+    FlightCaught = 2
+};
+
+// The most a step() puts in the scratch arena: every substep, a flight
+// result and a hit mask per boomerang (one per player), plus alignment
+static constexpr std::size_t ScratchBytes =
+    PhysicsStep::MaxSubsteps * (World::MaxPlayers * (sizeof(std::uint8_t) + sizeof(std::uint32_t)) + alignof(std::uint32_t));
+
+World::World(const Level& level, const Tuning& tuning)
+    : m_tuning(tuning)
+    , m_step(tuning)
+    , m_tiles(buildTiles(level, nullptr))
+    , m_grid(buildTileGrid(level))
+    , m_navGraph(NavGraph::forLevel(level, tuning))
+    , m_hitMasks(HitMasks::forTuning(tuning))
+    , m_spawns(buildSpawnPoints(level, MaxPlayers))
+    , m_scratch(ScratchBytes)
+    , m_nextPlayerId(0)
+    , m_tick(0)
+    , m_stateHash(0)
+    , m_events(nullptr)
+    , m_jobs(nullptr)
+{
+    m_slots.fill(-1);
+    m_players.reserve(MaxPlayers);
+    m_retired.reserve(MaxPlayers);
+
+    // Sized for the busiest possible tick up front so a match doesn't grow
+    // them as it goes: one boomerang per player, at most every player
+    // killed, and MaxStepEvents
+    m_boomerangs.reserve(MaxPlayers);
+    m_kills.reserve(MaxPlayers);
+    m_stepEvents.reserve(MaxStepEvents);
+}
+
+int World::addPlayer(int controllerId) {
+    if (m_nextPlayerId >= MaxPlayers) return -1;
+    int id = m_nextPlayerId++;
+    const sf::Vector2f& start = m_spawns[id % m_spawns.size()];
+    m_players.emplace_back(start.x, start.y, id, controllerId, m_tuning);
+    indexPlayers();
+    return id;
+}
+
+void World::clear() {
+    m_players.clear();
+    m_retired.clear();
+    m_slots.fill(-1);
+    m_boomerangs.clear();
+    m_kills.clear();
+    m_stepEvents.clear();
+    m_nextPlayerId = 0;
+    m_tick = 0;
+    m_stateHash = 0;
+}
+
+void World::rematch() {
+    for (auto& player : m_retired) {
+        m_players.push_back(std::move(player));
+    }
+    m_retired.clear();
+
+    // Back in join order, as the first match had them
+    std::sort(m_players.begin(), m_players.end(),
+              [](const Player& a, const Player& b) { return a.getId() < b.getId(); });
+    for (auto& player : m_players) {
+        player.respawn(m_spawns[player.getId() % m_spawns.size()]);
+    }
+    indexPlayers();
+
+    m_boomerangs.clear();
+    m_kills.clear();
+    m_stepEvents.clear();
+    m_tick = 0;
+    m_stateHash = 0;
+}
+
+void World::step(const std::vector<PlayerInput>& inputs) {
+    m_stepEvents.clear();
+    m_scratch.reset();
+
+    // --- Gameplay Logic ---
+    for (auto& player : m_players) {
+        int id = player.getId();
+        PlayerInput input = static_cast<std::size_t>(id) < inputs.size() ? inputs[id] : PlayerInput();
+
+        // Handle throw input, then movement
+        player.handleThrowInput(input.throwPressed, input.aim);
+        Player::State stateBefore = player.getState();
+        player.handleInput(input);
+        if (stateBefore != Player::State::Dashing && player.getState() == Player::State::Dashing) {
+            emit(GameEvent::Type::Dash, id, -1, player.getPosition(), player.getFacingDirection());
+        }
+
+        // Each player can only have one boomerang in flight
+        if (player.getReadyToThrow() && !hasBoomerang(id)) {
+            m_boomerangs.emplace_back(player.getPosition(), player.releaseThrow(), id, m_tuning);
+            emit(GameEvent::Type::Throw, id, -1, player.getPosition(), m_boomerangs.back().getVelocity());
+        }
+    }
+
+    // Motion, collision and hits run once per physics substep; input and
+    // timers above and below stay on the 60 Hz tick
+    for (auto& player : m_players) {
+        player.beginTick();
+    }
+    for (int substep = 0; substep < m_step.substeps; ++substep) {
+        stepPhysics();
+    }
+    for (auto& player : m_players) {
+        player.endTick();
+    }
+
+    // Boomerangs go away once caught, or once their owner has left the arena
+    m_boomerangs.erase(
+        std::remove_if(m_boomerangs.begin(), m_boomerangs.end(),
+            [this](const Boomerang& b) {
+                return b.getState() == Boomerang::State::Caught || !findPlayer(b.getOwnerId());
+            }),
+        m_boomerangs.end()
+    );
+
+    // Players whose death animation has finished leave the arena; they are
+    // moved aside rather than destroyed so rematch() can bring them back
+    auto kept = m_players.begin();
+    for (auto it = m_players.begin(); it != m_players.end(); ++it) {
+        if (it->isDeathAnimationComplete()) {
+            m_retired.push_back(std::move(*it));
+        } else {
+            if (kept != it) *kept = std::move(*it);
+            ++kept;
+        }
+    }
+    m_players.erase(kept, m_players.end());
+    indexPlayers();
+
+    ++m_tick;
+    updateStateHash(inputs);
+}
+
+template <typename Body>
+void World::runStage(std::size_t count, std::size_t grain, Body& body) {
+    if (m_jobs && count > grain) {
+        // Wrapped by reference, the body fits in std::function without
+        // allocating whatever it captures
+        m_jobs->parallelFor(count, grain, std::ref(body));
+    } else if (count) {
+        body(0, count);
+    }
+}
+
+void World::stepPhysics() {
+    // Each stage below only writes to its own entity or its own result slot,
+    // so its chunks can run on any core in any order. Events and kills are
+    // then applied on this thread in entity order, as a serial loop would.
+
+    // Players move through the tiles independently of each other
+    auto movePlayers = [this](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            m_players[i].substep(m_grid, m_step);
+        }
+    };
+    runStage(m_players.size(), PlayersPerJob, movePlayers);
+
+    // Boomerangs fly back towards their owners' new positions
+    std::uint8_t* flightResults = m_scratch.allocateArray<std::uint8_t>(m_boomerangs.size());
+    auto flyBoomerangs = [this, flightResults](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            Boomerang& boomerang = m_boomerangs[i];
+            // A boomerang caught in an earlier substep waits for removal
+            const Player* owner = findPlayer(boomerang.getOwnerId());
+            if (!owner || boomerang.getState() == Boomerang::State::Caught) continue;
+
+            if (boomerang.update(owner->getPosition(), m_tiles, m_step)) flightResults[i] |= FlightBounced;
+            if (boomerang.getState() == Boomerang::State::Caught) flightResults[i] |= FlightCaught;
+        }
+    };
+    runStage(m_boomerangs.size(), BoomerangsPerJob, flyBoomerangs);
+    for (std::size_t i = 0; i < m_boomerangs.size(); ++i) {
+        const Boomerang& boomerang = m_boomerangs[i];
+        if (flightResults[i] & FlightBounced) {
+            emit(GameEvent::Type::Bounce, boomerang.getOwnerId(), -1, boomerang.getPosition(), boomerang.getVelocity());
+        }
+        if (flightResults[i] & FlightCaught) {
+            emit(GameEvent::Type::Catch, boomerang.getOwnerId(), -1, boomerang.getPosition(), {0.f, 0.f});
+        }
+    }
+
+    // Only players in the tile columns a boomerang overlaps can be hit
+    std::array<std::uint32_t, ARENA_COLUMNS> columnPlayers{};
+    for (int i = 0; i < static_cast<int>(m_players.size()); ++i) {
+        if (!m_players[i].isAlive()) continue;
+        sf::FloatRect bounds = m_players[i].getBounds();
+        int first = std::clamp(static_cast<int>(bounds.position.x / TILE_SIZE), 0, ARENA_COLUMNS - 1);
+        int last = std::clamp(static_cast<int>((bounds.position.x + bounds.size.x) / TILE_SIZE), 0, ARENA_COLUMNS - 1);
+        for (int column = first; column <= last; ++column) {
+            columnPlayers[column] |= 1u << i;
+        }
+    }
+
+    // Every boomerang finds the players it touches: boxes first, then the
+    // sprites' pixel masks where they overlap
+    std::uint32_t* hitPlayers = m_scratch.allocateArray<std::uint32_t>(m_boomerangs.size());
+    auto findHits = [this, &columnPlayers, hitPlayers](std::size_t begin, std::size_t end) {
+        for (std::size_t b = begin; b < end; ++b) {
+            const Boomerang& boomerang = m_boomerangs[b];
+            sf::FloatRect boomBounds = boomerang.getBounds();
+            int first = std::clamp(static_cast<int>(boomBounds.position.x / TILE_SIZE), 0, ARENA_COLUMNS - 1);
+            int last = std::clamp(static_cast<int>((boomBounds.position.x + boomBounds.size.x) / TILE_SIZE), 0,
+                                  ARENA_COLUMNS - 1);
+            std::uint32_t candidates = 0;
+            for (int column = first; column <= last; ++column) {
+                candidates |= columnPlayers[column];
+            }
+
+            std::uint32_t hits = 0;
+            for (int i = 0; candidates; ++i, candidates >>= 1) {
+                if (!(candidates & 1u)) continue;
+                const Player& player = m_players[i];
+                if (boomBounds.findIntersection(player.getBounds()) && boomerang.getOwnerId() != player.getId() &&
+                    m_hitMasks->hits(player, boomerang)) {
+                    hits |= 1u << i;
+                }
+            }
+            hitPlayers[b] = hits;
+        }
+    };
+    runStage(m_boomerangs.size(), BoomerangsPerJob, findHits);
+
+    // Kills land in boomerang order, then player order. A player two
+    // boomerangs touch is killed by the first only.
+    for (std::size_t b = 0; b < m_boomerangs.size(); ++b) {
+        const Boomerang& boomerang = m_boomerangs[b];
+        std::uint32_t hits = hitPlayers[b];
+        for (int i = 0; hits; ++i, hits >>= 1) {
+            if (!(hits & 1u)) continue;
+            Player& player = m_players[i];
+            if (!player.isAlive()) continue;
+            player.kill();
+            m_kills.push_back({m_tick, boomerang.getOwnerId(), player.getId(), boomerang.getState(), player.getPosition()});
+            emit(GameEvent::Type::Kill, boomerang.getOwnerId(), player.getId(), player.getPosition(),
+                 boomerang.getVelocity(), static_cast<std::uint8_t>(boomerang.getState()));
+        }
+    }
+}
+
+void World::updateStateHash(const std::vector<PlayerInput>& inputs) {
+    StateHash hash(m_stateHash);
+    visitState(hash);
+
+    // Every id handed out so far, with the neutral input step() used for
+    // ids inputs had no entry for
+    for (int id = 0; id < m_nextPlayerId; ++id) {
+        visitInput(static_cast<std::size_t>(id) < inputs.size() ? inputs[id] : PlayerInput(), hash);
+    }
+    for (const auto& player : m_players) {
+        player.visitState(hash);
+    }
+    for (const auto& boomerang : m_boomerangs) {
+        boomerang.visitState(hash);
+    }
+    for (const auto& event : m_stepEvents) {
+        visitEvent(event, hash);
+    }
+    m_stateHash = hash.finish();
+}
+
+void World::setEventBus(EventBus* events) { m_events = events; }
+void World::setJobPool(ThreadPool* jobs) { m_jobs = jobs; }
+
+void World::emit(GameEvent::Type type, int actorId, int targetId, sf::Vector2f position, sf::Vector2f vector,
+                 std::uint8_t cause) {
+    m_stepEvents.push_back({type, cause, m_tick, actorId, targetId, position, vector});
+    if (m_events) m_events->publish(m_stepEvents.back());
+}
+
+const std::vector<Player>& World::getPlayers() const { return m_players; }
+const std::vector<Boomerang>& World::getBoomerangs() const { return m_boomerangs; }
+const std::vector<sf::RectangleShape>& World::getTiles() const { return m_tiles; }
+const TileGrid& World::getGrid() const { return m_grid; }
+const NavGraph& World::getNavGraph() const { return *m_navGraph; }
+const HitMasks& World::getHitMasks() const { return *m_hitMasks; }
+const std::vector<KillRecord>& World::getKills() const { return m_kills; }
+const std::vector<GameEvent>& World::getStepEvents() const { return m_stepEvents; }
+const std::vector<sf::Vector2f>& World::getSpawnPoints() const { return m_spawns; }
+const Tuning& World::getTuning() const { return m_tuning; }
+int World::getTick() const { return m_tick; }
+std::uint64_t World::getStateHash() const { return m_stateHash; }
+
+const Player* World::findPlayer(int id) const {
+    if (id < 0 || id >= MaxPlayers || m_slots[id] < 0) return nullptr;
+    return &m_players[m_slots[id]];
+}
+
+void World::indexPlayers() {
+    m_slots.fill(-1);
+    for (int i = 0; i < static_cast<int>(m_players.size()); ++i) {
+        m_slots[m_players[i].getId()] = i;
+    }
+}
+
+bool World::hasBoomerang(int ownerId) const {
+    for (const auto& boomerang : m_boomerangs) {
+        if (boomerang.getOwnerId() == ownerId) return true;
+    }
+    return false;
+}
+
+int World::getAliveCount() const {
+    int alive = 0;
+    for (const auto& player : m_players) {
+        if (player.isAlive()) ++alive;
+    }
+    return alive;
+}
@@ -0,0 +1,148 @@
+#ifndef WORLD_HPP
+#define WORLD_HPP
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "player.hpp"
+#include "boomerang.hpp"
+#include "level.hpp"
+#include "tuning.hpp"
+#include "input.hpp"
+#include "event_bus.hpp"
+#include "nav_graph.hpp"
+#include "collision_mask.hpp"
+#include "player_slots.hpp"
+#include "frame_arena.hpp"
+#include "state_hash.hpp"
+
+class ThreadPool;
+
+// A kill as seen by the simulation, used for end-of-match stats
+struct KillRecord {
+    int tick;
+    int killerId;
+    int victimId;
+    Boomerang::State cause;   // What the boomerang was doing when it connected
+    sf::Vector2f position;
+};
+
+// Everything that takes part in a match: the tiles, the players and the
+// boomerangs in flight. The window runner and the headless batch runner both
+// drive the game through step(), so they play by exactly the same rules.
+class World {
+public:
+    static constexpr int MaxPlayers = MAX_PLAYERS;
+    // Most events one step() can emit: a dash and a throw per player, a
+    // bounce every substep and a catch per boomerang, and every player killed
+    static constexpr int MaxStepEvents = MaxPlayers * (2 + PhysicsStep::MaxSubsteps + 1 + 1);
+
+    explicit World(const Level& level, const Tuning& tuning = Tuning());
+
+    // Adds a player at the next of the level's spawn points and returns its
+    // id, or -1 when every slot is taken
+    int addPlayer(int controllerId);
+
+    // Removes every player and boomerang (back to the join screen)
+    void clear();
+
+    // Starts another match with the same players: everyone is back at their
+    // spawn point and alive, and the boomerangs, kills and tick count are
+    // cleared. Players removed after dying were kept aside and are revived
+    // in place, so a rematch allocates nothing.
+    void rematch();
+
+    // Advances the match by one 60 Hz tick. inputs is indexed by player id;
+    // players without an entry get a neutral input. Physics runs
+    // tuning.physicsSubsteps times within the tick.
+    void step(const std::vector<PlayerInput>& inputs);
+
+    // Throws, bounces, catches, kills and dashes are published here as they
+    // happen. Optional; the bus must outlive the world.
+    void setEventBus(EventBus* events);
+
+    // Runs the independent parts of each physics substep (player motion,
+    // boomerang flight and hit tests) on pool's workers. Their results are
+    // merged in the same order as a serial step, so a match plays out
+    // identically with or without a pool. Optional; the pool must outlive
+    // the world.
+    void setJobPool(ThreadPool* jobs);
+
+    const std::vector<Player>& getPlayers() const;
+    const std::vector<Boomerang>& getBoomerangs() const;
+    const std::vector<sf::RectangleShape>& getTiles() const;
+    const TileGrid& getGrid() const;
+    const NavGraph& getNavGraph() const;    // Built once per level and tuning, for bots
+    const HitMasks& getHitMasks() const;    // Sprite shapes that decide kills
+    const std::vector<KillRecord>& getKills() const;
+
+    // Everything emitted during the last step(), in order, whether or not an
+    // event bus is attached. For consumers on the simulation thread.
+    const std::vector<GameEvent>& getStepEvents() const;
+    const std::vector<sf::Vector2f>& getSpawnPoints() const;
+    const Tuning& getTuning() const;
+    const Player* findPlayer(int id) const;    // Constant time; nullptr once the player is gone
+    bool hasBoomerang(int ownerId) const;
+    int getAliveCount() const;
+    int getTick() const;
+
+    // Hash of the whole simulation, updated at the end of every step(): the
+    // inputs the tick was given, every player and boomerang and the events
+    // it emitted, chained onto the previous tick's hash. Two worlds fed the
+    // same inputs agree on it every tick, so the first tick they don't is
+    // where a match stopped being deterministic (see desync.cpp). 0 until
+    // the first step of a match.
+    std::uint64_t getStateHash() const;
+
+    // The world's own fields in the hash; players and boomerangs have their
+    // own visitState()
+    template <typename Visitor>
+    void visitState(Visitor& visit) const {
+        visit("tick", m_tick);
+        visit("nextPlayerId", m_nextPlayerId);
+        visit("players", static_cast<std::int32_t>(m_players.size()));
+        visit("retired", static_cast<std::int32_t>(m_retired.size()));
+        visit("boomerangs", static_cast<std::int32_t>(m_boomerangs.size()));
+        visit("kills", static_cast<std::int32_t>(m_kills.size()));
+        visit("events", static_cast<std::int32_t>(m_stepEvents.size()));
+    }
+
+private:
+    // Moves players and boomerangs by one substep and checks for hits
+    void stepPhysics();
+    // Re-points m_slots after m_players is added to or erased from
+    void indexPlayers();
+    // Folds the tick just stepped into m_stateHash
+    void updateStateHash(const std::vector<PlayerInput>& inputs);
+    // Calls body(begin, end) over [0, count) in chunks of grain, on the job
+    // pool if there is one and the work spans more than one chunk
+    template <typename Body>
+    void runStage(std::size_t count, std::size_t grain, Body& body);
+    void emit(GameEvent::Type type, int actorId, int targetId, sf::Vector2f position, sf::Vector2f vector,
+              std::uint8_t cause = 0);
+
+    Tuning m_tuning;
+    PhysicsStep m_step;
+    std::vector<sf::RectangleShape> m_tiles;
+    TileGrid m_grid;
+    std::shared_ptr<const NavGraph> m_navGraph;
+    std::shared_ptr<const HitMasks> m_hitMasks;
+    std::vector<sf::Vector2f> m_spawns;
+
+    std::vector<Player> m_players;
+    std::vector<Player> m_retired;          // Removed after dying, kept for rematch()
+    std::array<int, MaxPlayers> m_slots;    // Index in m_players by player id, -1 when absent
+    std::vector<Boomerang> m_boomerangs;
+    std::vector<KillRecord> m_kills;
+    std::vector<GameEvent> m_stepEvents;
+    FrameArena m_scratch;                   // Per-substep stage results, emptied every step()
+    int m_nextPlayerId;
+    int m_tick;
+    std::uint64_t m_stateHash;
+    EventBus* m_events;
+    ThreadPool* m_jobs;
+};
+
+#endif